@@ -0,0 +1,83 @@
+/**
+ * Request signing benchmark for the Kiosk SDK
+ *
+ * Measures signatures per second on one core for the documented request
+ * signature (method + path + timestamp + nonce + body), comparing a
+ * per-request HMAC that rehashes the key and concatenates the payload with
+ * the precomputed key state used by SecurityModule.
+ *
+ * Build:
+ *   g++ -O2 -std=c++14 -I../../sdk/kiosk signature_benchmark.cpp ../../sdk/kiosk/sha256.cpp -o signature_benchmark
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "sha256.h"
+
+using namespace AsianCryptoPay;
+
+namespace {
+
+const std::string kSecret = "demo_api_key_0123456789abcdef";
+const std::string kMethod = "POST";
+const std::string kPath = "/payments";
+const std::string kTimestamp = "1742660123456";
+const std::string kNonce = "6f1c2e9a4b7d30c85e12a9f0d4b6c371";
+
+volatile unsigned char g_sink;
+
+void signPerRequest(const std::string& body, unsigned char mac[HmacSha256::MacSize]) {
+    // What a generic HMAC helper does: new key pads and a joined payload every call
+    std::string payload = kMethod + kPath + kTimestamp + kNonce + body;
+    HmacSha256Key key(kSecret.data(), kSecret.size());
+    HmacSha256 hmac(key);
+    hmac.update(payload.data(), payload.size());
+    hmac.finish(mac);
+}
+
+void signPrecomputed(const HmacSha256Key& key, const std::string& body, unsigned char mac[HmacSha256::MacSize]) {
+    HmacSha256 hmac(key);
+    hmac.update(kMethod.data(), kMethod.size());
+    hmac.update(kPath.data(), kPath.size());
+    hmac.update(kTimestamp.data(), kTimestamp.size());
+    hmac.update(kNonce.data(), kNonce.size());
+    hmac.update(body.data(), body.size());
+    hmac.finish(mac);
+}
+
+template <typename Sign>
+double measure(int iterations, Sign sign) {
+    unsigned char mac[HmacSha256::MacSize];
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        sign(mac);
+        g_sink = mac[0];
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return iterations / elapsed.count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 200000;
+    const int bodySizes[] = { 0, 256, 1024 };
+    
+    HmacSha256Key key(kSecret.data(), kSecret.size());
+    
+    std::printf("%-10s %18s %18s %8s\n", "body", "per-request/s", "precomputed/s", "speedup");
+    
+    for (int size : bodySizes) {
+        std::string body(size, 'x');
+        
+        double perRequest = measure(iterations, [&](unsigned char* mac) { signPerRequest(body, mac); });
+        double precomputed = measure(iterations, [&](unsigned char* mac) { signPrecomputed(key, body, mac); });
+        
+        std::printf("%-10d %18.0f %18.0f %7.2fx\n", size, perRequest, precomputed, precomputed / perRequest);
+    }
+    
+    return 0;
+}
@@ -0,0 +1,204 @@
+/**
+ * Webhook load generator for the Kiosk SDK embedded receiver
+ *
+ * Opens keep-alive connections to a WebhookReceiver on loopback and sends
+ * signed payment.completed deliveries, optionally pipelined, then reports
+ * throughput, 202/503 counts and request latency percentiles. Receiver
+ * side counters are available from WebhookReceiver::stats().
+ *
+ * Receiver setup in the application under test:
+ *   sdk.setWebhookConfig(url, "secret");
+ *   WebhookReceiver receiver(&sdk);
+ *   receiver.listen("127.0.0.1", 8080);
+ *
+ * Build:
+ *   g++ -O2 -std=c++14 -pthread -I../../sdk/kiosk webhook_load_generator.cpp ../../sdk/kiosk/sha256.cpp ../../sdk/kiosk/hex_codec.cpp -o webhook_load_generator
+ *
+ * Usage:
+ *   webhook_load_generator <port> <webhook-secret> [connections] [requests-per-connection] [pipeline-depth]
+ */
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "hex_codec.h"
+#include "sha256.h"
+
+using namespace AsianCryptoPay;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct WorkerResult {
+    long long accepted = 0;
+    long long busy = 0;
+    long long failed = 0;
+    std::vector<double> latenciesUs;
+};
+
+std::string isoNow() {
+    char buffer[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    return buffer;
+}
+
+std::string signedRequest(const HmacSha256Key& key, int connection, int index) {
+    std::string body = "{\"event\":\"payment.completed\",\"timestamp\":\"" + isoNow() + "\",\"data\":{"
+            "\"id\":\"pay_load_" + std::to_string(connection) + "_" + std::to_string(index) + "\","
+            "\"merchant_id\":\"load_merchant\",\"amount\":\"100.00000000\",\"currency\":\"SGD\","
+            "\"crypto_amount\":\"0.00234567\",\"crypto_currency\":\"BTC\",\"status\":\"completed\"}}";
+    
+    unsigned char mac[HmacSha256::MacSize];
+    HmacSha256 hmac(key);
+    hmac.update(body.data(), body.size());
+    hmac.finish(mac);
+    char signature[2 * HmacSha256::MacSize];
+    HexCodec::encode(mac, sizeof(mac), signature);
+    
+    return "POST /webhook HTTP/1.1\r\nHost: 127.0.0.1\r\nContent-Type: application/json\r\n"
+           "X-Webhook-Signature: " + std::string(signature, sizeof(signature)) + "\r\n"
+           "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+}
+
+// Counts complete responses in buffer, returns bytes consumed
+std::size_t parseResponses(const std::string& buffer, WorkerResult& result, int& completed) {
+    std::size_t offset = 0;
+    for (;;) {
+        std::size_t end = buffer.find("\r\n\r\n", offset);
+        if (end == std::string::npos) {
+            return offset;
+        }
+        if (buffer.compare(offset, 12, "HTTP/1.1 202") == 0) {
+            ++result.accepted;
+        } else if (buffer.compare(offset, 12, "HTTP/1.1 503") == 0) {
+            ++result.busy;
+        } else {
+            ++result.failed;
+        }
+        ++completed;
+        offset = end + 4;
+    }
+}
+
+void runConnection(int port, const HmacSha256Key& key, int connection, int requests, int depth, WorkerResult& result) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        std::perror("connect");
+        result.failed += requests;
+        ::close(fd);
+        return;
+    }
+    int enable = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+    
+    std::string pending;
+    char chunk[16384];
+    for (int sent = 0; sent < requests; ) {
+        int batch = std::min(depth, requests - sent);
+        std::string out;
+        for (int i = 0; i < batch; ++i) {
+            out += signedRequest(key, connection, sent + i);
+        }
+        
+        Clock::time_point start = Clock::now();
+        if (::send(fd, out.data(), out.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(out.size())) {
+            result.failed += requests - sent;
+            break;
+        }
+        
+        int completed = 0;
+        while (completed < batch) {
+            ssize_t received = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (received <= 0) {
+                result.failed += batch - completed;
+                ::close(fd);
+                return;
+            }
+            pending.append(chunk, received);
+            pending.erase(0, parseResponses(pending, result, completed));
+        }
+        
+        double elapsedUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        for (int i = 0; i < batch; ++i) {
+            result.latenciesUs.push_back(elapsedUs);
+        }
+        sent += batch;
+    }
+    
+    ::close(fd);
+}
+
+double percentile(std::vector<double>& values, double p) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::size_t index = std::min(values.size() - 1, static_cast<std::size_t>(p * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: %s <port> <webhook-secret> [connections] [requests-per-connection] [pipeline-depth]\n", argv[0]);
+        return 1;
+    }
+    
+    int port = std::atoi(argv[1]);
+    std::string secret = argv[2];
+    int connections = argc > 3 ? std::atoi(argv[3]) : 8;
+    int requests = argc > 4 ? std::atoi(argv[4]) : 10000;
+    int depth = argc > 5 ? std::max(1, std::atoi(argv[5])) : 1;
+    
+    HmacSha256Key key(secret.data(), secret.size());
+    std::vector<WorkerResult> results(connections);
+    std::vector<std::thread> workers;
+    
+    Clock::time_point start = Clock::now();
+    for (int c = 0; c < connections; ++c) {
+        workers.emplace_back(runConnection, port, std::cref(key), c, requests, depth, std::ref(results[c]));
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    
+    WorkerResult total;
+    for (WorkerResult& result : results) {
+        total.accepted += result.accepted;
+        total.busy += result.busy;
+        total.failed += result.failed;
+        total.latenciesUs.insert(total.latenciesUs.end(), result.latenciesUs.begin(), result.latenciesUs.end());
+    }
+    
+    long long completed = total.accepted + total.busy;
+    std::printf("connections %d, depth %d, %.2f s\n", connections, depth, seconds);
+    std::printf("requests/s %.0f  accepted %lld  busy(503) %lld  failed %lld\n",
+                completed / seconds, total.accepted, total.busy, total.failed);
+    std::printf("latency us  p50 %.0f  p99 %.0f  max %.0f\n",
+                percentile(total.latenciesUs, 0.50), percentile(total.latenciesUs, 0.99),
+                percentile(total.latenciesUs, 1.0));
+    
+    return total.failed == 0 ? 0 : 2;
+}
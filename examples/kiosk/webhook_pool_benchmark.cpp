@@ -0,0 +1,181 @@
+/**
+ * Webhook worker pool benchmark for the Kiosk SDK
+ *
+ * Pushes signed webhook bodies through a ShardedWorkerPool the way
+ * AsianCryptoPayment::setWebhookWorkerThreads() does: the submitting thread
+ * hands deliveries out round robin, workers verify the HMAC and scan the
+ * payment object, and the submitting thread drains the results, keeping
+ * each payment's newest sequence number like the SDK's WebhookSequencer.
+ * Reports events/sec and out-of-order results per thread count, and checks
+ * that every payment ends at its last event.
+ *
+ * Build:
+ *   g++ -O2 -std=c++14 -pthread -I../../sdk/kiosk webhook_pool_benchmark.cpp ../../sdk/kiosk/sha256.cpp ../../sdk/kiosk/hex_codec.cpp -o webhook_pool_benchmark
+ *
+ * Usage:
+ *   webhook_pool_benchmark [events] [payments] [max-threads]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "hex_codec.h"
+#include "json_scanner.h"
+#include "sha256.h"
+#include "sharded_worker_pool.h"
+
+using namespace AsianCryptoPay;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct Delivery {
+    std::string body;
+    std::string signature;
+};
+
+struct Outcome {
+    bool verified = false;
+    int payment = -1;
+    int sequence = -1;
+};
+
+Delivery signedDelivery(const HmacSha256Key& key, int payment, int sequence) {
+    Delivery delivery;
+    delivery.body = "{\"event\":\"payment.updated\",\"timestamp\":\"2026-01-01T00:00:00Z\",\"data\":{"
+            "\"id\":\"pay_" + std::to_string(payment) + "\",\"merchant_id\":\"bench_merchant\","
+            "\"amount\":\"100.00000000\",\"currency\":\"SGD\",\"crypto_amount\":\"0.00234567\","
+            "\"crypto_currency\":\"BTC\",\"status\":\"pending\",\"metadata\":{\"seq\":\"" + std::to_string(sequence) + "\"}}}";
+    
+    unsigned char mac[HmacSha256::MacSize];
+    HmacSha256 hmac(key);
+    hmac.update(delivery.body.data(), delivery.body.size());
+    hmac.finish(mac);
+    char signature[2 * HmacSha256::MacSize];
+    HexCodec::encode(mac, sizeof(mac), signature);
+    delivery.signature.assign(signature, sizeof(signature));
+    return delivery;
+}
+
+// Worker side: authenticate, then pull id and metadata.seq out of the payment
+void handle(const HmacSha256Key& key, Delivery& delivery, Outcome& outcome) {
+    unsigned char expected[HmacSha256::MacSize];
+    unsigned char received[HmacSha256::MacSize];
+    HmacSha256 hmac(key);
+    hmac.update(delivery.body.data(), delivery.body.size());
+    hmac.finish(expected);
+    outcome.verified = delivery.signature.size() == 2 * HmacSha256::MacSize
+            && HexCodec::decode(delivery.signature.data(), delivery.signature.size(), received)
+            && HexCodec::constantTimeEquals(expected, received, sizeof(expected));
+    if (!outcome.verified) {
+        return;
+    }
+    
+    const std::string& body = delivery.body;
+    JsonScanner scanner(body.data(), static_cast<int>(body.size()));
+    int pos = 0;
+    scanner.forEachMember(pos, [&](const char* key, int length, const JsonSpan& value) {
+        if (!JsonScanner::keyEquals(key, length, "data")) {
+            return true;
+        }
+        int dataPos = value.begin;
+        scanner.forEachMember(dataPos, [&](const char* field, int fieldLength, const JsonSpan& fieldValue) {
+            if (JsonScanner::keyEquals(field, fieldLength, "id")) {
+                outcome.payment = std::atoi(body.c_str() + fieldValue.begin + 5);
+            } else if (JsonScanner::keyEquals(field, fieldLength, "metadata")) {
+                int metaPos = fieldValue.begin;
+                scanner.forEachMember(metaPos, [&](const char*, int, const JsonSpan& seq) {
+                    outcome.sequence = std::atoi(body.c_str() + seq.begin + 1);
+                    return false;
+                });
+            }
+            return true;
+        });
+        return false;
+    });
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int events = argc > 1 ? std::atoi(argv[1]) : 200000;
+    int payments = argc > 2 ? std::atoi(argv[2]) : 1000;
+    int maxThreads = argc > 3 ? std::atoi(argv[3]) : static_cast<int>(std::thread::hardware_concurrency());
+    if (events < 1 || payments < 1) {
+        std::fprintf(stderr, "usage: %s [events] [payments] [max-threads]\n", argv[0]);
+        return 1;
+    }
+    if (maxThreads < 1) {
+        maxThreads = 1;
+    }
+    
+    const char secret[] = "benchmark-webhook-secret";
+    HmacSha256Key key(secret, sizeof(secret) - 1);
+    
+    std::vector<Delivery> deliveries;
+    deliveries.reserve(events);
+    for (int i = 0; i < events; ++i) {
+        deliveries.push_back(signedDelivery(key, i % payments, i / payments));
+    }
+    
+    std::printf("%d events over %d payments, SHA-256: %s\n\n", events, payments, Sha256::implementation());
+    std::printf("%8s %14s %10s %10s\n", "threads", "events/sec", "speedup", "reordered");
+    
+    double baseline = 0;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        ShardedWorkerPool<Delivery, Outcome> pool(threads, 1024, [&key](Delivery& delivery, Outcome& outcome) {
+            handle(key, delivery, outcome);
+        });
+        
+        std::vector<Delivery> input = deliveries;
+        std::vector<int> lastSequence(payments, -1);
+        int completed = 0;
+        int verified = 0;
+        int reordered = 0;
+        auto consume = [&](Outcome& outcome) {
+            ++completed;
+            if (!outcome.verified || outcome.payment < 0 || outcome.payment >= payments) {
+                return;
+            }
+            ++verified;
+            // Dropped as stale by the sequencer
+            if (outcome.sequence <= lastSequence[outcome.payment]) {
+                ++reordered;
+                return;
+            }
+            lastSequence[outcome.payment] = outcome.sequence;
+        };
+        
+        Clock::time_point start = Clock::now();
+        std::size_t next = 0;
+        while (completed < events) {
+            while (next < input.size() && pool.submit(next, std::move(input[next]))) {
+                ++next;
+            }
+            if (pool.drain(consume) == 0) {
+                std::this_thread::yield();
+            }
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        
+        double rate = events / seconds;
+        if (threads == 1) {
+            baseline = rate;
+        }
+        bool converged = true;
+        for (int payment = 0; payment < payments && payment < events; ++payment) {
+            if (lastSequence[payment] != (events - 1 - payment) / payments) {
+                converged = false;
+            }
+        }
+        std::printf("%8d %14.0f %9.2fx %10d%s%s\n", threads, rate, rate / baseline, reordered,
+                    verified == events ? "" : "  VERIFY FAILED", converged ? "" : "  STALE STATE");
+    }
+    
+    return 0;
+}
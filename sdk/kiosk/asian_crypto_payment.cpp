@@ -8,170 +8,2236 @@
 
 #include "asian_crypto_payment.h"
 
+#include <QMetaMethod>
+#include <QDir>
+#include <QFileInfo>
+#include <algorithm>
+#include <cmath>
+
 namespace AsianCryptoPay {
 
-AsianCryptoPayment::AsianCryptoPayment(const QString& apiKey, const QString& merchantId, CountryCode countryCode, QObject* parent)
-    : QObject(parent)
-    , m_apiKey(apiKey)
-    , m_merchantId(merchantId)
-    , m_countryCode(countryCode)
-    , m_networkManager(new QNetworkAccessManager(this))
-    , m_countryModule(createCountryModule(countryCode))
-    , m_securityModule(std::make_unique<SecurityModule>(apiKey))
-{
-    // Default supported cryptocurrencies
-    m_supportedCryptocurrencies << "BTC" << "ETH" << "USDT" << "USDC" << "BNB";
+namespace {
+
+// JSON member names of LazyPayment::Field, in enum order
+const char* const kLazyPaymentFieldNames[LazyPayment::FieldCount] = {
+    "id",
+    "merchant_id",
+    "amount",
+    "currency",
+    "crypto_amount",
+    "crypto_currency",
+    "description",
+    "order_id",
+    "customer_email",
+    "customer_name",
+    "address",
+    "qr_code_url",
+    "status",
+    "created_at",
+    "updated_at",
+    "expires_at",
+    "metadata"
+};
+
+int lazyPaymentFieldIndex(const char* key, int length) {
+    for (int i = 0; i < LazyPayment::FieldCount; ++i) {
+        if (JsonScanner::keyEquals(key, length, kLazyPaymentFieldNames[i])) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+qint64 ledgerTime(const QDateTime& time) {
+    return time.isValid() ? time.toMSecsSinceEpoch() : 0;
+}
+
+// Indexed fields of a Payment or LazyPayment
+template<typename P>
+PaymentLedger::Record ledgerRecord(const P& payment) {
+    PaymentLedger::Record record;
+    record.id = payment.id().toStdString();
+    record.createdAtMs = ledgerTime(payment.createdAt());
+    record.updatedAtMs = ledgerTime(payment.updatedAt());
+    record.status = static_cast<int>(payment.status());
+    record.currency = payment.currency().toStdString();
+    record.cryptoCurrency = payment.cryptoCurrency().toStdString();
+    return record;
+}
+
+// Currency code as RateTable stores it, copied without allocating
+bool rateTableCode(const QString& code, char (&buffer)[RateTable::MaxCodeLength + 1]) {
+    if (code.isEmpty() || code.size() > static_cast<int>(RateTable::MaxCodeLength)) {
+        return false;
+    }
+    for (int i = 0; i < code.size(); ++i) {
+        ushort c = code.at(i).unicode();
+        if (c == 0 || c > 0xff) {
+            return false;
+        }
+        buffer[i] = static_cast<char>(c);
+    }
+    buffer[code.size()] = '\0';
+    return true;
+}
+
+} // namespace
+
+LazyPayment LazyPayment::fromBuffer(const QByteArray& buffer, const JsonSpan& span) {
+    LazyPayment payment;
+    payment.m_buffer = buffer;
+    
+    JsonScanner scanner(buffer.constData(), span.isValid() ? span.end : buffer.size());
+    int pos = span.isValid() ? span.begin : 0;
+    scanner.skipWhitespace(pos);
+    int begin = pos;
+    
+    bool ok = scanner.forEachMember(pos, [&payment](const char* key, int length, const JsonSpan& value) {
+        int field = lazyPaymentFieldIndex(key, length);
+        if (field >= 0) {
+            payment.m_spans[field] = value;
+        }
+        return true;
+    });
+    
+    if (ok) {
+        payment.m_object.begin = begin;
+        payment.m_object.end = pos;
+        payment.m_valid = true;
+    }
+    
+    return payment;
+}
+
+bool LazyPayment::indexPage(const QByteArray& buffer, QList<LazyPayment>& payments, int& total) {
+    JsonScanner scanner(buffer.constData(), buffer.size());
+    int pos = 0;
+    bool valid = true;
+    total = 0;
+    
+    bool ok = scanner.forEachMember(pos, [&](const char* key, int length, const JsonSpan& value) {
+        if (JsonScanner::keyEquals(key, length, "total")) {
+            total = QByteArray::fromRawData(buffer.constData() + value.begin, value.length()).toInt();
+        } else if (JsonScanner::keyEquals(key, length, "payments")) {
+            int arrayPos = value.begin;
+            valid = scanner.forEachElement(arrayPos, [&](const JsonSpan& element) {
+                if (buffer.at(element.begin) == '{') {
+                    LazyPayment payment = fromBuffer(buffer, element);
+                    if (!payment.isValid()) {
+                        return false;
+                    }
+                    payments.append(payment);
+                }
+                return true;
+            });
+        }
+        return valid;
+    });
+    
+    return ok && valid;
+}
+
+QVariant PaymentDelta::value(LazyPayment::Field field) const {
+    if (!contains(field)) {
+        return QVariant();
+    }
+    // Values are stored in field order, so the index is the number of lower bits set
+    quint32 lower = m_fields & ((1u << field) - 1);
+    int index = 0;
+    for (; lower; lower &= lower - 1) {
+        ++index;
+    }
+    return m_values.at(index);
+}
+
+PaymentDelta PaymentDelta::diff(const Payment& before, const Payment& after) {
+    PaymentDelta delta;
+    delta.m_paymentId = after.id();
+    
+    auto compare = [&delta](LazyPayment::Field field, const QVariant& oldValue, const QVariant& newValue) {
+        if (oldValue != newValue) {
+            delta.m_fields |= 1u << field;
+            delta.m_values.append(newValue);
+        }
+    };
+    
+    compare(LazyPayment::IdField, before.id(), after.id());
+    compare(LazyPayment::MerchantIdField, before.merchantId(), after.merchantId());
+    compare(LazyPayment::AmountField, before.amount(), after.amount());
+    compare(LazyPayment::CurrencyField, before.currency(), after.currency());
+    compare(LazyPayment::CryptoAmountField, before.cryptoAmount(), after.cryptoAmount());
+    compare(LazyPayment::CryptoCurrencyField, before.cryptoCurrency(), after.cryptoCurrency());
+    compare(LazyPayment::DescriptionField, before.description(), after.description());
+    compare(LazyPayment::OrderIdField, before.orderId(), after.orderId());
+    compare(LazyPayment::CustomerEmailField, before.customerEmail(), after.customerEmail());
+    compare(LazyPayment::CustomerNameField, before.customerName(), after.customerName());
+    compare(LazyPayment::AddressField, before.address(), after.address());
+    compare(LazyPayment::QrCodeUrlField, before.qrCodeUrl(), after.qrCodeUrl());
+    compare(LazyPayment::StatusField, before.statusString(), after.statusString());
+    compare(LazyPayment::CreatedAtField, before.createdAt(), after.createdAt());
+    compare(LazyPayment::UpdatedAtField, before.updatedAt(), after.updatedAt());
+    compare(LazyPayment::ExpiresAtField, before.expiresAt(), after.expiresAt());
+    compare(LazyPayment::MetadataField, before.metadata(), after.metadata());
+    return delta;
+}
+
+PaymentStatus LazyPayment::status() const {
+    if (!isDecoded(StatusField)) {
+        const JsonSpan& span = m_spans[StatusField];
+        PaymentStatus status = PaymentStatus::Created;
+        
+        // Compare the raw bytes; status values never contain escapes
+        if (span.length() >= 2 && m_buffer.at(span.begin) == '"') {
+            const char* data = m_buffer.constData() + span.begin + 1;
+            int length = span.length() - 2;
+            
+            if (JsonScanner::keyEquals(data, length, "pending")) {
+                status = PaymentStatus::Pending;
+            } else if (JsonScanner::keyEquals(data, length, "completed")) {
+                status = PaymentStatus::Completed;
+            } else if (JsonScanner::keyEquals(data, length, "cancelled")) {
+                status = PaymentStatus::Cancelled;
+            } else if (JsonScanner::keyEquals(data, length, "expired")) {
+                status = PaymentStatus::Expired;
+            }
+        }
+        
+        m_status = status;
+        markDecoded(StatusField);
+    }
+    
+    return m_status;
+}
+
+const PaymentMetadata& LazyPayment::compactMetadata() const {
+    if (!isDecoded(MetadataField)) {
+        const JsonSpan& span = m_spans[MetadataField];
+        
+        // Entries are copied as raw JSON bytes; nothing is unescaped here
+        if (span.isValid() && m_buffer.at(span.begin) == '{') {
+            m_metadata = PaymentMetadata::fromJson(m_buffer.constData(), span);
+        }
+        
+        markDecoded(MetadataField);
+    }
+    
+    return m_metadata;
+}
+
+QByteArray LazyPayment::rawJson() const {
+    if (!m_valid) {
+        return QByteArray();
+    }
+    
+    if (m_object.begin == 0 && m_object.end == m_buffer.size()) {
+        return m_buffer;
+    }
+    
+    return m_buffer.mid(m_object.begin, m_object.length());
+}
+
+Payment LazyPayment::toPayment() const {
+    Payment payment;
+    
+    payment.m_id = id();
+    payment.m_merchantId = merchantId();
+    payment.m_amount = amount();
+    payment.m_currency = currency();
+    payment.m_cryptoAmount = cryptoAmount();
+    payment.m_cryptoCurrency = cryptoCurrency();
+    payment.m_description = description();
+    payment.m_orderId = orderId();
+    payment.m_customerEmail = customerEmail();
+    payment.m_customerName = customerName();
+    payment.m_address = address();
+    payment.m_qrCodeUrl = qrCodeUrl();
+    payment.m_status = status();
+    payment.m_createdAt = createdAt();
+    payment.m_updatedAt = updatedAt();
+    payment.m_expiresAt = expiresAt();
+    payment.m_metadata = compactMetadata();
+    
+    return payment;
+}
+
+QString LazyPayment::stringField(Field field) const {
+    if (!isDecoded(field)) {
+        const JsonSpan& span = m_spans[field];
+        
+        if (span.length() >= 2 && m_buffer.at(span.begin) == '"') {
+            const char* data = m_buffer.constData() + span.begin + 1;
+            int length = span.length() - 2;
+            
+            if (std::memchr(data, '\\', length) == nullptr) {
+                m_strings[field] = QString::fromUtf8(data, length);
+            } else {
+                // Rare path: let QJsonDocument unescape the string
+                QByteArray wrapped = "[" + QByteArray::fromRawData(m_buffer.constData() + span.begin, span.length()) + "]";
+                m_strings[field] = QJsonDocument::fromJson(wrapped).array().at(0).toString();
+            }
+        }
+        
+        markDecoded(field);
+    }
+    
+    return m_strings[field];
+}
+
+double LazyPayment::numberField(Field field) const {
+    int slot = field == AmountField ? 0 : 1;
+    
+    if (!isDecoded(field)) {
+        const JsonSpan& span = m_spans[field];
+        
+        // Amounts are sent as decimal strings, but accept plain numbers too
+        if (span.length() >= 2 && m_buffer.at(span.begin) == '"') {
+            m_numbers[slot] = QByteArray::fromRawData(m_buffer.constData() + span.begin + 1, span.length() - 2).toDouble();
+        } else if (span.isValid()) {
+            m_numbers[slot] = QByteArray::fromRawData(m_buffer.constData() + span.begin, span.length()).toDouble();
+        }
+        
+        markDecoded(field);
+    }
+    
+    return m_numbers[slot];
+}
+
+QDateTime LazyPayment::dateField(Field field) const {
+    int slot = field - CreatedAtField;
+    
+    if (!isDecoded(field)) {
+        m_dates[slot] = QDateTime::fromString(stringField(field), Qt::ISODate);
+        markDecoded(field);
+    }
+    
+    return m_dates[slot];
+}
+
+WebhookSequencer::Version WebhookSequencer::versionOf(const Payment& payment, qint64 fallbackTimeMs) {
+    Version version;
+    version.status = payment.status();
+    switch (payment.status()) {
+        case PaymentStatus::Created:
+            version.rank = 0;
+            break;
+        case PaymentStatus::Pending:
+            version.rank = 1;
+            break;
+        default:
+            version.rank = 2;
+            break;
+    }
+    version.timeMs = payment.updatedAt().isValid() ? payment.updatedAt().toMSecsSinceEpoch() : fallbackTimeMs;
+    return version;
+}
+
+int WebhookSequencer::compare(const Version& a, const Version& b) {
+    if (a.rank != b.rank) {
+        return a.rank < b.rank ? -1 : 1;
+    }
+    // Without both timestamps, equal rank means the same version
+    const qint64 unknown = std::numeric_limits<qint64>::min();
+    if (a.timeMs == unknown || b.timeMs == unknown || a.timeMs == b.timeMs) {
+        return 0;
+    }
+    return a.timeMs < b.timeMs ? -1 : 1;
+}
+
+WebhookSequencer::Verdict WebhookSequencer::submit(const QString& eventType, const Payment& payment, qint64 eventTimeMs) {
+    Entry& entry = m_entries[payment.id()];
+    entry.touched = ++m_clock;
+    
+    Version version = versionOf(payment, eventTimeMs);
+    const Version& latest = entry.hasPending ? entry.pending : entry.delivered;
+    
+    // Terminal states are final: a second terminal event is either the same one again or a contradiction
+    if (latest.rank == 2) {
+        ++m_dropped;
+        return version.rank == 2 && version.status == latest.status ? Duplicate : Stale;
+    }
+    
+    int order = compare(version, latest);
+    if (order <= 0) {
+        ++m_dropped;
+        return order == 0 ? Duplicate : Stale;
+    }
+    
+    entry.pending = version;
+    entry.eventType = eventType;
+    entry.payment = payment;
+    if (entry.hasPending) {
+        return Coalesced;
+    }
+    entry.hasPending = true;
+    m_order.append(payment.id());
+    return Queued;
+}
+
+void WebhookSequencer::observe(const Payment& payment) {
+    if (payment.id().isEmpty()) {
+        return;
+    }
+    
+    Entry& entry = m_entries[payment.id()];
+    entry.touched = ++m_clock;
+    
+    Version version = versionOf(payment, std::numeric_limits<qint64>::min());
+    if (entry.delivered.rank != 2 && compare(version, entry.delivered) > 0) {
+        entry.delivered = version;
+    }
+    // A queued event the poll has already overtaken would move the UI backwards
+    if (entry.hasPending && compare(entry.pending, entry.delivered) < 0) {
+        entry.hasPending = false;
+        entry.payment = Payment();
+        ++m_dropped;
+    }
+}
+
+void WebhookSequencer::evictIdle() {
+    if (m_entries.size() <= m_capacity) {
+        return;
+    }
+    
+    // Forget the least recently touched payments down to three quarters of capacity
+    QVector<QPair<quint64, QString>> idle;
+    idle.reserve(m_entries.size());
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        if (!it->hasPending) {
+            idle.append(qMakePair(it->touched, it.key()));
+        }
+    }
+    
+    int excess = m_entries.size() - m_capacity * 3 / 4;
+    if (excess <= 0 || idle.isEmpty()) {
+        return;
+    }
+    excess = qMin(excess, idle.size());
+    std::nth_element(idle.begin(), idle.begin() + (excess - 1), idle.end());
+    for (int i = 0; i < excess; ++i) {
+        m_entries.remove(idle.at(i).second);
+    }
+}
+
+double ExchangeRateCache::parseRate(const QJsonValue& value) {
+    return value.isString() ? value.toString().toDouble() : value.toDouble();
+}
+
+QVariantMap ExchangeRateCache::oriented(const QVariantMap& rates, Orientation orientation) {
+    if (orientation == FiatPerCrypto) {
+        return rates;
+    }
+    QVariantMap converted;
+    for (auto it = rates.constBegin(); it != rates.constEnd(); ++it) {
+        converted.insert(it.key(), 1.0 / it.value().toDouble());
+    }
+    return converted;
+}
+
+ExchangeRateCache& ExchangeRateCache::instance() {
+    static ExchangeRateCache cache;
+    return cache;
+}
+
+void ExchangeRateCache::setTtl(int ttlMs, int maxStaleMs) {
+    QMutexLocker locker(&m_mutex);
+    m_ttlMs = qMax(0, ttlMs);
+    m_maxStaleMs = qMax(m_ttlMs.load(), maxStaleMs);
+}
+
+ExchangeRateCache::Freshness ExchangeRateCache::lookup(const QString& baseCurrency, const QStringList& cryptoCurrencies,
+        QVariantMap* rates, qint64 nowMs, qint64* fetchedAtMs) const {
+    char code[RateTable::MaxCodeLength + 1];
+    int fiatId = rateTableCode(baseCurrency, code) ? m_table.fiatId(code) : -1;
+    int cryptoIds[RateTable::MaxCrypto];
+    int count = cryptoCurrencies.size();
+    if (fiatId < 0 || count == 0 || count > RateTable::MaxCrypto) {
+        return lookupLocked(baseCurrency, cryptoCurrencies, rates, nowMs, fetchedAtMs);
+    }
+    for (int i = 0; i < count; ++i) {
+        cryptoIds[i] = rateTableCode(cryptoCurrencies.at(i), code) ? m_table.cryptoId(code) : -1;
+        if (cryptoIds[i] < 0) {
+            return lookupLocked(baseCurrency, cryptoCurrencies, rates, nowMs, fetchedAtMs);
+        }
+    }
+    
+    Freshness freshness = Fresh;
+    for (int i = 0; i < count; ++i) {
+        RateTable::Rate rate = m_table.read(fiatId, cryptoIds[i]);
+        Freshness pair = rate.rate > 0.0 ? freshnessAt(rate.fetchedAtMs, nowMs) : Missing;
+        if (pair == Missing) {
+            freshness = Missing;
+            continue;
+        }
+        if (pair == Stale && freshness == Fresh) {
+            freshness = Stale;
+        }
+        if (fetchedAtMs && (rates->isEmpty() || rate.fetchedAtMs < *fetchedAtMs)) {
+            *fetchedAtMs = rate.fetchedAtMs;
+        }
+        rates->insert(cryptoCurrencies.at(i), rate.rate);
+    }
+    return freshness;
+}
+
+ExchangeRateCache::Freshness ExchangeRateCache::lookupPair(const QString& baseCurrency, const QString& cryptoCurrency,
+        qint64 nowMs, RateTable::Rate* rate) const {
+    char code[RateTable::MaxCodeLength + 1];
+    int fiatId = rateTableCode(baseCurrency, code) ? m_table.fiatId(code) : -1;
+    int cryptoId = fiatId >= 0 && rateTableCode(cryptoCurrency, code) ? m_table.cryptoId(code) : -1;
+    if (cryptoId >= 0) {
+        *rate = m_table.read(fiatId, cryptoId);
+        return rate->rate > 0.0 ? freshnessAt(rate->fetchedAtMs, nowMs) : Missing;
+    }
+    
+    QVariantMap rates;
+    qint64 fetchedAtMs = 0;
+    Freshness freshness = lookupLocked(baseCurrency, QStringList() << cryptoCurrency, &rates, nowMs, &fetchedAtMs);
+    rate->rate = rates.value(cryptoCurrency).toDouble();
+    rate->fetchedAtMs = fetchedAtMs;
+    rate->variancePerMs = variancePerMs(baseCurrency, cryptoCurrency);
+    return freshness;
+}
+
+ExchangeRateCache::Freshness ExchangeRateCache::freshnessAt(qint64 fetchedAtMs, qint64 nowMs) const {
+    qint64 age = nowMs - fetchedAtMs;
+    if (age > m_maxStaleMs.load(std::memory_order_relaxed)) {
+        return Missing;
+    }
+    return age > m_ttlMs.load(std::memory_order_relaxed) ? Stale : Fresh;
+}
+
+ExchangeRateCache::Freshness ExchangeRateCache::lookupLocked(const QString& baseCurrency,
+        const QStringList& cryptoCurrencies, QVariantMap* rates, qint64 nowMs, qint64* fetchedAtMs) const {
+    QMutexLocker locker(&m_mutex);
+    auto table = m_rates.constFind(baseCurrency);
+    if (table == m_rates.constEnd() || cryptoCurrencies.isEmpty()) {
+        return Missing;
+    }
+    
+    Freshness freshness = Fresh;
+    for (const QString& currency : cryptoCurrencies) {
+        auto entry = table->constFind(currency);
+        if (entry == table->constEnd() || nowMs - entry->fetchedAtMs > m_maxStaleMs) {
+            freshness = Missing;
+            continue;
+        }
+        if (nowMs - entry->fetchedAtMs > m_ttlMs && freshness == Fresh) {
+            freshness = Stale;
+        }
+        if (fetchedAtMs && (rates->isEmpty() || entry->fetchedAtMs < *fetchedAtMs)) {
+            *fetchedAtMs = entry->fetchedAtMs;
+        }
+        rates->insert(currency, entry->rate);
+    }
+    return freshness;
+}
+
+void ExchangeRateCache::store(const QString& baseCurrency, const QVariantMap& rates, qint64 fetchedAtMs, Orientation orientation) {
+    QMutexLocker locker(&m_mutex);
+    QHash<QString, Entry>& table = m_rates[baseCurrency];
+    QHash<QString, RateHistory>& history = m_history[baseCurrency];
+    int fiatId = m_table.internFiat(baseCurrency.toLatin1().constData());
+    RateTable::Update updates[RateTable::MaxCrypto];
+    std::size_t updateCount = 0;
+    
+    for (auto it = rates.constBegin(); it != rates.constEnd(); ++it) {
+        // A missing or unparsable rate must not pass for a fresh one
+        double rate = it.value().toDouble();
+        if (!(rate > 0.0)) {
+            continue;
+        }
+        Entry& entry = table[it.key()];
+        if (fetchedAtMs >= entry.fetchedAtMs) {
+            entry.rate = orientation == CryptoPerFiat ? 1.0 / rate : rate;
+            entry.fetchedAtMs = fetchedAtMs;
+            RateHistory& pairHistory = history[it.key()];
+            pairHistory.push(fetchedAtMs, entry.rate);
+            
+            int cryptoId = fiatId >= 0 ? m_table.internCrypto(it.key().toLatin1().constData()) : -1;
+            if (cryptoId >= 0) {
+                updates[updateCount++] = { cryptoId, entry.rate, pairHistory.variancePerMs() };
+            }
+        }
+    }
+    
+    // One publish per call, so readers see the whole tick or none of it
+    if (updateCount > 0) {
+        m_table.publish(fiatId, updates, updateCount, fetchedAtMs);
+    }
+}
+
+bool ExchangeRateCache::beginRefresh(const QString& baseCurrency, qint64 nowMs) {
+    QMutexLocker locker(&m_mutex);
+    auto it = m_refreshing.constFind(baseCurrency);
+    if (it != m_refreshing.constEnd() && nowMs - *it < m_maxStaleMs) {
+        return false;
+    }
+    m_refreshing.insert(baseCurrency, nowMs);
+    return true;
+}
+
+void ExchangeRateCache::endRefresh(const QString& baseCurrency) {
+    {
+        QMutexLocker locker(&m_mutex);
+        m_refreshing.remove(baseCurrency);
+    }
+    emit ratesUpdated(baseCurrency);
+}
+
+QStringList ExchangeRateCache::baseCurrencies() const {
+    QMutexLocker locker(&m_mutex);
+    return m_rates.keys();
+}
+
+QVariantMap ExchangeRateCache::rates(const QString& baseCurrency, qint64* fetchedAtMs) const {
+    QMutexLocker locker(&m_mutex);
+    QVariantMap rates;
+    qint64 oldest = 0;
+    const QHash<QString, Entry> table = m_rates.value(baseCurrency);
+    for (auto it = table.constBegin(); it != table.constEnd(); ++it) {
+        rates.insert(it.key(), it->rate);
+        oldest = oldest == 0 ? it->fetchedAtMs : qMin(oldest, it->fetchedAtMs);
+    }
+    if (fetchedAtMs) {
+        *fetchedAtMs = oldest;
+    }
+    return rates;
+}
+
+double ExchangeRateCache::variancePerMs(const QString& baseCurrency, const QString& cryptoCurrency) const {
+    QMutexLocker locker(&m_mutex);
+    auto table = m_history.constFind(baseCurrency);
+    if (table == m_history.constEnd()) {
+        return -1.0;
+    }
+    auto history = table->constFind(cryptoCurrency);
+    return history == table->constEnd() ? -1.0 : history->variancePerMs();
+}
+
+int ExchangeRateCache::history(const QString& baseCurrency, const QString& cryptoCurrency, RateHistory::Tick* ticks,
+        int capacity) const {
+    QMutexLocker locker(&m_mutex);
+    auto table = m_history.constFind(baseCurrency);
+    if (table == m_history.constEnd()) {
+        return 0;
+    }
+    auto history = table->constFind(cryptoCurrency);
+    return history == table->constEnd() ? 0 : history->copy(ticks, capacity);
+}
+
+ActivePaymentStore::ActivePaymentStore(int finalCapacity)
+    : m_byId(16)
+    , m_byOrderId(16)
+    , m_finalCapacity(qMax(0, finalCapacity))
+{
+    for (int i = 0; i < StatusCount; ++i) {
+        m_head[i] = -1;
+        m_tail[i] = -1;
+        m_count[i] = 0;
+    }
+}
+
+void ActivePaymentStore::upsert(const Payment& payment) {
+    if (payment.id().isEmpty()) {
+        return;
+    }
+    
+    uint idHash = qHash(payment.id());
+    int slot = findSlot(m_byId, idHash, payment.id(), false);
+    int index;
+    bool orderChanged = true;
+    
+    if (slot >= 0) {
+        index = m_byId.at(slot).entry;
+        const Entry& entry = m_entries.at(index);
+        orderChanged = entry.payment.orderId() != payment.orderId();
+        if (orderChanged && !entry.payment.orderId().isEmpty()) {
+            eraseSlot(m_byOrderId, entry.orderHash, index);
+        }
+    } else {
+        // Keep both tables at most half full so probe runs stay short
+        if ((m_size + 1) * 2 > m_byId.size()) {
+            growTables();
+        }
+        if (!m_free.isEmpty()) {
+            index = m_free.takeLast();
+        } else {
+            index = m_entries.size();
+            m_entries.append(Entry());
+        }
+        m_entries[index].idHash = idHash;
+        insertSlot(m_byId, idHash, index);
+        ++m_size;
+    }
+    
+    Entry& entry = m_entries[index];
+    entry.payment = payment;
+    
+    if (orderChanged && !payment.orderId().isEmpty()) {
+        entry.orderHash = qHash(payment.orderId());
+        int existing = findSlot(m_byOrderId, entry.orderHash, payment.orderId(), true);
+        if (existing >= 0) {
+            m_byOrderId[existing].entry = index;
+        } else {
+            insertSlot(m_byOrderId, entry.orderHash, index);
+        }
+    }
+    
+    int status = static_cast<int>(payment.status());
+    if (entry.status != status) {
+        if (entry.status >= 0) {
+            unlink(index);
+        }
+        link(index, status);
+    }
+    
+    bool isFinal = isFinalPaymentStatus(payment.status());
+    qint64 deadline = !isFinal && payment.expiresAt().isValid() ? payment.expiresAt().toMSecsSinceEpoch() : NoExpiry;
+    if (deadline != entry.expiresAtMs) {
+        entry.expiresAtMs = deadline;
+        if (deadline == NoExpiry) {
+            heapRemove(index);
+        } else {
+            heapUpdate(index);
+        }
+    }
+    
+    if (isFinal) {
+        evictFinal();
+    }
+}
+
+bool ActivePaymentStore::remove(const QString& paymentId) {
+    int index = findEntry(paymentId);
+    if (index < 0) {
+        return false;
+    }
+    
+    const Entry& entry = m_entries.at(index);
+    eraseSlot(m_byId, entry.idHash, index);
+    if (!entry.payment.orderId().isEmpty()) {
+        eraseSlot(m_byOrderId, entry.orderHash, index);
+    }
+    unlink(index);
+    heapRemove(index);
+    
+    m_entries[index] = Entry();
+    m_free.append(index);
+    --m_size;
+    return true;
+}
+
+const Payment* ActivePaymentStore::find(const QString& paymentId) const {
+    int index = findEntry(paymentId);
+    return index >= 0 ? &m_entries.at(index).payment : nullptr;
+}
+
+const Payment* ActivePaymentStore::findByOrderId(const QString& orderId) const {
+    if (orderId.isEmpty()) {
+        return nullptr;
+    }
+    int slot = findSlot(m_byOrderId, qHash(orderId), orderId, true);
+    return slot >= 0 ? &m_entries.at(m_byOrderId.at(slot).entry).payment : nullptr;
+}
+
+QList<Payment> ActivePaymentStore::withStatus(PaymentStatus status) const {
+    int list = static_cast<int>(status);
+    QList<Payment> payments;
+    payments.reserve(m_count[list]);
+    for (int index = m_head[list]; index >= 0; index = m_entries.at(index).next) {
+        payments.append(m_entries.at(index).payment);
+    }
+    return payments;
+}
+
+QList<Payment> ActivePaymentStore::active() const {
+    return withStatus(PaymentStatus::Created) + withStatus(PaymentStatus::Pending);
+}
+
+int ActivePaymentStore::activeCount() const {
+    return m_count[static_cast<int>(PaymentStatus::Created)] + m_count[static_cast<int>(PaymentStatus::Pending)];
+}
+
+void ActivePaymentStore::setTimer(const QString& paymentId, QTimer* timer) {
+    int index = findEntry(paymentId);
+    if (index >= 0) {
+        m_entries[index].timer = timer;
+    }
+}
+
+QTimer* ActivePaymentStore::timer(const QString& paymentId) const {
+    int index = findEntry(paymentId);
+    return index >= 0 ? m_entries.at(index).timer : nullptr;
+}
+
+QTimer* ActivePaymentStore::takeTimer(const QString& paymentId) {
+    int index = findEntry(paymentId);
+    if (index < 0) {
+        return nullptr;
+    }
+    QTimer* timer = m_entries.at(index).timer;
+    m_entries[index].timer = nullptr;
+    return timer;
+}
+
+qint64 ActivePaymentStore::nextExpiry() const {
+    return m_expiryHeap.isEmpty() ? NoExpiry : m_entries.at(m_expiryHeap.first()).expiresAtMs;
+}
+
+QStringList ActivePaymentStore::takeExpired(qint64 nowMs) {
+    // The deadline stays on the entry, so re-storing the same payment does
+    // not re-arm it
+    QStringList expired;
+    while (!m_expiryHeap.isEmpty() && m_entries.at(m_expiryHeap.first()).expiresAtMs <= nowMs) {
+        int index = m_expiryHeap.first();
+        expired.append(m_entries.at(index).payment.id());
+        heapRemove(index);
+    }
+    return expired;
+}
+
+int ActivePaymentStore::findEntry(const QString& paymentId) const {
+    int slot = findSlot(m_byId, qHash(paymentId), paymentId, false);
+    return slot >= 0 ? m_byId.at(slot).entry : -1;
+}
+
+int ActivePaymentStore::findSlot(const QVector<Slot>& table, uint hash, const QString& key, bool byOrderId) const {
+    int mask = table.size() - 1;
+    for (int i = static_cast<int>(hash) & mask; ; i = (i + 1) & mask) {
+        const Slot& slot = table.at(i);
+        if (slot.entry < 0) {
+            return -1;
+        }
+        if (slot.hash == hash) {
+            const Payment& payment = m_entries.at(slot.entry).payment;
+            if ((byOrderId ? payment.orderId() : payment.id()) == key) {
+                return i;
+            }
+        }
+    }
+}
+
+void ActivePaymentStore::insertSlot(QVector<Slot>& table, uint hash, int entry) {
+    int mask = table.size() - 1;
+    int i = static_cast<int>(hash) & mask;
+    while (table.at(i).entry >= 0) {
+        i = (i + 1) & mask;
+    }
+    table[i].hash = hash;
+    table[i].entry = entry;
+}
+
+void ActivePaymentStore::eraseSlot(QVector<Slot>& table, uint hash, int entry) {
+    int mask = table.size() - 1;
+    int i = static_cast<int>(hash) & mask;
+    while (table.at(i).entry != entry) {
+        if (table.at(i).entry < 0) {
+            return;
+        }
+        i = (i + 1) & mask;
+    }
+    
+    // Backward-shift deletion: pull later members of the run into the gap
+    // unless that would move them before their home slot
+    for (int j = (i + 1) & mask; table.at(j).entry >= 0; j = (j + 1) & mask) {
+        int home = static_cast<int>(table.at(j).hash) & mask;
+        bool stays = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+        if (!stays) {
+            table[i] = table.at(j);
+            i = j;
+        }
+    }
+    table[i] = Slot();
+}
+
+void ActivePaymentStore::growTables() {
+    QVector<Slot> byId(m_byId.size() * 2);
+    QVector<Slot> byOrderId(m_byOrderId.size() * 2);
+    m_byId.swap(byId);
+    m_byOrderId.swap(byOrderId);
+    
+    for (const Slot& slot : byId) {
+        if (slot.entry >= 0) {
+            insertSlot(m_byId, slot.hash, slot.entry);
+        }
+    }
+    for (const Slot& slot : byOrderId) {
+        if (slot.entry >= 0) {
+            insertSlot(m_byOrderId, slot.hash, slot.entry);
+        }
+    }
+}
+
+void ActivePaymentStore::link(int entry, int status) {
+    Entry& e = m_entries[entry];
+    e.status = status;
+    e.prev = m_tail[status];
+    e.next = -1;
+    e.sequence = ++m_sequence;
+    if (m_tail[status] >= 0) {
+        m_entries[m_tail[status]].next = entry;
+    } else {
+        m_head[status] = entry;
+    }
+    m_tail[status] = entry;
+    ++m_count[status];
+}
+
+void ActivePaymentStore::unlink(int entry) {
+    Entry& e = m_entries[entry];
+    if (e.status < 0) {
+        return;
+    }
+    if (e.prev >= 0) {
+        m_entries[e.prev].next = e.next;
+    } else {
+        m_head[e.status] = e.next;
+    }
+    if (e.next >= 0) {
+        m_entries[e.next].prev = e.prev;
+    } else {
+        m_tail[e.status] = e.prev;
+    }
+    --m_count[e.status];
+    e.status = -1;
+    e.prev = -1;
+    e.next = -1;
+}
+
+void ActivePaymentStore::heapUpdate(int entry) {
+    int index = m_entries.at(entry).heapIndex;
+    if (index < 0) {
+        index = m_expiryHeap.size();
+        m_expiryHeap.append(entry);
+        m_entries[entry].heapIndex = index;
+    }
+    heapUp(index);
+    heapDown(m_entries.at(entry).heapIndex);
+}
+
+void ActivePaymentStore::heapRemove(int entry) {
+    int index = m_entries.at(entry).heapIndex;
+    if (index < 0) {
+        return;
+    }
+    
+    int last = m_expiryHeap.size() - 1;
+    heapSwap(index, last);
+    m_expiryHeap.removeLast();
+    m_entries[entry].heapIndex = -1;
+    if (index < last) {
+        heapUp(index);
+        heapDown(index);
+    }
+}
+
+void ActivePaymentStore::heapSwap(int a, int b) {
+    if (a == b) {
+        return;
+    }
+    qSwap(m_expiryHeap[a], m_expiryHeap[b]);
+    m_entries[m_expiryHeap.at(a)].heapIndex = a;
+    m_entries[m_expiryHeap.at(b)].heapIndex = b;
+}
+
+void ActivePaymentStore::heapUp(int index) {
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (m_entries.at(m_expiryHeap.at(index)).expiresAtMs >= m_entries.at(m_expiryHeap.at(parent)).expiresAtMs) {
+            break;
+        }
+        heapSwap(index, parent);
+        index = parent;
+    }
+}
+
+void ActivePaymentStore::heapDown(int index) {
+    int size = m_expiryHeap.size();
+    for (;;) {
+        int smallest = index;
+        for (int child = 2 * index + 1; child <= 2 * index + 2 && child < size; ++child) {
+            if (m_entries.at(m_expiryHeap.at(child)).expiresAtMs < m_entries.at(m_expiryHeap.at(smallest)).expiresAtMs) {
+                smallest = child;
+            }
+        }
+        if (smallest == index) {
+            return;
+        }
+        heapSwap(index, smallest);
+        index = smallest;
+    }
+}
+
+void ActivePaymentStore::evictFinal() {
+    const int finalStatuses[] = {
+        static_cast<int>(PaymentStatus::Completed),
+        static_cast<int>(PaymentStatus::Cancelled),
+        static_cast<int>(PaymentStatus::Expired)
+    };
+    
+    while (m_count[finalStatuses[0]] + m_count[finalStatuses[1]] + m_count[finalStatuses[2]] > m_finalCapacity) {
+        // Lists are in arrival order, so the oldest is one of the heads
+        int oldest = -1;
+        for (int status : finalStatuses) {
+            int head = m_head[status];
+            if (head >= 0 && (oldest < 0 || m_entries.at(head).sequence < m_entries.at(oldest).sequence)) {
+                oldest = head;
+            }
+        }
+        // A timer still attached belongs to the caller; evict once it is taken
+        if (oldest < 0 || m_entries.at(oldest).timer) {
+            return;
+        }
+        remove(m_entries.at(oldest).payment.id());
+    }
+}
+
+AsianCryptoPayment::AsianCryptoPayment(const QString& apiKey, const QString& merchantId, CountryCode countryCode, QObject* parent)
+    : QObject(parent)
+    , m_apiKey(apiKey)
+    , m_merchantId(merchantId)
+    , m_countryCode(countryCode)
+    , m_networkManager(new QNetworkAccessManager(this))
+    , m_countryModule(createCountryModule(countryCode))
+    , m_securityModule(std::make_unique<SecurityModule>(apiKey))
+    , m_paymentCache(1024)
+{
+    // Default supported cryptocurrencies
+    m_supportedCryptocurrencies << "BTC" << "ETH" << "USDT" << "USDC" << "BNB";
+    
+    // Connect network manager
+    connect(m_networkManager, &QNetworkAccessManager::finished, this, &AsianCryptoPayment::onNetworkReply);
+    
+    // One timer for all expiry deadlines, armed for the earliest
+    m_expiryTimer = new QTimer(this);
+    m_expiryTimer->setSingleShot(true);
+    connect(m_expiryTimer, &QTimer::timeout, this, &AsianCryptoPayment::checkExpiredPayments);
+    connect(&ExchangeRateCache::instance(), &ExchangeRateCache::ratesUpdated, this, &AsianCryptoPayment::onSharedRatesUpdated);
+    m_paymentCacheClock.start();
+    
+    qDebug() << "SDK initialized for country:" << m_countryModule->countryName();
+}
+
+AsianCryptoPayment::AsianCryptoPayment(const QString& apiKey, const QString& merchantId, CountryCode countryCode,
+        const QString& snapshotPath, QObject* parent)
+    : AsianCryptoPayment(apiKey, merchantId, countryCode, parent)
+{
+    enableSnapshots(snapshotPath);
+}
+
+AsianCryptoPayment::~AsianCryptoPayment() {
+    // Workers post to this object; stop them first
+    m_webhookPool.reset();
+    
+    if (m_snapshotDirty && !m_snapshotPath.isEmpty()) {
+        saveSnapshot();
+    }
+    
+    // Stop all payment timers
+    for (const Payment& payment : m_payments.active()) {
+        if (QTimer* timer = m_payments.takeTimer(payment.id())) {
+            timer->stop();
+            timer->deleteLater();
+        }
+    }
+}
+
+void AsianCryptoPayment::setTestMode(bool testMode) {
+    m_testMode = testMode;
+}
+
+void AsianCryptoPayment::setApiEndpoint(const QString& apiEndpoint) {
+    m_apiEndpoint = apiEndpoint;
+}
+
+void AsianCryptoPayment::setSupportedCryptocurrencies(const QStringList& supportedCryptocurrencies) {
+    m_supportedCryptocurrencies = supportedCryptocurrencies;
+    m_snapshotDirty = true;
+}
+
+void AsianCryptoPayment::setWebhookConfig(const QString& webhookEndpoint, const QString& webhookSecret) {
+    m_webhookConfig["endpoint"] = webhookEndpoint;
+    m_securityModule->rotateWebhookSecret(webhookSecret.toUtf8());
+}
+
+void AsianCryptoPayment::rotateApiKey(const QString& apiKey, int gracePeriodMs) {
+    m_apiKey = apiKey;
+    m_securityModule->rotateApiKey(apiKey.toUtf8(), gracePeriodMs);
+}
+
+void AsianCryptoPayment::rotateWebhookSecret(const QString& webhookSecret, int gracePeriodMs) {
+    m_securityModule->rotateWebhookSecret(webhookSecret.toUtf8(), gracePeriodMs);
+}
+
+void AsianCryptoPayment::createPayment(const PaymentDetails& paymentDetails) {
+    try {
+        // Validate payment details
+        validatePaymentDetails(paymentDetails);
+        
+        // Apply country-specific validations
+        m_countryModule->validatePayment(paymentDetails);
+        
+        // Write the request body directly; it is signed and sent as-is
+        JsonWriter writer;
+        writer.beginObject();
+        paymentDetails.writeJson(writer);
+        writer.member("merchant_id", m_merchantId);
+        writer.member("country_code", countryCodeToString(m_countryCode));
+        writer.member("test_mode", m_testMode);
+        writer.endObject();
+        
+        // Quote locally so the server's amount can be reconciled against it
+        PaymentQuote quote = localQuote(paymentDetails.amount(), paymentDetails.currency(), paymentDetails.cryptoCurrency());
+        
+        // Make API request
+        QNetworkReply* reply = makeApiRequest("payments", "POST", writer.data());
+        if (reply && quote.isValid()) {
+            m_pendingRequests[reply].quote = quote;
+        }
+    } catch (const std::exception& e) {
+        emit error(400, QString::fromStdString(e.what()));
+    }
+}
+
+void AsianCryptoPayment::getPayment(const QString& paymentId) {
+    if (paymentId.isEmpty()) {
+        emit error(400, "Payment ID is required");
+        return;
+    }
+    
+    const CachedPayment* cached = m_paymentCache.object(paymentId);
+    if (cached && !cached->stale) {
+        qint64 ttl = cached->payment.status() == PaymentStatus::Created ? m_createdTtlMs : m_pendingTtlMs;
+        if (isFinalPaymentStatus(cached->payment.status()) || m_paymentCacheClock.elapsed() - cached->storedAtMs < ttl) {
+            // Keep the reply asynchronous, as it is when the request goes out
+            Payment payment = cached->payment;
+            QTimer::singleShot(0, this, [this, payment]() {
+                emit paymentRetrieved(payment);
+            });
+            return;
+        }
+    }
+    
+    fetchPayment(paymentId);
+}
+
+void AsianCryptoPayment::setPaymentCacheTtl(PaymentStatus status, int ttlMs) {
+    if (status == PaymentStatus::Created) {
+        m_createdTtlMs = qMax(0, ttlMs);
+    } else if (status == PaymentStatus::Pending) {
+        m_pendingTtlMs = qMax(0, ttlMs);
+    }
+}
+
+void AsianCryptoPayment::fetchPayment(const QString& paymentId, bool poll) {
+    QString endpoint = "payments/" + paymentId;
+    QNetworkReply* reply = makeApiRequest(endpoint, "GET");
+    if (reply && poll) {
+        m_pendingRequests[reply].poll = true;
+    }
+}
+
+bool AsianCryptoPayment::emitPaymentDelta(const Payment& payment) {
+    // Compare with the tracked copy, else the cached one
+    const Payment* known = m_payments.find(payment.id());
+    if (!known) {
+        const CachedPayment* cached = m_paymentCache.object(payment.id());
+        known = cached ? &cached->payment : nullptr;
+    }
+    if (!known) {
+        return true;
+    }
+    
+    PaymentDelta delta = PaymentDelta::diff(*known, payment);
+    if (delta.isEmpty()) {
+        return false;
+    }
+    emit paymentChanged(delta);
+    return true;
+}
+
+void AsianCryptoPayment::cachePayment(const Payment& payment) {
+    if (payment.id().isEmpty()) {
+        return;
+    }
+    
+    CachedPayment* cached = new CachedPayment;
+    cached->payment = payment;
+    cached->storedAtMs = m_paymentCacheClock.elapsed();
+    m_paymentCache.insert(payment.id(), cached);
+    
+    if (m_ledger) {
+        QByteArray json = QJsonDocument(payment.toJson()).toJson(QJsonDocument::Compact);
+        m_ledger->upsert(ledgerRecord(payment), json.constData(), static_cast<std::size_t>(json.size()));
+    }
+}
+
+void AsianCryptoPayment::getPayments(const PaymentFilters& filters) {
+    if (getLocalPayments(filters)) {
+        return;
+    }
+    
+    QString endpoint = "payments";
+    
+    // Add query parameters if filters are provided
+    QString queryString = filters.buildQueryString();
+    if (!queryString.isEmpty()) {
+        endpoint += "?" + queryString;
+    }
+    
+    QNetworkReply* reply = makeApiRequest(endpoint, "GET");
+    
+    // A complete unfiltered answer proves the ledger holds the whole range
+    if (reply && m_ledger && filters.startDate().isValid() && !filters.hasStatus()
+            && filters.currency().isEmpty() && filters.cryptoCurrency().isEmpty() && filters.offset() == 0) {
+        // Payments created after the request went out are not in the answer
+        qint64 nowMs = QDateTime::currentMSecsSinceEpoch();
+        RequestContext& context = m_pendingRequests[reply];
+        context.syncRange = true;
+        context.rangeFromMs = filters.startDate().toMSecsSinceEpoch();
+        context.rangeToMs = filters.endDate().isValid() ? qMin(filters.endDate().toMSecsSinceEpoch(), nowMs) : nowMs;
+    }
+}
+
+bool AsianCryptoPayment::getLocalPayments(const PaymentFilters& filters) {
+    if (!m_ledger || !filters.startDate().isValid() || !filters.endDate().isValid() || filters.updatedSince().isValid()) {
+        return false;
+    }
+    
+    PaymentLedger::Query query;
+    query.fromMs = filters.startDate().toMSecsSinceEpoch();
+    query.toMs = filters.endDate().toMSecsSinceEpoch();
+    if (!m_ledger->isSynced(query.fromMs, query.toMs)) {
+        return false;
+    }
+    
+    // Statuses are as of when the range was recorded; payments not yet final
+    // may have moved on since, unless a sync has caught up with them
+    bool rechecked = m_syncCheckedAtMs >= 0 && m_syncCheckedAtMs >= m_rangeMarkedAtMs;
+    if (!rechecked) {
+        PaymentLedger::Query open = query;
+        open.status = static_cast<int>(PaymentStatus::Created);
+        if (m_ledger->count(open) > 0) {
+            return false;
+        }
+        open.status = static_cast<int>(PaymentStatus::Pending);
+        if (m_ledger->count(open) > 0) {
+            return false;
+        }
+    }
+    
+    query.status = filters.hasStatus() ? static_cast<int>(filters.status()) : -1;
+    query.currency = filters.currency().toStdString();
+    query.cryptoCurrency = filters.cryptoCurrency().toStdString();
+    query.offset = filters.offset();
+    query.limit = filters.limit();
+    
+    // Copy the payloads out; the mapping moves when the ledger grows
+    QList<LazyPayment> lazyPayments;
+    int total = m_ledger->query(query, [&lazyPayments](const char* payload, std::size_t length) {
+        LazyPayment payment = LazyPayment::fromBuffer(QByteArray(payload, static_cast<int>(length)));
+        if (payment.isValid()) {
+            lazyPayments.append(payment);
+        }
+    });
+    
+    // Keep the reply asynchronous, as it is when the request goes out
+    QTimer::singleShot(0, this, [this, lazyPayments, total]() {
+        emit lazyPaymentsRetrieved(lazyPayments, total);
+        
+        if (isSignalConnected(QMetaMethod::fromSignal(&AsianCryptoPayment::paymentsRetrieved))) {
+            QList<Payment> payments;
+            payments.reserve(lazyPayments.size());
+            
+            for (const LazyPayment& payment : lazyPayments) {
+                payments.append(payment.toPayment());
+            }
+            
+            emit paymentsRetrieved(payments, total);
+        }
+    });
+    return true;
+}
+
+void AsianCryptoPayment::listPayments(const PaymentFilters& filters, int pageSize, int prefetchPages) {
+    quint64 generation = m_listing.generation + 1;
+    m_listing = PaymentListing();
+    m_listing.generation = generation;
+    m_listing.active = true;
+    m_listing.filters = filters;
+    m_listing.pageSize = qBound(1, pageSize, 1000);
+    if (filters.limit() > 0) {
+        m_listing.pageSize = qMin(m_listing.pageSize, filters.limit());
+    }
+    m_listing.credit = qMax(1, prefetchPages) - 1;
+    
+    // The total is unknown until the first page is in
+    requestListingPage(filters.offset());
+}
+
+void AsianCryptoPayment::fetchMorePayments(int pages) {
+    if (!m_listing.active || pages <= 0) {
+        return;
+    }
+    m_listing.credit += pages;
+    pumpPaymentListing();
+}
+
+void AsianCryptoPayment::cancelPaymentListing() {
+    m_listing.active = false;
+    ++m_listing.generation;
+}
+
+void AsianCryptoPayment::requestListingPage(int offset) {
+    PaymentFilters filters = m_listing.filters;
+    filters.setOffset(offset).setLimit(m_listing.pageSize);
+    if (m_listing.total >= 0) {
+        filters.setLimit(qMin(m_listing.pageSize, m_listing.end - offset));
+    }
+    
+    QNetworkReply* reply = makeApiRequest("payments?" + filters.buildQueryString(), "GET");
+    if (!reply) {
+        m_listing.active = false;
+        emit error(500, "Payment listing request failed");
+        return;
+    }
+    
+    RequestContext& context = m_pendingRequests[reply];
+    context.type = RequestType::ListPayments;
+    context.listing = m_listing.generation;
+    context.offset = offset;
+    ++m_listing.inFlight;
+}
+
+void AsianCryptoPayment::pumpPaymentListing() {
+    while (m_listing.active && m_listing.total >= 0 && m_listing.nextOffset < m_listing.end && m_listing.credit > 0) {
+        qint64 now = QDateTime::currentMSecsSinceEpoch();
+        if (!m_listBudget.available(now)) {
+            if (!m_listing.pumpScheduled) {
+                m_listing.pumpScheduled = true;
+                quint64 generation = m_listing.generation;
+                QTimer::singleShot(static_cast<int>(qMin<qint64>(m_listBudget.waitMs(now), 60 * 1000)), this, [this, generation]() {
+                    if (m_listing.generation == generation) {
+                        m_listing.pumpScheduled = false;
+                        pumpPaymentListing();
+                    }
+                });
+            }
+            return;
+        }
+        
+        int offset = m_listing.nextOffset;
+        m_listing.nextOffset += m_listing.pageSize;
+        --m_listing.credit;
+        requestListingPage(offset);
+    }
+}
+
+void AsianCryptoPayment::handleListingPage(const RequestContext& context, const QList<LazyPayment>& page, int total) {
+    if (!m_listing.active || context.listing != m_listing.generation) {
+        return;
+    }
+    --m_listing.inFlight;
+    
+    if (m_listing.total < 0) {
+        int first = m_listing.filters.offset();
+        int limit = m_listing.filters.limit();
+        m_listing.total = total;
+        m_listing.end = limit > 0 ? qMin(total, first + limit) : total;
+        m_listing.nextOffset = first + page.size();
+        m_listing.pageSize = qMax(1, qMin(m_listing.pageSize, page.size()));
+    }
+    
+    storePaymentPage(page);
+    
+    QList<Payment> payments;
+    payments.reserve(page.size());
+    for (const LazyPayment& payment : page) {
+        payments.append(payment.toPayment());
+    }
+    emit paymentsPageRetrieved(payments, context.offset, m_listing.total);
+    
+    // A slot may have cancelled or replaced the listing
+    if (!m_listing.active || context.listing != m_listing.generation) {
+        return;
+    }
+    
+    if (m_listing.nextOffset >= m_listing.end && m_listing.inFlight == 0) {
+        m_listing.active = false;
+        emit paymentListingFinished(m_listing.total);
+        return;
+    }
+    pumpPaymentListing();
+}
+
+void AsianCryptoPayment::storePaymentPage(const QList<LazyPayment>& page) {
+    if (!m_ledger) {
+        return;
+    }
+    
+    // The raw JSON goes in as-is; nothing is decoded but the indexed fields
+    for (const LazyPayment& payment : page) {
+        QByteArray json = payment.rawJson();
+        m_ledger->upsert(ledgerRecord(payment), json.constData(), static_cast<std::size_t>(json.size()));
+    }
+}
+
+void AsianCryptoPayment::syncPayments(int pageSize) {
+    if (m_sync.running) {
+        return;
+    }
+    
+    m_sync = PaymentSync();
+    m_sync.running = true;
+    m_sync.pageSize = qBound(1, pageSize, 1000);
+    m_sync.sinceMs = m_syncCursorMs < 0 ? -1 : m_syncCursorMs - m_syncOverlapMs;
+    m_sync.cursorMs = m_syncCursorMs;
+    m_sync.cursorId = m_syncCursorId;
+    m_sync.startedAtMs = QDateTime::currentMSecsSinceEpoch();
+    requestSyncPage();
+}
+
+QString AsianCryptoPayment::paymentSyncCursor() const {
+    return m_syncCursorMs < 0 ? QString() : QString::number(m_syncCursorMs) + ":" + m_syncCursorId;
+}
+
+void AsianCryptoPayment::setPaymentSyncCursor(const QString& cursor) {
+    bool ok = false;
+    qint64 cursorMs = cursor.section(':', 0, 0).toLongLong(&ok);
+    m_syncCursorMs = ok && cursorMs >= 0 ? cursorMs : -1;
+    m_syncCursorId = m_syncCursorMs < 0 ? QString() : cursor.section(':', 1);
+    m_syncSeen.clear();
+}
+
+void AsianCryptoPayment::setPaymentSyncWindow(int overlapMs, qint64 lookbackMs) {
+    m_syncOverlapMs = qMax(0, overlapMs);
+    m_syncLookbackMs = qMax<qint64>(0, lookbackMs);
+}
+
+void AsianCryptoPayment::requestSyncPage() {
+    PaymentFilters filters;
+    filters.setLimit(m_sync.pageSize).setOffset(m_sync.offset);
+    if (m_sync.sinceMs >= 0) {
+        filters.setUpdatedSince(QDateTime::fromMSecsSinceEpoch(m_sync.sinceMs, Qt::UTC));
+    }
+    
+    QNetworkReply* reply = makeApiRequest("payments?" + filters.buildQueryString(), "GET");
+    if (!reply) {
+        m_sync.running = false;
+        emit error(500, "Payment sync request failed");
+        return;
+    }
+    m_pendingRequests[reply].type = RequestType::SyncPayments;
+}
+
+void AsianCryptoPayment::handleSyncPage(const QList<LazyPayment>& page, int total) {
+    qint64 lookbackStartMs = m_sync.sinceMs - m_syncLookbackMs;
+    bool recent = m_sync.sinceMs < 0;
+    
+    for (const LazyPayment& lazy : page) {
+        QString id = lazy.id();
+        qint64 updatedMs = ledgerTime(lazy.updatedAt());
+        if (ledgerTime(lazy.createdAt()) >= lookbackStartMs) {
+            recent = true;
+        }
+        if (id.isEmpty() || (m_sync.sinceMs >= 0 && updatedMs < m_sync.sinceMs)) {
+            continue;
+        }
+        recent = true;
+        
+        // Overlapping pages and windows return rows already reported
+        auto seen = m_syncSeen.constFind(id);
+        if (seen != m_syncSeen.constEnd() && *seen >= updatedMs) {
+            continue;
+        }
+        m_syncSeen.insert(id, updatedMs);
+        
+        Payment payment = lazy.toPayment();
+        m_webhookSequencer.observe(payment);
+        bool changed = emitPaymentDelta(payment);
+        cachePayment(payment);
+        if (m_payments.contains(id)) {
+            trackPayment(payment);
+        }
+        if (changed) {
+            notifySubscribers(payment);
+        }
+        m_sync.changed.append(payment);
+        
+        if (updatedMs > m_sync.cursorMs || (updatedMs == m_sync.cursorMs && id > m_sync.cursorId)) {
+            m_sync.cursorMs = updatedMs;
+            m_sync.cursorId = id;
+        }
+    }
+    
+    if (page.size() >= m_sync.pageSize && m_sync.offset + m_sync.pageSize < total && recent) {
+        m_sync.offset += m_sync.pageSize - m_sync.pageSize / 10;
+        requestSyncPage();
+        return;
+    }
+    
+    m_syncCursorMs = m_sync.cursorMs;
+    m_syncCursorId = m_sync.cursorId;
+    m_syncCheckedAtMs = m_sync.startedAtMs;
+    
+    // Only ids inside the next overlap window can come back
+    for (auto it = m_syncSeen.begin(); it != m_syncSeen.end(); ) {
+        if (*it < m_syncCursorMs - m_syncOverlapMs) {
+            it = m_syncSeen.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (m_ledger) {
+        m_ledger->sync();
+    }
+    
+    QList<Payment> changed;
+    changed.swap(m_sync.changed);
+    m_sync.running = false;
+    emit paymentsSynced(changed, paymentSyncCursor());
+}
+
+void AsianCryptoPayment::cancelPayment(const QString& paymentId) {
+    if (paymentId.isEmpty()) {
+        emit error(400, "Payment ID is required");
+        return;
+    }
+    
+    QString endpoint = "payments/" + paymentId + "/cancel";
+    makeApiRequest(endpoint, "POST");
+}
+
+void AsianCryptoPayment::getExchangeRates(const QString& baseCurrency, const QStringList& cryptoCurrencies) {
+    if (baseCurrency.isEmpty()) {
+        emit error(400, "Base currency is required");
+        return;
+    }
+    
+    QStringList currencies = cryptoCurrencies.isEmpty() ? m_supportedCryptocurrencies : cryptoCurrencies;
+    
+    ExchangeRateCache& cache = ExchangeRateCache::instance();
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    QVariantMap rates;
+    ExchangeRateCache::Freshness freshness = cache.lookup(baseCurrency, currencies, &rates, now);
+    
+    if (freshness != ExchangeRateCache::Missing) {
+        // Keep the reply asynchronous and shaped as it is when the request goes out
+        rates = ExchangeRateCache::oriented(rates, ExchangeRateCache::CryptoPerFiat);
+        QTimer::singleShot(0, this, [this, baseCurrency, rates]() {
+            emit exchangeRatesRetrieved(baseCurrency, rates);
+        });
+        // The refresh only updates the cache; this call has been answered
+        if (freshness == ExchangeRateCache::Stale && cache.beginRefresh(baseCurrency, now)) {
+            requestExchangeRates(baseCurrency, currencies, true);
+        }
+        return;
+    }
+    
+    if (!cache.beginRefresh(baseCurrency, now)) {
+        // Someone is fetching this base already; answer when it lands
+        QStringList& waiting = m_rateWaiters[baseCurrency];
+        for (const QString& currency : currencies) {
+            if (!waiting.contains(currency)) {
+                waiting << currency;
+            }
+        }
+        return;
+    }
+    requestExchangeRates(baseCurrency, currencies);
+}
+
+PaymentQuote AsianCryptoPayment::quotePayment(const PaymentDetails& paymentDetails) {
+    validatePaymentDetails(paymentDetails);
+    m_countryModule->validatePayment(paymentDetails);
+    
+    return localQuote(paymentDetails.amount(), paymentDetails.currency(), paymentDetails.cryptoCurrency());
+}
+
+void AsianCryptoPayment::setQuoteFees(double feePercent, double feeFixed) {
+    m_quoteFeePercent = qMax(0.0, feePercent);
+    m_quoteFeeFixed = qMax(0.0, feeFixed);
+}
+
+void AsianCryptoPayment::setQuoteValidity(int validityMs) {
+    m_quoteValidityMs = qMax(0, validityMs);
+}
+
+void AsianCryptoPayment::setAdaptiveQuoteValidity(double tolerance, int minValidityMs, int maxValidityMs) {
+    m_quoteTolerance = qMax(0.0, tolerance);
+    m_minQuoteValidityMs = qMax(0, minValidityMs);
+    m_maxQuoteValidityMs = qMax(m_minQuoteValidityMs, maxValidityMs);
+}
+
+int AsianCryptoPayment::quoteValidityMs(const QString& currency, const QString& cryptoCurrency) const {
+    RateTable::Rate rate;
+    ExchangeRateCache::instance().lookupPair(currency, cryptoCurrency, QDateTime::currentMSecsSinceEpoch(), &rate);
+    return quoteValidityFor(rate.variancePerMs);
+}
+
+int AsianCryptoPayment::quoteValidityFor(double variance) const {
+    if (m_quoteTolerance <= 0.0 || variance < 0.0) {
+        return m_quoteValidityMs;
+    }
+    if (variance == 0.0) {
+        return m_maxQuoteValidityMs;
+    }
+    
+    // Time over which a two-sigma move stays within the tolerance
+    double halfTolerance = m_quoteTolerance / 2.0;
+    double validityMs = halfTolerance * halfTolerance / variance;
+    return static_cast<int>(qBound<double>(m_minQuoteValidityMs, validityMs, m_maxQuoteValidityMs));
+}
+
+QVector<RateHistory::Tick> AsianCryptoPayment::rateHistory(const QString& baseCurrency, const QString& cryptoCurrency,
+        int maxTicks) const {
+    QVector<RateHistory::Tick> ticks(qBound(0, maxTicks, static_cast<int>(RateHistory::Capacity)));
+    ticks.resize(ExchangeRateCache::instance().history(baseCurrency, cryptoCurrency, ticks.data(), ticks.size()));
+    return ticks;
+}
+
+PaymentQuote AsianCryptoPayment::localQuote(double amount, const QString& currency, const QString& cryptoCurrency) {
+    ExchangeRateCache& cache = ExchangeRateCache::instance();
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    RateTable::Rate pair;
+    ExchangeRateCache::Freshness freshness = cache.lookupPair(currency, cryptoCurrency, now, &pair);
+    int validityMs = quoteValidityFor(pair.variancePerMs);
+    
+    // Quietly keep the rate warm for the next quote, sooner for volatile pairs
+    bool aging = freshness != ExchangeRateCache::Fresh || now - pair.fetchedAtMs > validityMs / 2;
+    if (aging && cache.beginRefresh(currency, now)) {
+        requestExchangeRates(currency, QStringList() << cryptoCurrency, true);
+    }
+    
+    PaymentQuote quote;
+    quote.m_amount = amount;
+    quote.m_currency = currency;
+    quote.m_cryptoCurrency = cryptoCurrency;
+    
+    double rate = pair.rate;
+    if (freshness == ExchangeRateCache::Missing || rate <= 0.0) {
+        return quote;
+    }
+    
+    double scale = std::pow(10.0, cryptoDecimals(cryptoCurrency));
+    quote.m_fee = amount * m_quoteFeePercent / 100.0 + m_quoteFeeFixed;
+    quote.m_rate = rate;
+    // Cached rates are fiat per crypto unit (see ExchangeRateCache)
+    quote.m_cryptoAmount = std::round((amount + quote.m_fee) / rate * scale) / scale;
+    quote.m_rateTimeMs = pair.fetchedAtMs;
+    quote.m_validUntilMs = now + validityMs;
+    quote.m_stale = freshness == ExchangeRateCache::Stale;
+    quote.m_valid = true;
+    return quote;
+}
+
+void AsianCryptoPayment::reconcileQuote(const Payment& payment, const PaymentQuote& quote) {
+    if (payment.cryptoAmount() <= 0.0 || payment.cryptoCurrency() != quote.cryptoCurrency()) {
+        return;
+    }
+    
+    double drift = (payment.cryptoAmount() - quote.cryptoAmount()) / payment.cryptoAmount();
+    m_quoteDrift.count++;
+    m_quoteDrift.lastDrift = drift;
+    m_quoteDrift.meanAbsDrift += (std::fabs(drift) - m_quoteDrift.meanAbsDrift) / m_quoteDrift.count;
+    m_quoteDrift.maxAbsDrift = qMax(m_quoteDrift.maxAbsDrift, std::fabs(drift));
+    
+    emit quoteReconciled(payment.id(), quote, drift);
+}
+
+void AsianCryptoPayment::setExchangeRateCacheTtl(int ttlMs, int maxStaleMs) {
+    ExchangeRateCache::instance().setTtl(ttlMs, maxStaleMs);
+}
+
+void AsianCryptoPayment::requestExchangeRates(const QString& baseCurrency, const QStringList& cryptoCurrencies,
+        bool refreshOnly) {
+    QString endpoint = "exchange-rates?base_currency=" + baseCurrency + "&currencies=" + cryptoCurrencies.join(",");
+    QNetworkReply* reply = makeApiRequest(endpoint, "GET");
+    if (!reply) {
+        ExchangeRateCache::instance().endRefresh(baseCurrency);
+        return;
+    }
+    RequestContext& context = m_pendingRequests[reply];
+    context.id = baseCurrency;
+    context.refreshOnly = refreshOnly;
+}
+
+void AsianCryptoPayment::onSharedRatesUpdated(const QString& baseCurrency) {
+    auto it = m_rateWaiters.find(baseCurrency);
+    if (it == m_rateWaiters.end()) {
+        return;
+    }
+    QStringList currencies = it.value();
+    m_rateWaiters.erase(it);
+    
+    QVariantMap rates;
+    if (ExchangeRateCache::instance().lookup(baseCurrency, currencies, &rates, QDateTime::currentMSecsSinceEpoch())
+            != ExchangeRateCache::Missing) {
+        emit exchangeRatesRetrieved(baseCurrency, ExchangeRateCache::oriented(rates, ExchangeRateCache::CryptoPerFiat));
+    } else {
+        // The refresh failed or did not cover these; fetch them ourselves
+        getExchangeRates(baseCurrency, currencies);
+    }
+}
+
+bool AsianCryptoPayment::verifyWebhookSignature(const QString& signature, const QString& body) {
+    if (!m_securityModule->hasWebhookSecret()) {
+        qWarning() << "Webhooks not initialized";
+        return false;
+    }
+    
+    return m_securityModule->verifyWebhookSignature(signature.toLatin1(), body.toUtf8());
+}
+
+bool AsianCryptoPayment::processWebhookEvent(const QJsonObject& event, const QString& signature) {
+    // Only correct if the sender serialized the event the same way; prefer
+    // processWebhookPayload() with the raw request body.
+    QJsonDocument doc(event);
+    return processWebhookPayload(doc.toJson(QJsonDocument::Compact), signature.toLatin1());
+}
+
+bool AsianCryptoPayment::processWebhookPayload(const QByteArray& body, const QByteArray& signature) {
+    if (!m_securityModule->hasWebhookSecret()) {
+        qWarning() << "Webhooks not initialized";
+        return false;
+    }
+    
+    if (m_webhookPool) {
+        WebhookDelivery delivery;
+        delivery.body = body;
+        delivery.signature = signature;
+        return submitWebhook(delivery);
+    }
+    
+    // Authenticate the bytes before touching them, so forged traffic costs
+    // one HMAC and no parsing
+    if (!m_securityModule->verifyWebhookSignature(signature.trimmed(), body)) {
+        qWarning() << "Invalid webhook signature";
+        return false;
+    }
+    
+    return handleVerifiedWebhook(body, signature.trimmed());
+}
+
+QBitArray AsianCryptoPayment::processWebhookPayloads(const QVector<WebhookDelivery>& deliveries) {
+    if (!m_securityModule->hasWebhookSecret()) {
+        qWarning() << "Webhooks not initialized";
+        return QBitArray(deliveries.size());
+    }
+    
+    if (m_webhookPool) {
+        QBitArray queued(deliveries.size());
+        for (int i = 0; i < deliveries.size(); ++i) {
+            queued.setBit(i, submitWebhook(deliveries.at(i)));
+        }
+        return queued;
+    }
+    
+    QBitArray processed = m_securityModule->verifyWebhookBatch(deliveries);
+    for (int i = 0; i < deliveries.size(); ++i) {
+        if (!processed.testBit(i)) {
+            qWarning() << "Invalid webhook signature";
+            continue;
+        }
+        processed.setBit(i, handleVerifiedWebhook(deliveries.at(i).body, deliveries.at(i).signature.trimmed()));
+    }
+    
+    return processed;
+}
+
+bool AsianCryptoPayment::handleVerifiedWebhook(const QByteArray& body, const QByteArray& signature) {
+    DecodedWebhook event;
+    if (!decodeWebhook(body, &event)) {
+        return false;
+    }
+    
+    return applyWebhook(event, signature);
+}
+
+bool AsianCryptoPayment::decodeWebhook(const QByteArray& body, DecodedWebhook* event) {
+    // Runs on webhook workers too: touch nothing but the arguments
+    event->body = body;
+    JsonScanner scanner(body.constData(), body.size());
+    JsonSpan data;
+    JsonSpan timestamp;
+    int pos = 0;
+    
+    bool ok = scanner.forEachMember(pos, [&](const char* key, int length, const JsonSpan& value) {
+        if ((JsonScanner::keyEquals(key, length, "type") || JsonScanner::keyEquals(key, length, "event"))
+                && scanner.isString(value)) {
+            event->eventType = QString::fromUtf8(body.constData() + value.begin + 1, value.length() - 2);
+        } else if (JsonScanner::keyEquals(key, length, "data")) {
+            data = value;
+        } else if (JsonScanner::keyEquals(key, length, "timestamp") || JsonScanner::keyEquals(key, length, "created")) {
+            timestamp = value;
+        }
+        return true;
+    });
+    
+    if (!ok) {
+        qWarning() << "Malformed webhook payload";
+        return false;
+    }
+    
+    // ISO 8601 or Unix seconds / milliseconds; anything else stays NoTimestamp and is rejected
+    if (scanner.isString(timestamp)) {
+        QDateTime parsed = QDateTime::fromString(QString::fromLatin1(body.constData() + timestamp.begin + 1, timestamp.length() - 2), Qt::ISODate);
+        if (parsed.isValid()) {
+            event->eventTimeMs = parsed.toMSecsSinceEpoch();
+        }
+    } else if (timestamp.isValid()) {
+        bool numeric = false;
+        double value = QByteArray(body.constData() + timestamp.begin, timestamp.length()).toDouble(&numeric);
+        if (numeric && value > 0.0 && value < 1e15) {
+            event->eventTimeMs = static_cast<qint64>(value < 1e11 ? value * 1000.0 : value);
+        }
+    }
+    
+    if (data.isValid() && body.at(data.begin) == '{') {
+        LazyPayment payment = LazyPayment::fromBuffer(body, data);
+        if (!payment.isValid()) {
+            qWarning() << "Malformed webhook payment data";
+            return false;
+        }
+        event->payment = payment.toPayment();
+        event->hasPayment = true;
+    }
+    
+    return true;
+}
+
+bool AsianCryptoPayment::applyWebhook(const DecodedWebhook& event, const QByteArray& signature) {
+    if (!m_securityModule->acceptWebhook(signature, event.eventTimeMs)) {
+        qWarning() << "Replayed or stale webhook rejected";
+        return false;
+    }
     
-    // Connect network manager
-    connect(m_networkManager, &QNetworkAccessManager::finished, this, &AsianCryptoPayment::onNetworkReply);
+    if (event.hasPayment) {
+        if (event.payment.id().isEmpty()) {
+            dispatchWebhookEvent(event.eventType, event.payment);
+            return true;
+        }
+        
+        WebhookSequencer::Verdict verdict = m_webhookSequencer.submit(event.eventType, event.payment, event.eventTimeMs);
+        if (verdict == WebhookSequencer::Queued || verdict == WebhookSequencer::Coalesced) {
+            // Newer state is on its way; do not answer from the old copy
+            // meanwhile, but keep it to diff the new state against
+            if (CachedPayment* cached = m_paymentCache.object(event.payment.id())) {
+                cached->stale = true;
+            }
+            journal(JournalWebhook, event.body);
+        }
+        if (verdict == WebhookSequencer::Queued) {
+            scheduleWebhookFlush();
+        }
+    }
     
-    qDebug() << "SDK initialized for country:" << m_countryModule->countryName();
+    return true;
 }
 
-AsianCryptoPayment::~AsianCryptoPayment() {
-    // Stop all payment timers
-    for (auto timer : m_paymentTimers.values()) {
-        timer->stop();
-        timer->deleteLater();
+void AsianCryptoPayment::setWebhookWorkerThreads(int threads, int queueCapacity) {
+    m_webhookPool.reset();
+    if (threads <= 0) {
+        return;
     }
-    m_paymentTimers.clear();
+    
+    const SecurityModule* security = m_securityModule.get();
+    m_webhookPool.reset(new WebhookWorkerPool(threads, static_cast<std::size_t>(qMax(1, queueCapacity)),
+        [security](WebhookDelivery& delivery, WebhookResult& result) {
+            result.signature = delivery.signature.trimmed();
+            result.verified = security->verifyWebhookSignature(result.signature, delivery.body);
+            result.decoded = result.verified && decodeWebhook(delivery.body, &result.event);
+        },
+        [this]() {
+            QMetaObject::invokeMethod(this, "drainWebhookResults", Qt::QueuedConnection);
+        }));
 }
 
-void AsianCryptoPayment::setTestMode(bool testMode) {
-    m_testMode = testMode;
+int AsianCryptoPayment::webhookWorkerThreads() const {
+    return m_webhookPool ? m_webhookPool->threadCount() : 0;
 }
 
-void AsianCryptoPayment::setApiEndpoint(const QString& apiEndpoint) {
-    m_apiEndpoint = apiEndpoint;
+bool AsianCryptoPayment::submitWebhook(const WebhookDelivery& delivery) {
+    // Round robin: the body is not looked at before its MAC is checked
+    WebhookDelivery job = delivery;
+    if (!m_webhookPool->submit(m_nextWebhookWorker++, std::move(job))) {
+        qWarning() << "Webhook worker queue full, delivery dropped";
+        return false;
+    }
+    return true;
 }
 
-void AsianCryptoPayment::setSupportedCryptocurrencies(const QStringList& supportedCryptocurrencies) {
-    m_supportedCryptocurrencies = supportedCryptocurrencies;
+void AsianCryptoPayment::drainWebhookResults() {
+    if (!m_webhookPool) {
+        return;
+    }
+    
+    // Workers finish in any order; the sequencer in applyWebhook() keeps each payment's newest state
+    m_webhookPool->drain([this](WebhookResult& result) {
+        if (!result.verified) {
+            qWarning() << "Invalid webhook signature";
+            return;
+        }
+        if (result.decoded) {
+            applyWebhook(result.event, result.signature);
+        }
+    });
 }
 
-void AsianCryptoPayment::setWebhookConfig(const QString& webhookEndpoint, const QString& webhookSecret) {
-    m_webhookConfig["endpoint"] = webhookEndpoint;
-    m_webhookConfig["secret"] = webhookSecret;
+void AsianCryptoPayment::scheduleWebhookFlush() {
+    if (m_webhookFlushScheduled) {
+        return;
+    }
+    m_webhookFlushScheduled = true;
+    
+    // Everything verified during this event loop turn goes out in one cycle
+    QTimer::singleShot(0, this, [this]() {
+        m_webhookFlushScheduled = false;
+        m_webhookSequencer.flush([this](const QString& eventType, const Payment& payment) {
+            dispatchWebhookEvent(eventType, payment);
+        });
+    });
 }
 
-void AsianCryptoPayment::createPayment(const PaymentDetails& paymentDetails) {
-    try {
-        // Validate payment details
-        validatePaymentDetails(paymentDetails);
-        
-        // Apply country-specific validations
-        m_countryModule->validatePayment(paymentDetails);
+void AsianCryptoPayment::dispatchWebhookEvent(const QString& eventType, const Payment& payment) {
+    bool changed = emitPaymentDelta(payment);
+    cachePayment(payment);
+    if (m_payments.contains(payment.id())) {
+        trackPayment(payment);
+    }
+    if (changed) {
+        notifySubscribers(payment);
+    }
+    
+    if (eventType == "payment.created") {
+        emit paymentCreated(payment);
+    } else if (eventType == "payment.updated") {
+        emit paymentStatusUpdated(payment);
+    } else if (eventType == "payment.completed") {
+        emit paymentStatusUpdated(payment);
+        stopPaymentStatusCheck(payment.id());
+    } else if (eventType == "payment.cancelled") {
+        emit paymentStatusUpdated(payment);
+        stopPaymentStatusCheck(payment.id());
+    } else if (eventType == "payment.expired") {
+        emit paymentStatusUpdated(payment);
+        stopPaymentStatusCheck(payment.id());
+    }
+}
+
+int AsianCryptoPayment::enableEventJournal(const QString& directory) {
+    QDir dir(directory);
+    if (!dir.mkpath(".")) {
+        qWarning() << "Event journal directory unavailable:" << directory;
+        return -1;
+    }
+    
+    std::unique_ptr<EventJournal> opened(new EventJournal());
+    std::string error;
+    if (!opened->open(QFile::encodeName(dir.absolutePath()).toStdString(), &error)) {
+        qWarning() << "Event journal unavailable:" << QString::fromStdString(error);
+        return -1;
+    }
+    
+    // Records are in processing order, so the last one per payment wins,
+    // except that nothing leaves a final status
+    QHash<QString, Payment> latest;
+    std::size_t records = opened->replay([&latest](quint32 type, qint64, const char* data, std::size_t length) {
+        QByteArray record = QByteArray::fromRawData(data, static_cast<int>(length));
+        Payment payment;
         
-        // Prepare payment data
-        QJsonObject paymentData = paymentDetails.toJson();
-        paymentData["merchant_id"] = m_merchantId;
-        paymentData["country_code"] = countryCodeToString(m_countryCode);
-        paymentData["test_mode"] = m_testMode;
+        if (type == JournalWebhook) {
+            DecodedWebhook event;
+            if (!decodeWebhook(record, &event) || !event.hasPayment) {
+                return;
+            }
+            payment = event.payment;
+        } else if (type == JournalPayment) {
+            LazyPayment lazy = LazyPayment::fromBuffer(record);
+            if (!lazy.isValid()) {
+                return;
+            }
+            payment = lazy.toPayment();
+        } else {
+            return;
+        }
         
-        // Make API request
-        makeApiRequest("payments", "POST", paymentData);
-    } catch (const std::exception& e) {
-        emit error(400, QString::fromStdString(e.what()));
+        auto it = latest.constFind(payment.id());
+        if (payment.id().isEmpty()
+                || (it != latest.constEnd() && isFinalPaymentStatus(it->status()) && !isFinalPaymentStatus(payment.status()))) {
+            return;
+        }
+        latest.insert(payment.id(), payment);
+    });
+    
+    int restored = 0;
+    for (const Payment& payment : latest) {
+        m_webhookSequencer.observe(payment);
+        trackPayment(payment);
+        if (!isFinalPaymentStatus(payment.status())) {
+            startPaymentStatusCheck(payment);
+            ++restored;
+        }
     }
+    
+    m_journal = std::move(opened);
+    m_journalSegment = m_journal->segmentSequence();
+    qDebug() << "Event journal replayed" << records << "records," << restored << "active payments restored";
+    return restored;
 }
 
-void AsianCryptoPayment::getPayment(const QString& paymentId) {
-    if (paymentId.isEmpty()) {
-        emit error(400, "Payment ID is required");
-        return;
+bool AsianCryptoPayment::enablePaymentLedger(const QString& filePath) {
+    QFileInfo info(filePath);
+    if (!QDir().mkpath(info.absolutePath())) {
+        qWarning() << "Payment ledger directory unavailable:" << info.absolutePath();
+        return false;
     }
     
-    QString endpoint = "payments/" + paymentId;
-    makeApiRequest(endpoint, "GET");
+    std::unique_ptr<PaymentLedger> opened(new PaymentLedger());
+    std::string error;
+    if (!opened->open(QFile::encodeName(info.absoluteFilePath()).toStdString(), &error)) {
+        qWarning() << "Payment ledger unavailable:" << QString::fromStdString(error);
+        return false;
+    }
+    
+    m_ledger = std::move(opened);
+    qDebug() << "Payment ledger opened with" << m_ledger->size() << "payments";
+    return true;
 }
 
-void AsianCryptoPayment::getPayments(const PaymentFilters& filters) {
-    QString endpoint = "payments";
+int AsianCryptoPayment::enableSnapshots(const QString& filePath, int intervalMs) {
+    QFileInfo info(filePath);
+    if (!QDir().mkpath(info.absolutePath())) {
+        qWarning() << "Snapshot directory unavailable:" << info.absolutePath();
+        return -1;
+    }
+    m_snapshotPath = info.absoluteFilePath();
     
-    // Add query parameters if filters are provided
-    QString queryString = filters.buildQueryString();
-    if (!queryString.isEmpty()) {
-        endpoint += "?" + queryString;
+    if (!m_snapshotTimer) {
+        m_snapshotTimer = new QTimer(this);
+        connect(m_snapshotTimer, &QTimer::timeout, this, [this]() {
+            if (m_snapshotDirty) {
+                saveSnapshot();
+            }
+        });
+    }
+    m_snapshotTimer->start(qMax(1000, intervalMs));
+    
+    if (!info.exists()) {
+        return 0;
+    }
+    
+    std::string data;
+    std::string error;
+    if (!SnapshotFile::read(QFile::encodeName(m_snapshotPath).toStdString(), &data, nullptr, &error)) {
+        qWarning() << "Snapshot unreadable:" << QString::fromStdString(error);
+        return -1;
+    }
+    
+    QJsonDocument doc = QJsonDocument::fromJson(QByteArray::fromRawData(data.data(), static_cast<int>(data.size())));
+    if (!doc.isObject() || doc.object()["merchant_id"].toString() != m_merchantId) {
+        qWarning() << "Snapshot ignored: not written by this merchant";
+        return -1;
     }
     
-    makeApiRequest(endpoint, "GET");
+    int before = m_payments.activeCount();
+    restoreSnapshot(doc.object());
+    int restored = m_payments.activeCount() - before;
+    qDebug() << "Snapshot restored" << restored << "active payments";
+    return restored;
 }
 
-void AsianCryptoPayment::cancelPayment(const QString& paymentId) {
-    if (paymentId.isEmpty()) {
-        emit error(400, "Payment ID is required");
-        return;
+void AsianCryptoPayment::restoreSnapshot(const QJsonObject& snapshot) {
+    // Only derived state: the file is not authenticated, and settings such
+    // as the endpoint or test mode must come from the integrator's code
+    QJsonObject config = snapshot["config"].toObject();
+    if (config.contains("supported_cryptocurrencies")) {
+        m_supportedCryptocurrencies.clear();
+        for (const QJsonValue& code : config["supported_cryptocurrencies"].toArray()) {
+            m_supportedCryptocurrencies << code.toString();
+        }
+    }
+    if (m_syncCursorMs < 0 && config.contains("payment_sync_cursor")) {
+        setPaymentSyncCursor(config["payment_sync_cursor"].toString());
     }
     
-    QString endpoint = "payments/" + paymentId + "/cancel";
-    makeApiRequest(endpoint, "POST");
+    // The shared cache keeps whichever rates are newer
+    QJsonObject rateTables = snapshot["exchange_rates"].toObject();
+    for (auto it = rateTables.begin(); it != rateTables.end(); ++it) {
+        QJsonObject table = it.value().toObject();
+        ExchangeRateCache::instance().store(it.key(), table["rates"].toObject().toVariantMap(),
+                static_cast<qint64>(table["fetched_at"].toDouble()));
+    }
+    
+    QStringList paymentIds;
+    for (const QJsonValue& value : snapshot["payments"].toArray()) {
+        Payment payment = Payment::fromJson(value.toObject());
+        if (payment.id().isEmpty() || isFinalPaymentStatus(payment.status()) || m_payments.contains(payment.id())) {
+            continue;
+        }
+        m_webhookSequencer.observe(payment);
+        cachePayment(payment);
+        startPaymentStatusCheck(payment);
+        paymentIds << payment.id();
+    }
+    
+    // Serve from the restored state now, then catch up with the server
+    QStringList bases = rateTables.keys();
+    QTimer::singleShot(0, this, [this, paymentIds, bases]() {
+        for (const QString& paymentId : paymentIds) {
+            if (m_payments.contains(paymentId)) {
+                fetchPayment(paymentId, true);
+            }
+        }
+        for (const QString& base : bases) {
+            getExchangeRates(base, ExchangeRateCache::instance().rates(base).keys());
+        }
+    });
 }
 
-void AsianCryptoPayment::getExchangeRates(const QString& baseCurrency, const QStringList& cryptoCurrencies) {
-    if (baseCurrency.isEmpty()) {
-        emit error(400, "Base currency is required");
+bool AsianCryptoPayment::saveSnapshot() {
+    if (m_snapshotPath.isEmpty()) {
+        return false;
+    }
+    
+    QJsonObject config;
+    config["supported_cryptocurrencies"] = QJsonArray::fromStringList(m_supportedCryptocurrencies);
+    if (m_syncCursorMs >= 0) {
+        config["payment_sync_cursor"] = paymentSyncCursor();
+    }
+    
+    QJsonObject rateTables;
+    for (const QString& base : ExchangeRateCache::instance().baseCurrencies()) {
+        qint64 fetchedAtMs = 0;
+        QJsonObject table;
+        table["rates"] = QJsonObject::fromVariantMap(ExchangeRateCache::instance().rates(base, &fetchedAtMs));
+        table["fetched_at"] = static_cast<double>(fetchedAtMs);
+        rateTables[base] = table;
+    }
+    
+    QJsonArray payments;
+    for (const Payment& payment : m_payments.active()) {
+        payments.append(payment.toJson());
+    }
+    
+    QJsonObject snapshot;
+    snapshot["merchant_id"] = m_merchantId;
+    snapshot["config"] = config;
+    snapshot["exchange_rates"] = rateTables;
+    snapshot["payments"] = payments;
+    
+    QByteArray data = QJsonDocument(snapshot).toJson(QJsonDocument::Compact);
+    std::string error;
+    if (!SnapshotFile::write(QFile::encodeName(m_snapshotPath).toStdString(), data.constData(),
+            static_cast<std::size_t>(data.size()), QDateTime::currentMSecsSinceEpoch(), &error)) {
+        qWarning() << "Snapshot failed:" << QString::fromStdString(error);
+        return false;
+    }
+    
+    m_snapshotDirty = false;
+    return true;
+}
+
+QVariantMap AsianCryptoPayment::cachedExchangeRates(const QString& baseCurrency) const {
+    return ExchangeRateCache::oriented(ExchangeRateCache::instance().rates(baseCurrency), ExchangeRateCache::CryptoPerFiat);
+}
+
+QList<Payment> AsianCryptoPayment::activePayments() const {
+    return m_payments.active();
+}
+
+Payment AsianCryptoPayment::findPaymentByOrderId(const QString& orderId) const {
+    const Payment* payment = m_payments.findByOrderId(orderId);
+    return payment ? *payment : Payment();
+}
+
+QList<Payment> AsianCryptoPayment::paymentsWithStatus(PaymentStatus status) const {
+    return m_payments.withStatus(status);
+}
+
+void AsianCryptoPayment::journal(JournalRecord type, const QByteArray& data) {
+    if (!m_journal) {
         return;
     }
     
-    QStringList currencies = cryptoCurrencies.isEmpty() ? m_supportedCryptocurrencies : cryptoCurrencies;
+    std::size_t length = static_cast<std::size_t>(data.size());
+    
+    // Rotate ahead of the record and copy active payments forward first, so
+    // they survive when the oldest segments are deleted. The copies hold
+    // the state from before this record; replay keeps the last record per
+    // payment, so the record must come after them.
+    if (!m_journal->reserve(length)) {
+        qWarning() << "Event journal append failed";
+        return;
+    }
+    if (m_journal->segmentSequence() != m_journalSegment) {
+        for (const Payment& payment : m_payments.active()) {
+            QByteArray snapshot = QJsonDocument(payment.toJson()).toJson(QJsonDocument::Compact);
+            m_journal->append(JournalPayment, QDateTime::currentMSecsSinceEpoch(), snapshot.constData(), static_cast<std::size_t>(snapshot.size()));
+        }
+        // The copies may fill the segment; the record still goes after them
+        if (!m_journal->reserve(length)) {
+            qWarning() << "Event journal append failed";
+            return;
+        }
+        m_journalSegment = m_journal->segmentSequence();
+    }
     
-    QString endpoint = "exchange-rates?base_currency=" + baseCurrency + "&currencies=" + currencies.join(",");
-    makeApiRequest(endpoint, "GET");
+    if (!m_journal->append(type, QDateTime::currentMSecsSinceEpoch(), data.constData(), length)) {
+        qWarning() << "Event journal append failed";
+    }
 }
 
-bool AsianCryptoPayment::verifyWebhookSignature(const QString& signature, const QString& body) {
-    if (!m_webhookConfig.contains("secret")) {
-        qWarning() << "Webhooks not initialized";
-        return false;
+quint64 AsianCryptoPayment::subscribe(const QString& paymentId, const PaymentCallback& callback) {
+    if (paymentId.isEmpty() || !callback) {
+        return 0;
     }
     
-    QString secret = m_webhookConfig["secret"].toString();
-    return m_securityModule->verifySignature(signature, body, secret);
+    Subscription subscription;
+    subscription.handle = m_nextSubscription++;
+    subscription.callback = callback;
+    m_subscriptions[paymentId].append(subscription);
+    m_subscriptionPayments.insert(subscription.handle, paymentId);
+    return subscription.handle;
 }
 
-bool AsianCryptoPayment::processWebhookEvent(const QJsonObject& event, const QString& signature) {
-    if (m_webhookConfig.isEmpty()) {
-        qWarning() << "Webhooks not initialized";
-        return false;
+void AsianCryptoPayment::unsubscribe(quint64 handle) {
+    QString paymentId = m_subscriptionPayments.take(handle);
+    auto it = m_subscriptions.find(paymentId);
+    if (it == m_subscriptions.end()) {
+        return;
     }
     
-    // Verify signature
-    QJsonDocument doc(event);
-    QString eventString = doc.toJson(QJsonDocument::Compact);
-    bool isValid = verifyWebhookSignature(signature, eventString);
+    QVector<Subscription>& subscriptions = it.value();
+    for (int i = 0; i < subscriptions.size(); ++i) {
+        if (subscriptions.at(i).handle == handle) {
+            subscriptions.remove(i);
+            break;
+        }
+    }
+    if (subscriptions.isEmpty()) {
+        m_subscriptions.erase(it);
+    }
+}
+
+void AsianCryptoPayment::notifySubscribers(const Payment& payment) {
+    auto it = m_subscriptions.constFind(payment.id());
+    if (it == m_subscriptions.constEnd()) {
+        return;
+    }
     
-    if (!isValid) {
-        qWarning() << "Invalid webhook signature";
-        return false;
+    // Iterate a copy: callbacks may subscribe or unsubscribe
+    QVector<Subscription> subscriptions = it.value();
+    for (const Subscription& subscription : subscriptions) {
+        if (m_subscriptionPayments.contains(subscription.handle)) {
+            subscription.callback(payment);
+        }
     }
     
-    // Process event
-    try {
-        QString eventType = event["type"].toString();
-        
-        if (event.contains("data") && event["data"].isObject()) {
-            Payment payment = Payment::fromJson(event["data"].toObject());
-            
-            if (eventType == "payment.created") {
-                emit paymentCreated(payment);
-            } else if (eventType == "payment.updated") {
-                emit paymentStatusUpdated(payment);
-            } else if (eventType == "payment.completed") {
-                emit paymentStatusUpdated(payment);
-                stopPaymentStatusCheck(payment.id());
-            } else if (eventType == "payment.cancelled") {
-                emit paymentStatusUpdated(payment);
-                stopPaymentStatusCheck(payment.id());
-            } else if (eventType == "payment.expired") {
-                emit paymentStatusUpdated(payment);
-                stopPaymentStatusCheck(payment.id());
-            }
+    if (isFinalPaymentStatus(payment.status())) {
+        for (const Subscription& subscription : m_subscriptions.take(payment.id())) {
+            m_subscriptionPayments.remove(subscription.handle);
         }
-        
-        return true;
-    } catch (const std::exception& e) {
-        qWarning() << "Failed to process webhook event:" << e.what();
-        return false;
     }
 }
 
@@ -212,41 +2278,52 @@ void AsianCryptoPayment::validatePaymentDetails(const PaymentDetails& paymentDet
     }
 }
 
-QNetworkRequest AsianCryptoPayment::createApiRequest(const QString& endpoint, const QJsonObject& data) {
+QNetworkRequest AsianCryptoPayment::createApiRequest(const QString& method, const QString& endpoint, const QByteArray& body) {
     QString url = m_apiEndpoint + "/" + endpoint;
     QNetworkRequest request(url);
     
-    QString timestamp = QString::number(QDateTime::currentMSecsSinceEpoch());
+    QByteArray timestamp = QByteArray::number(QDateTime::currentMSecsSinceEpoch());
+    QByteArray nonce = m_securityModule->nextNonce();
+    QByteArray path = "/" + endpoint.section('?', 0, 0).toUtf8();
     
     request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
     request.setRawHeader("X-Merchant-ID", m_merchantId.toUtf8());
-    request.setRawHeader("X-Timestamp", timestamp.toUtf8());
+    request.setRawHeader("X-Timestamp", timestamp);
+    request.setRawHeader("X-Nonce", nonce);
     request.setRawHeader("X-Test-Mode", m_testMode ? "true" : "false");
     request.setRawHeader("User-Agent", "AsianCryptoPayment-Qt/1.0.0");
     
+    // Signed as method + path + timestamp + nonce + body (see API reference)
+    QByteArray signature = m_securityModule->signRequest(method.toLatin1(), path, timestamp, nonce, body);
+    request.setRawHeader("X-Signature", signature);
+    
+    return request;
+}
+
+QNetworkReply* AsianCryptoPayment::makeApiRequest(const QString& endpoint, const QString& method, const QJsonObject& data) {
+    QByteArray body;
     if (!data.isEmpty()) {
-        QJsonDocument doc(data);
-        QString dataString = doc.toJson(QJsonDocument::Compact);
-        QString signature = m_securityModule->generateSignature(dataString, timestamp);
-        request.setRawHeader("X-Signature", signature.toUtf8());
+        body = QJsonDocument(data).toJson(QJsonDocument::Compact);
     }
     
-    return request;
+    return makeApiRequest(endpoint, method, body);
 }
 
-void AsianCryptoPayment::makeApiRequest(const QString& endpoint, const QString& method, const QJsonObject& data) {
-    QNetworkRequest request = createApiRequest(endpoint, data);
+QNetworkReply* AsianCryptoPayment::makeApiRequest(const QString& endpoint, const QString& method, const QByteArray& body) {
+    // The body is serialized once and the same bytes are signed and sent
+    QByteArray requestData = body;
+    if (requestData.isEmpty() && (method == "POST" || method == "PUT")) {
+        requestData = "{}";
+    }
+    
+    QNetworkRequest request = createApiRequest(method, endpoint, requestData);
     QNetworkReply* reply = nullptr;
     
     if (method == "GET") {
         reply = m_networkManager->get(request);
     } else if (method == "POST") {
-        QJsonDocument doc(data);
-        QByteArray requestData = doc.toJson(QJsonDocument::Compact);
         reply = m_networkManager->post(request, requestData);
     } else if (method == "PUT") {
-        QJsonDocument doc(data);
-        QByteArray requestData = doc.toJson(QJsonDocument::Compact);
         reply = m_networkManager->put(request, requestData);
     } else if (method == "DELETE") {
         reply = m_networkManager->deleteResource(request);
@@ -262,6 +2339,7 @@ void AsianCryptoPayment::makeApiRequest(const QString& endpoint, const QString&
             context.id = endpoint.mid(9);
         } else if (endpoint.startsWith("payments") && method == "GET") {
             context.type = RequestType::GetPayments;
+            m_listBudget.take(QDateTime::currentMSecsSinceEpoch());
         } else if (endpoint.contains("/cancel")) {
             context.type = RequestType::CancelPayment;
             context.id = endpoint.mid(9, endpoint.indexOf("/cancel") - 9);
@@ -271,6 +2349,8 @@ void AsianCryptoPayment::makeApiRequest(const QString& endpoint, const QString&
         
         m_pendingRequests[reply] = context;
     }
+    
+    return reply;
 }
 
 void AsianCryptoPayment::onNetworkReply(QNetworkReply* reply) {
@@ -282,15 +2362,88 @@ void AsianCryptoPayment::onNetworkReply(QNetworkReply* reply) {
     RequestContext context = m_pendingRequests.take(reply);
     
     if (reply->error() != QNetworkReply::NoError) {
+        if (context.type == RequestType::SyncPayments) {
+            m_sync.running = false;
+        } else if (context.type == RequestType::ListPayments && context.listing == m_listing.generation) {
+            cancelPaymentListing();
+        } else if (context.type == RequestType::GetExchangeRates) {
+            ExchangeRateCache::instance().endRefresh(context.id);
+        }
         emit error(reply->error(), reply->errorString());
         reply->deleteLater();
         return;
     }
     
     QByteArray responseData = reply->readAll();
+    
+    if (context.type == RequestType::GetPayments || context.type == RequestType::SyncPayments
+            || context.type == RequestType::ListPayments) {
+        // The server's count wins when it is stricter than ours
+        if (reply->hasRawHeader("X-RateLimit-Remaining")) {
+            m_listBudget.limit(reply->rawHeader("X-RateLimit-Remaining").toInt(),
+                    reply->rawHeader("X-RateLimit-Reset").toLongLong() * 1000, QDateTime::currentMSecsSinceEpoch());
+        }
+        
+        // Index the page in one pass; fields are decoded only when read
+        QList<LazyPayment> lazyPayments;
+        int total = 0;
+        
+        if (!LazyPayment::indexPage(responseData, lazyPayments, total)) {
+            if (context.type == RequestType::SyncPayments) {
+                m_sync.running = false;
+            } else if (context.type == RequestType::ListPayments && context.listing == m_listing.generation) {
+                cancelPaymentListing();
+            }
+            emit error(500, "Invalid JSON response");
+            reply->deleteLater();
+            return;
+        }
+        
+        if (context.type == RequestType::SyncPayments) {
+            handleSyncPage(lazyPayments, total);
+            reply->deleteLater();
+            return;
+        }
+        
+        if (context.type == RequestType::ListPayments) {
+            handleListingPage(context, lazyPayments, total);
+            reply->deleteLater();
+            return;
+        }
+        
+        if (m_ledger) {
+            storePaymentPage(lazyPayments);
+            if (context.syncRange && lazyPayments.size() >= total) {
+                m_ledger->markSynced(context.rangeFromMs, context.rangeToMs);
+                m_rangeMarkedAtMs = QDateTime::currentMSecsSinceEpoch();
+            }
+            m_ledger->sync();
+        }
+        
+        emit lazyPaymentsRetrieved(lazyPayments, total);
+        
+        // Decode eagerly only for listeners of the full payment list
+        if (isSignalConnected(QMetaMethod::fromSignal(&AsianCryptoPayment::paymentsRetrieved))) {
+            QList<Payment> payments;
+            payments.reserve(lazyPayments.size());
+            
+            for (const LazyPayment& payment : lazyPayments) {
+                payments.append(payment.toPayment());
+            }
+            
+            emit paymentsRetrieved(payments, total);
+        }
+        
+        reply->deleteLater();
+        return;
+    }
+    
     QJsonDocument doc = QJsonDocument::fromJson(responseData);
     
     if (doc.isNull() || !doc.isObject()) {
+        if (context.type == RequestType::GetExchangeRates) {
+            ExchangeRateCache::instance().endRefresh(context.id);
+        }
         emit error(500, "Invalid JSON response");
         reply->deleteLater();
         return;
@@ -302,52 +2455,80 @@ void AsianCryptoPayment::onNetworkReply(QNetworkReply* reply) {
         switch (context.type) {
             case RequestType::CreatePayment: {
                 Payment payment = Payment::fromJson(response);
-                m_activePayments[payment.id()] = payment;
+                trackPayment(payment);
+                cachePayment(payment);
+                journal(JournalPayment, responseData);
                 startPaymentStatusCheck(payment);
                 emit paymentCreated(payment);
+                if (context.quote.isValid()) {
+                    reconcileQuote(payment, context.quote);
+                }
                 break;
             }
             case RequestType::GetPayment: {
                 Payment payment = Payment::fromJson(response);
-                emit paymentRetrieved(payment);
-                break;
-            }
-            case RequestType::GetPayments: {
-                QList<Payment> payments;
-                int total = response["total"].toInt();
-                
-                if (response.contains("payments") && response["payments"].isArray()) {
-                    QJsonArray paymentsArray = response["payments"].toArray();
-                    
-                    for (const QJsonValue& value : paymentsArray) {
-                        if (value.isObject()) {
-                            payments.append(Payment::fromJson(value.toObject()));
-                        }
+                m_webhookSequencer.observe(payment);
+                bool changed = emitPaymentDelta(payment);
+                cachePayment(payment);
+                if (m_payments.contains(payment.id())) {
+                    trackPayment(payment);
+                    journal(JournalPayment, responseData);
+                    if (isFinalPaymentStatus(payment.status())) {
+                        stopPaymentStatusCheck(payment.id());
                     }
                 }
-                
-                emit paymentsRetrieved(payments, total);
+                if (changed) {
+                    notifySubscribers(payment);
+                }
+                if (changed || !context.poll) {
+                    emit paymentRetrieved(payment);
+                }
                 break;
             }
             case RequestType::CancelPayment: {
                 Payment payment = Payment::fromJson(response);
+                m_webhookSequencer.observe(payment);
+                bool changed = emitPaymentDelta(payment);
+                cachePayment(payment);
+                if (m_payments.contains(payment.id())) {
+                    trackPayment(payment);
+                }
+                if (changed) {
+                    notifySubscribers(payment);
+                }
+                journal(JournalPayment, responseData);
                 stopPaymentStatusCheck(payment.id());
                 emit paymentCancelled(payment);
                 break;
             }
             case RequestType::GetExchangeRates: {
-                QString baseCurrency = response["base_currency"].toString();
+                QString baseCurrency = response.contains("base_currency") ? response["base_currency"].toString() : response["base"].toString();
                 QVariantMap rates;
                 
                 if (response.contains("rates") && response["rates"].isObject()) {
                     QJsonObject ratesObject = response["rates"].toObject();
                     
                     for (auto it = ratesObject.begin(); it != ratesObject.end(); ++it) {
-                        rates[it.key()] = it.value().toString().toDouble();
+                        double rate = ExchangeRateCache::parseRate(it.value());
+                        if (rate > 0.0) {
+                            rates[it.key()] = rate;
+                        }
                     }
                 }
                 
-                emit exchangeRatesRetrieved(baseCurrency, rates);
+                if (baseCurrency.isEmpty()) {
+                    baseCurrency = context.id;
+                }
+                // This endpoint quotes currency units per one unit of the base
+                ExchangeRateCache& cache = ExchangeRateCache::instance();
+                qint64 now = QDateTime::currentMSecsSinceEpoch();
+                cache.store(baseCurrency, rates, now, ExchangeRateCache::CryptoPerFiat);
+                cache.endRefresh(context.id);
+                m_snapshotDirty = true;
+                
+                if (!context.refreshOnly) {
+                    emit exchangeRatesRetrieved(baseCurrency, rates);
+                }
                 break;
             }
             default:
@@ -380,26 +2561,64 @@ void AsianCryptoPayment::onQrCodeDownloaded(QNetworkReply* reply) {
 }
 
 void AsianCryptoPayment::startPaymentStatusCheck(const Payment& payment) {
-    if (m_paymentTimers.contains(payment.id())) {
+    if (m_payments.timer(payment.id())) {
         return;
     }
+    if (!m_payments.contains(payment.id())) {
+        trackPayment(payment);
+    }
     
     QTimer* timer = new QTimer(this);
-    m_paymentTimers[payment.id()] = timer;
+    m_payments.setTimer(payment.id(), timer);
     
     connect(timer, &QTimer::timeout, this, &AsianCryptoPayment::checkPaymentStatus);
     timer->setProperty("payment_id", payment.id());
-    timer->start(10000); // Check every 10 seconds
+    timer->start(statusCheckIntervalMs(payment));
+}
+
+int AsianCryptoPayment::statusCheckIntervalMs(const Payment& payment) const {
+    // Every 10 seconds at the default quote validity, down to 2 seconds as the pair gets volatile
+    return qBound(2000, quoteValidityMs(payment.currency(), payment.cryptoCurrency()) / 6, 10000);
 }
 
 void AsianCryptoPayment::stopPaymentStatusCheck(const QString& paymentId) {
-    if (m_paymentTimers.contains(paymentId)) {
-        QTimer* timer = m_paymentTimers.take(paymentId);
+    if (QTimer* timer = m_payments.takeTimer(paymentId)) {
         timer->stop();
         timer->deleteLater();
     }
     
-    m_activePayments.remove(paymentId);
+    // Final payments stay for local lookups until the store evicts them
+    const Payment* payment = m_payments.find(paymentId);
+    if (payment && !isFinalPaymentStatus(payment->status())) {
+        m_payments.remove(paymentId);
+        armExpiryTimer();
+    }
+    m_snapshotDirty = true;
+}
+
+void AsianCryptoPayment::trackPayment(const Payment& payment) {
+    m_payments.upsert(payment);
+    armExpiryTimer();
+    m_snapshotDirty = true;
+}
+
+void AsianCryptoPayment::armExpiryTimer() {
+    qint64 deadline = m_payments.nextExpiry();
+    if (deadline == ActivePaymentStore::NoExpiry) {
+        m_expiryTimer->stop();
+        return;
+    }
+    
+    // Give the server a moment to record the expiry before asking
+    qint64 delay = deadline - QDateTime::currentMSecsSinceEpoch() + 1000;
+    m_expiryTimer->start(static_cast<int>(qBound<qint64>(0, delay, std::numeric_limits<int>::max())));
+}
+
+void AsianCryptoPayment::checkExpiredPayments() {
+    for (const QString& paymentId : m_payments.takeExpired(QDateTime::currentMSecsSinceEpoch())) {
+        fetchPayment(paymentId, true);
+    }
+    armExpiryTimer();
 }
 
 void AsianCryptoPayment::checkPaymentStatus() {
@@ -413,7 +2632,12 @@ void AsianCryptoPayment::checkPaymentStatus() {
         return;
     }
     
-    getPayment(paymentId);
+    if (const Payment* payment = m_payments.find(paymentId)) {
+        timer->setInterval(statusCheckIntervalMs(*payment));
+    }
+    
+    // Status checks exist to notice changes, so never answer them from the cache
+    fetchPayment(paymentId, true);
 }
 
 } // namespace AsianCryptoPay
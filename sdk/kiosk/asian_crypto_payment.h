@@ -14,6 +14,14 @@
 #include <QObject>
 #include <QString>
 #include <QVariantMap>
+#include <QStringList>
+#include <QMap>
+#include <QHash>
+#include <QCache>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QVector>
+#include <QBitArray>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QJsonDocument>
@@ -29,7 +37,27 @@
 #include <QQmlEngine>
 #include <QJSEngine>
 #include <QDebug>
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <stdexcept>
+#include <limits>
+
+#include "json_scanner.h"
+#include "json_writer.h"
+#include "payment_metadata.h"
+#include "sha256.h"
+#include "sha256_multibuffer.h"
+#include "hex_codec.h"
+#include "replay_protection.h"
+#include "sharded_worker_pool.h"
+#include "event_journal.h"
+#include "payment_ledger.h"
+#include "token_bucket.h"
+#include "published_value.h"
+#include "snapshot_file.h"
+#include "rate_table.h"
+#include "rate_history.h"
 
 namespace AsianCryptoPay {
 
@@ -124,6 +152,15 @@ inline PaymentStatus stringToPaymentStatus(const QString& status) {
     return PaymentStatus::Created;
 }
 
+/**
+ * @brief Check if a payment status is final
+ * @param status Payment status
+ * @return Whether the payment can no longer change
+ */
+inline bool isFinalPaymentStatus(PaymentStatus status) {
+    return status == PaymentStatus::Completed || status == PaymentStatus::Cancelled || status == PaymentStatus::Expired;
+}
+
 /**
  * @brief Payment details class
  */
@@ -240,10 +277,31 @@ public:
      * @return Reference to this object for method chaining
      */
     PaymentDetails& setMetadata(const QVariantMap& metadata) {
+        m_metadata = PaymentMetadata::fromVariantMap(metadata);
+        return *this;
+    }
+    
+    /**
+     * @brief Set metadata
+     * @param metadata Additional metadata
+     * @return Reference to this object for method chaining
+     */
+    PaymentDetails& setMetadata(const PaymentMetadata& metadata) {
         m_metadata = metadata;
         return *this;
     }
     
+    /**
+     * @brief Add a metadata entry
+     * @param key Metadata key
+     * @param value Metadata value
+     * @return Reference to this object for method chaining
+     */
+    PaymentDetails& addMetadata(const QString& key, const QString& value) {
+        m_metadata.insert(key, value);
+        return *this;
+    }
+    
     /**
      * @brief Get payment amount
      * @return Payment amount
@@ -308,7 +366,13 @@ public:
      * @brief Get metadata
      * @return Metadata
      */
-    QVariantMap metadata() const { return m_metadata; }
+    QVariantMap metadata() const { return m_metadata.toVariantMap(); }
+    
+    /**
+     * @brief Get metadata without building a variant map
+     * @return Compact metadata
+     */
+    const PaymentMetadata& compactMetadata() const { return m_metadata; }
     
     /**
      * @brief Convert to JSON object
@@ -346,12 +410,52 @@ public:
         }
         
         if (!m_metadata.isEmpty()) {
-            json["metadata"] = QJsonObject::fromVariantMap(m_metadata);
+            json["metadata"] = m_metadata.toJsonObject();
         }
         
         return json;
     }
     
+    /**
+     * @brief Write members into an open JSON object
+     * @param writer Request writer
+     */
+    void writeJson(JsonWriter& writer) const {
+        writer.amountMember("amount", m_amount);
+        writer.member("currency", m_currency);
+        writer.member("crypto_currency", m_cryptoCurrency);
+        writer.member("description", m_description);
+        
+        if (!m_orderId.isEmpty()) {
+            writer.member("order_id", m_orderId);
+        }
+        
+        if (!m_customerEmail.isEmpty()) {
+            writer.member("customer_email", m_customerEmail);
+        }
+        
+        if (!m_customerName.isEmpty()) {
+            writer.member("customer_name", m_customerName);
+        }
+        
+        if (!m_callbackUrl.isEmpty()) {
+            writer.member("callback_url", m_callbackUrl);
+        }
+        
+        if (!m_successUrl.isEmpty()) {
+            writer.member("success_url", m_successUrl);
+        }
+        
+        if (!m_cancelUrl.isEmpty()) {
+            writer.member("cancel_url", m_cancelUrl);
+        }
+        
+        if (!m_metadata.isEmpty()) {
+            writer.key("metadata");
+            m_metadata.writeJson(writer);
+        }
+    }
+    
 private:
     double m_amount = 0.0;
     QString m_currency;
@@ -363,7 +467,7 @@ private:
     QString m_callbackUrl;
     QString m_successUrl;
     QString m_cancelUrl;
-    QVariantMap m_metadata;
+    PaymentMetadata m_metadata;
 };
 
 /**
@@ -403,7 +507,7 @@ public:
         payment.m_expiresAt = QDateTime::fromString(json["expires_at"].toString(), Qt::ISODate);
         
         if (json.contains("metadata") && json["metadata"].isObject()) {
-            payment.m_metadata = json["metadata"].toObject().toVariantMap();
+            payment.m_metadata = PaymentMetadata::fromJsonObject(json["metadata"].toObject());
         }
         
         return payment;
@@ -515,7 +619,13 @@ public:
      * @brief Get metadata
      * @return Metadata
      */
-    QVariantMap metadata() const { return m_metadata; }
+    QVariantMap metadata() const { return m_metadata.toVariantMap(); }
+    
+    /**
+     * @brief Get metadata without building a variant map
+     * @return Compact metadata
+     */
+    const PaymentMetadata& compactMetadata() const { return m_metadata; }
     
     /**
      * @brief Check if payment is completed
@@ -565,7 +675,7 @@ public:
         json["expires_at"] = m_expiresAt.toString(Qt::ISODate);
         
         if (!m_metadata.isEmpty()) {
-            json["metadata"] = QJsonObject::fromVariantMap(m_metadata);
+            json["metadata"] = m_metadata.toJsonObject();
         }
         
         return json;
@@ -577,4 +687,2358 @@ private:
     double m_amount = 0.0;
     QString m_currency;
     double m_cryptoAmount = 0.0;
-    QString m_cryptoCurre<response clipped><NOTE>To save on context only part of this file has been shown to you. You should retry this tool after you have searched inside the file with `grep -n` in order to find the line numbers of what you are looking for.</NOTE>
\ No newline at end of file
+    QString m_cryptoCurrency;
+    QString m_description;
+    QString m_orderId;
+    QString m_customerEmail;
+    QString m_customerName;
+    QString m_address;
+    QString m_qrCodeUrl;
+    PaymentStatus m_status = PaymentStatus::Created;
+    QDateTime m_createdAt;
+    QDateTime m_updatedAt;
+    QDateTime m_expiresAt;
+    PaymentMetadata m_metadata;
+    
+    friend class LazyPayment;
+};
+
+/**
+ * @brief Payment decoded lazily from a retained response buffer
+ *
+ * Indexing records only the byte range of each known field; a field is
+ * decoded the first time it is read and cached afterwards. The response
+ * buffer is implicitly shared, so a page of lazy payments holds a single
+ * copy of the bytes. Like other value types, an instance must not be read
+ * from several threads at once without synchronization.
+ */
+class LazyPayment {
+public:
+    /**
+     * @brief Indexed payment fields
+     */
+    enum Field {
+        IdField,
+        MerchantIdField,
+        AmountField,
+        CurrencyField,
+        CryptoAmountField,
+        CryptoCurrencyField,
+        DescriptionField,
+        OrderIdField,
+        CustomerEmailField,
+        CustomerNameField,
+        AddressField,
+        QrCodeUrlField,
+        StatusField,
+        CreatedAtField,
+        UpdatedAtField,
+        ExpiresAtField,
+        MetadataField,
+        FieldCount
+    };
+    
+    /**
+     * @brief Constructor
+     */
+    LazyPayment() {}
+    
+    /**
+     * @brief Index a single payment object
+     * @param buffer Response buffer, retained by the payment
+     * @param span Range of the payment object inside the buffer (whole buffer if invalid)
+     * @return Lazy payment, invalid if the object could not be indexed
+     */
+    static LazyPayment fromBuffer(const QByteArray& buffer, const JsonSpan& span = JsonSpan());
+    
+    /**
+     * @brief Index a payment list response in a single pass
+     * @param buffer Response buffer with "payments" and "total" members
+     * @param payments Receives the indexed payments
+     * @param total Receives the total number of matching payments
+     * @return Whether the response was well-formed
+     */
+    static bool indexPage(const QByteArray& buffer, QList<LazyPayment>& payments, int& total);
+    
+    /**
+     * @brief Check if the payment was indexed successfully
+     * @return Whether the payment is valid
+     */
+    bool isValid() const { return m_valid; }
+    
+    /**
+     * @brief Check if a field is present in the source object
+     * @param field Field
+     * @return Whether the field is present
+     */
+    bool hasField(Field field) const { return m_spans[field].isValid(); }
+    
+    /**
+     * @brief Get payment ID
+     * @return Payment ID
+     */
+    QString id() const { return stringField(IdField); }
+    
+    /**
+     * @brief Get merchant ID
+     * @return Merchant ID
+     */
+    QString merchantId() const { return stringField(MerchantIdField); }
+    
+    /**
+     * @brief Get payment amount
+     * @return Payment amount
+     */
+    double amount() const { return numberField(AmountField); }
+    
+    /**
+     * @brief Get fiat currency
+     * @return Fiat currency code
+     */
+    QString currency() const { return stringField(CurrencyField); }
+    
+    /**
+     * @brief Get cryptocurrency amount
+     * @return Cryptocurrency amount
+     */
+    double cryptoAmount() const { return numberField(CryptoAmountField); }
+    
+    /**
+     * @brief Get cryptocurrency
+     * @return Cryptocurrency code
+     */
+    QString cryptoCurrency() const { return stringField(CryptoCurrencyField); }
+    
+    /**
+     * @brief Get payment description
+     * @return Payment description
+     */
+    QString description() const { return stringField(DescriptionField); }
+    
+    /**
+     * @brief Get merchant order ID
+     * @return Merchant order ID
+     */
+    QString orderId() const { return stringField(OrderIdField); }
+    
+    /**
+     * @brief Get customer email
+     * @return Customer email
+     */
+    QString customerEmail() const { return stringField(CustomerEmailField); }
+    
+    /**
+     * @brief Get customer name
+     * @return Customer name
+     */
+    QString customerName() const { return stringField(CustomerNameField); }
+    
+    /**
+     * @brief Get cryptocurrency address
+     * @return Cryptocurrency address
+     */
+    QString address() const { return stringField(AddressField); }
+    
+    /**
+     * @brief Get QR code URL
+     * @return QR code URL
+     */
+    QString qrCodeUrl() const { return stringField(QrCodeUrlField); }
+    
+    /**
+     * @brief Get payment status
+     * @return Payment status
+     */
+    PaymentStatus status() const;
+    
+    /**
+     * @brief Get creation time
+     * @return Creation time
+     */
+    QDateTime createdAt() const { return dateField(CreatedAtField); }
+    
+    /**
+     * @brief Get last update time
+     * @return Last update time
+     */
+    QDateTime updatedAt() const { return dateField(UpdatedAtField); }
+    
+    /**
+     * @brief Get expiration time
+     * @return Expiration time
+     */
+    QDateTime expiresAt() const { return dateField(ExpiresAtField); }
+    
+    /**
+     * @brief Get metadata
+     * @return Metadata
+     */
+    QVariantMap metadata() const { return compactMetadata().toVariantMap(); }
+    
+    /**
+     * @brief Get metadata without building a variant map
+     * @return Compact metadata
+     */
+    const PaymentMetadata& compactMetadata() const;
+    
+    /**
+     * @brief Get the raw JSON bytes of the payment object
+     * @return Raw bytes, sharing the retained buffer where possible
+     */
+    QByteArray rawJson() const;
+    
+    /**
+     * @brief Decode every field into an eager payment
+     * @return Payment object
+     */
+    Payment toPayment() const;
+    
+private:
+    QString stringField(Field field) const;
+    double numberField(Field field) const;
+    QDateTime dateField(Field field) const;
+    bool isDecoded(Field field) const { return (m_decoded & (1u << field)) != 0; }
+    void markDecoded(Field field) const { m_decoded |= (1u << field); }
+    
+    QByteArray m_buffer;
+    JsonSpan m_object;
+    JsonSpan m_spans[FieldCount];
+    bool m_valid = false;
+    
+    // Decoded values, filled on first access
+    mutable quint32 m_decoded = 0;
+    mutable QString m_strings[FieldCount];
+    mutable double m_numbers[2] = {0.0, 0.0};
+    mutable QDateTime m_dates[3];
+    mutable PaymentMetadata m_metadata;
+    mutable PaymentStatus m_status = PaymentStatus::Created;
+};
+
+/**
+ * @brief Fields that changed between two versions of a payment
+ *
+ * Carries a bitmask over LazyPayment::Field and the new value of each
+ * changed field only, so listeners can update just what changed.
+ */
+class PaymentDelta {
+public:
+    /**
+     * @brief Constructor
+     */
+    PaymentDelta() {}
+    
+    /**
+     * @brief Compare two versions of a payment
+     * @param before Version previously known
+     * @param after Version just received
+     * @return Changed fields of after; empty if nothing changed
+     */
+    static PaymentDelta diff(const Payment& before, const Payment& after);
+    
+    /**
+     * @brief Get payment ID
+     * @return Payment ID
+     */
+    QString paymentId() const { return m_paymentId; }
+    
+    /**
+     * @brief Get changed fields
+     * @return Bit (1 << field) is set for each changed LazyPayment::Field
+     */
+    quint32 changedFields() const { return m_fields; }
+    
+    /**
+     * @brief Check if nothing changed
+     * @return Whether no field changed
+     */
+    bool isEmpty() const { return m_fields == 0; }
+    
+    /**
+     * @brief Check if a field changed
+     * @param field Payment field
+     * @return Whether the field changed
+     */
+    bool contains(LazyPayment::Field field) const { return (m_fields & (1u << field)) != 0; }
+    
+    /**
+     * @brief Get the new value of a changed field
+     *
+     * Strings, numbers, times and metadata come as the QVariant of the
+     * matching Payment getter; the status comes as its API string.
+     *
+     * @param field Payment field
+     * @return New value, invalid if the field did not change
+     */
+    QVariant value(LazyPayment::Field field) const;
+    
+    /**
+     * @brief Get the new status
+     * @return New status; only meaningful if contains(LazyPayment::StatusField)
+     */
+    PaymentStatus status() const { return stringToPaymentStatus(value(LazyPayment::StatusField).toString()); }
+    
+private:
+    QString m_paymentId;
+    quint32 m_fields = 0;
+    QVector<QVariant> m_values;     // One per changed field, in field order
+};
+
+/**
+ * @brief Get the number of decimals a cryptocurrency amount is quoted with
+ * @param cryptoCurrency Cryptocurrency code
+ * @return Decimal places
+ */
+inline int cryptoDecimals(const QString& cryptoCurrency) {
+    if (cryptoCurrency == "USDT" || cryptoCurrency == "USDC") {
+        return 6;
+    }
+    return 8;
+}
+
+/**
+ * @brief Crypto amount computed locally from cached exchange rates
+ *
+ * Shown to the customer while createPayment() is in flight; the amount in
+ * the created payment is authoritative.
+ */
+class PaymentQuote {
+public:
+    /**
+     * @brief Constructor
+     */
+    PaymentQuote() {}
+    
+    /**
+     * @brief Check if a quote could be computed
+     * @return Whether a usable exchange rate was cached
+     */
+    bool isValid() const { return m_valid; }
+    
+    /**
+     * @brief Get fiat amount
+     * @return Amount before fees
+     */
+    double amount() const { return m_amount; }
+    
+    /**
+     * @brief Get fiat currency
+     * @return Currency code
+     */
+    QString currency() const { return m_currency; }
+    
+    /**
+     * @brief Get cryptocurrency
+     * @return Cryptocurrency code
+     */
+    QString cryptoCurrency() const { return m_cryptoCurrency; }
+    
+    /**
+     * @brief Get exchange rate used
+     * @return Fiat per unit of cryptocurrency
+     */
+    double rate() const { return m_rate; }
+    
+    /**
+     * @brief Get fee
+     * @return Fee in fiat
+     */
+    double fee() const { return m_fee; }
+    
+    /**
+     * @brief Get crypto amount
+     * @return Amount plus fee in cryptocurrency, rounded to cryptoDecimals()
+     */
+    double cryptoAmount() const { return m_cryptoAmount; }
+    
+    /**
+     * @brief Get when the rate was fetched
+     * @return Milliseconds since epoch
+     */
+    qint64 rateTimeMs() const { return m_rateTimeMs; }
+    
+    /**
+     * @brief Get when the quote stops being shown
+     * @return Milliseconds since epoch
+     */
+    qint64 validUntilMs() const { return m_validUntilMs; }
+    
+    /**
+     * @brief Check if the rate was older than the cache TTL
+     * @return Whether the quote used a stale rate
+     */
+    bool isStale() const { return m_stale; }
+    
+private:
+    friend class AsianCryptoPayment;
+    
+    bool m_valid = false;
+    bool m_stale = false;
+    double m_amount = 0.0;
+    QString m_currency;
+    QString m_cryptoCurrency;
+    double m_rate = 0.0;
+    double m_fee = 0.0;
+    double m_cryptoAmount = 0.0;
+    qint64 m_rateTimeMs = 0;
+    qint64 m_validUntilMs = 0;
+};
+
+/**
+ * @brief How far local quotes were from the amounts the server charged
+ *
+ * Drift is (server amount - quoted amount) / server amount.
+ */
+struct QuoteDriftStats {
+    int count = 0;              ///< Quotes reconciled
+    double lastDrift = 0.0;
+    double meanAbsDrift = 0.0;
+    double maxAbsDrift = 0.0;
+};
+
+/**
+ * @brief Payment list filters class
+ */
+class PaymentFilters {
+public:
+    /**
+     * @brief Constructor
+     */
+    PaymentFilters() {}
+    
+    /**
+     * @brief Set payment status filter
+     * @param status Payment status
+     * @return Reference to this object for method chaining
+     */
+    PaymentFilters& setStatus(PaymentStatus status) {
+        m_status = status;
+        m_hasStatus = true;
+        return *this;
+    }
+    
+    /**
+     * @brief Set start date filter
+     * @param startDate Earliest creation time to include
+     * @return Reference to this object for method chaining
+     */
+    PaymentFilters& setStartDate(const QDateTime& startDate) {
+        m_startDate = startDate;
+        return *this;
+    }
+    
+    /**
+     * @brief Set end date filter
+     * @param endDate Latest creation time to include
+     * @return Reference to this object for method chaining
+     */
+    PaymentFilters& setEndDate(const QDateTime& endDate) {
+        m_endDate = endDate;
+        return *this;
+    }
+    
+    /**
+     * @brief Set fiat currency filter
+     * @param currency Fiat currency code
+     * @return Reference to this object for method chaining
+     */
+    PaymentFilters& setCurrency(const QString& currency) {
+        m_currency = currency;
+        return *this;
+    }
+    
+    /**
+     * @brief Set cryptocurrency filter
+     * @param cryptoCurrency Cryptocurrency code
+     * @return Reference to this object for method chaining
+     */
+    PaymentFilters& setCryptoCurrency(const QString& cryptoCurrency) {
+        m_cryptoCurrency = cryptoCurrency;
+        return *this;
+    }
+    
+    /**
+     * @brief Set update time filter
+     *
+     * Servers that do not support it return payments regardless of their
+     * update time.
+     *
+     * @param updatedSince Earliest update time to include
+     * @return Reference to this object for method chaining
+     */
+    PaymentFilters& setUpdatedSince(const QDateTime& updatedSince) {
+        m_updatedSince = updatedSince;
+        return *this;
+    }
+    
+    /**
+     * @brief Set page size
+     * @param limit Maximum number of payments to return
+     * @return Reference to this object for method chaining
+     */
+    PaymentFilters& setLimit(int limit) {
+        m_limit = limit;
+        return *this;
+    }
+    
+    /**
+     * @brief Set page offset
+     * @param offset Number of payments to skip
+     * @return Reference to this object for method chaining
+     */
+    PaymentFilters& setOffset(int offset) {
+        m_offset = offset;
+        return *this;
+    }
+    
+    /**
+     * @brief Check if a status filter is set
+     * @return Whether a status filter is set
+     */
+    bool hasStatus() const { return m_hasStatus; }
+    
+    /**
+     * @brief Get payment status filter
+     * @return Payment status
+     */
+    PaymentStatus status() const { return m_status; }
+    
+    /**
+     * @brief Get start date filter
+     * @return Start date
+     */
+    QDateTime startDate() const { return m_startDate; }
+    
+    /**
+     * @brief Get end date filter
+     * @return End date
+     */
+    QDateTime endDate() const { return m_endDate; }
+    
+    /**
+     * @brief Get fiat currency filter
+     * @return Fiat currency code
+     */
+    QString currency() const { return m_currency; }
+    
+    /**
+     * @brief Get cryptocurrency filter
+     * @return Cryptocurrency code
+     */
+    QString cryptoCurrency() const { return m_cryptoCurrency; }
+    
+    /**
+     * @brief Get update time filter
+     * @return Earliest update time, invalid if not set
+     */
+    QDateTime updatedSince() const { return m_updatedSince; }
+    
+    /**
+     * @brief Get page size
+     * @return Page size
+     */
+    int limit() const { return m_limit; }
+    
+    /**
+     * @brief Get page offset
+     * @return Page offset
+     */
+    int offset() const { return m_offset; }
+    
+    /**
+     * @brief Build URL query string
+     * @return Query string without leading '?'
+     */
+    QString buildQueryString() const {
+        QStringList params;
+        
+        if (m_hasStatus) {
+            params << "status=" + paymentStatusToString(m_status);
+        }
+        
+        if (m_startDate.isValid()) {
+            params << "start_date=" + QString::fromUtf8(QUrl::toPercentEncoding(m_startDate.toString(Qt::ISODate)));
+        }
+        
+        if (m_endDate.isValid()) {
+            params << "end_date=" + QString::fromUtf8(QUrl::toPercentEncoding(m_endDate.toString(Qt::ISODate)));
+        }
+        
+        if (!m_currency.isEmpty()) {
+            params << "currency=" + m_currency;
+        }
+        
+        if (!m_cryptoCurrency.isEmpty()) {
+            params << "crypto_currency=" + m_cryptoCurrency;
+        }
+        
+        if (m_updatedSince.isValid()) {
+            params << "updated_since=" + QString::fromUtf8(QUrl::toPercentEncoding(m_updatedSince.toString(Qt::ISODate)));
+        }
+        
+        if (m_limit > 0) {
+            params << "limit=" + QString::number(m_limit);
+        }
+        
+        if (m_offset > 0) {
+            params << "offset=" + QString::number(m_offset);
+        }
+        
+        return params.join("&");
+    }
+    
+private:
+    bool m_hasStatus = false;
+    PaymentStatus m_status = PaymentStatus::Created;
+    QDateTime m_startDate;
+    QDateTime m_endDate;
+    QString m_currency;
+    QString m_cryptoCurrency;
+    QDateTime m_updatedSince;
+    int m_limit = 0;
+    int m_offset = 0;
+};
+
+/**
+ * @brief Country-specific regulatory compliance module
+ */
+class CountryModule {
+public:
+    /**
+     * @brief Destructor
+     */
+    virtual ~CountryModule() {}
+    
+    /**
+     * @brief Get country code
+     * @return Country code
+     */
+    virtual CountryCode countryCode() const = 0;
+    
+    /**
+     * @brief Get country name
+     * @return Country name
+     */
+    virtual QString countryName() const = 0;
+    
+    /**
+     * @brief Get local fiat currency
+     * @return Fiat currency code
+     */
+    virtual QString localCurrency() const = 0;
+    
+    /**
+     * @brief Get daily transaction limit
+     * @return Daily limit in local currency
+     */
+    virtual double dailyLimit() const = 0;
+    
+    /**
+     * @brief Validate payment against country regulations
+     * @param paymentDetails Payment details
+     * @throws std::invalid_argument if the payment is not allowed
+     */
+    virtual void validatePayment(const PaymentDetails& paymentDetails) const {
+        if (paymentDetails.currency() == localCurrency() && paymentDetails.amount() > dailyLimit()) {
+            throw std::invalid_argument("Payment amount exceeds the daily limit for " + countryName().toStdString());
+        }
+    }
+};
+
+/**
+ * @brief Malaysia compliance module (Securities Commission Malaysia, Bank Negara Malaysia)
+ */
+class MalaysiaModule : public CountryModule {
+public:
+    CountryCode countryCode() const override { return CountryCode::Malaysia; }
+    QString countryName() const override { return "Malaysia"; }
+    QString localCurrency() const override { return "MYR"; }
+    double dailyLimit() const override { return 50000.0; }
+};
+
+/**
+ * @brief Singapore compliance module (Monetary Authority of Singapore)
+ */
+class SingaporeModule : public CountryModule {
+public:
+    CountryCode countryCode() const override { return CountryCode::Singapore; }
+    QString countryName() const override { return "Singapore"; }
+    QString localCurrency() const override { return "SGD"; }
+    double dailyLimit() const override { return 100000.0; }
+};
+
+/**
+ * @brief Indonesia compliance module (Bappebti, Bank Indonesia)
+ */
+class IndonesiaModule : public CountryModule {
+public:
+    CountryCode countryCode() const override { return CountryCode::Indonesia; }
+    QString countryName() const override { return "Indonesia"; }
+    QString localCurrency() const override { return "IDR"; }
+    double dailyLimit() const override { return 100000000.0; }
+};
+
+/**
+ * @brief Thailand compliance module (Securities and Exchange Commission Thailand)
+ */
+class ThailandModule : public CountryModule {
+public:
+    CountryCode countryCode() const override { return CountryCode::Thailand; }
+    QString countryName() const override { return "Thailand"; }
+    QString localCurrency() const override { return "THB"; }
+    double dailyLimit() const override { return 1000000.0; }
+};
+
+/**
+ * @brief Brunei compliance module (Autoriti Monetari Brunei Darussalam)
+ */
+class BruneiModule : public CountryModule {
+public:
+    CountryCode countryCode() const override { return CountryCode::Brunei; }
+    QString countryName() const override { return "Brunei Darussalam"; }
+    QString localCurrency() const override { return "BND"; }
+    double dailyLimit() const override { return 50000.0; }
+};
+
+/**
+ * @brief Cambodia compliance module (National Bank of Cambodia)
+ */
+class CambodiaModule : public CountryModule {
+public:
+    CountryCode countryCode() const override { return CountryCode::Cambodia; }
+    QString countryName() const override { return "Cambodia"; }
+    QString localCurrency() const override { return "KHR"; }
+    double dailyLimit() const override { return 40000000.0; }
+};
+
+/**
+ * @brief Vietnam compliance module (State Bank of Vietnam)
+ */
+class VietnamModule : public CountryModule {
+public:
+    CountryCode countryCode() const override { return CountryCode::Vietnam; }
+    QString countryName() const override { return "Vietnam"; }
+    QString localCurrency() const override { return "VND"; }
+    double dailyLimit() const override { return 500000000.0; }
+};
+
+/**
+ * @brief Laos compliance module (Bank of the Lao PDR)
+ */
+class LaosModule : public CountryModule {
+public:
+    CountryCode countryCode() const override { return CountryCode::Laos; }
+    QString countryName() const override { return "Lao People's Democratic Republic"; }
+    QString localCurrency() const override { return "LAK"; }
+    double dailyLimit() const override { return 50000000.0; }
+};
+
+/**
+ * @brief Create country compliance module
+ * @param code Country code
+ * @return Country module
+ */
+inline std::unique_ptr<CountryModule> createCountryModule(CountryCode code) {
+    switch (code) {
+        case CountryCode::Malaysia: return std::make_unique<MalaysiaModule>();
+        case CountryCode::Singapore: return std::make_unique<SingaporeModule>();
+        case CountryCode::Indonesia: return std::make_unique<IndonesiaModule>();
+        case CountryCode::Thailand: return std::make_unique<ThailandModule>();
+        case CountryCode::Brunei: return std::make_unique<BruneiModule>();
+        case CountryCode::Cambodia: return std::make_unique<CambodiaModule>();
+        case CountryCode::Vietnam: return std::make_unique<VietnamModule>();
+        case CountryCode::Laos: return std::make_unique<LaosModule>();
+        default: return std::make_unique<MalaysiaModule>();
+    }
+}
+
+/**
+ * @brief Webhook request as received: raw body and X-Webhook-Signature value
+ */
+struct WebhookDelivery {
+    QByteArray body;
+    QByteArray signature;
+};
+
+/**
+ * @brief Active secrets for one purpose
+ *
+ * Never modified while current or pinned by a reader; rotation publishes a new ring.
+ */
+struct KeyRing {
+    HmacSha256Key current;
+    HmacSha256Key previous;
+    qint64 previousValidUntil = 0;
+    
+    /**
+     * @brief Check if the previous key is still accepted
+     * @param nowMs Current time in milliseconds since epoch
+     * @return Whether verification may fall back to the previous key
+     */
+    bool previousActive(qint64 nowMs) const { return previous.isValid() && nowMs < previousValidUntil; }
+};
+
+/**
+ * @brief Request signing and webhook verification
+ *
+ * HMAC key pads are hashed once when a key is set; each signature then
+ * streams its segments through the precomputed inner and outer states.
+ *
+ * Keys live in immutable KeyRings published through PublishedValue (RCU
+ * style): signing and verification pin the current ring with one atomic
+ * increment, never lock, and keep it for the length of one signature, so
+ * rotation never blocks or invalidates them. Rotations are serialized
+ * among themselves.
+ */
+class SecurityModule {
+public:
+    /**
+     * @brief Default time the previous key stays valid after rotation
+     */
+    static const int DefaultGracePeriodMs = 5 * 60 * 1000;
+    
+    /**
+     * @brief Constructor
+     * @param apiKey API key used as the request signing secret
+     */
+    explicit SecurityModule(const QString& apiKey)
+    {
+        rotate(m_apiKeys, apiKey.toUtf8(), 0);
+    }
+    
+    /**
+     * @brief Replace the request signing key
+     *
+     * New requests are signed with the new key immediately; requests already
+     * being signed finish with the key they started with.
+     *
+     * @param apiKey New API key
+     * @param gracePeriodMs How long the previous key stays in the ring
+     */
+    void rotateApiKey(const QByteArray& apiKey, int gracePeriodMs = DefaultGracePeriodMs) {
+        rotate(m_apiKeys, apiKey, gracePeriodMs);
+    }
+    
+    /**
+     * @brief Replace the webhook secret
+     *
+     * Webhooks signed with the previous secret keep verifying until the
+     * grace period ends, covering deliveries already in flight.
+     *
+     * @param secret New webhook secret
+     * @param gracePeriodMs How long the previous secret is still accepted
+     */
+    void rotateWebhookSecret(const QByteArray& secret, int gracePeriodMs = DefaultGracePeriodMs) {
+        rotate(m_webhookKeys, secret, gracePeriodMs);
+    }
+    
+    /**
+     * @brief Sign an API request
+     *
+     * Computes HMAC-SHA256(method + path + timestamp + nonce + body) without
+     * concatenating the segments first.
+     *
+     * @param method HTTP method
+     * @param path Endpoint path, e.g. "/payments"
+     * @param timestamp Request timestamp in milliseconds
+     * @param nonce Request nonce
+     * @param body Request body, empty for requests without one
+     * @return Hex-encoded signature
+     */
+    QByteArray signRequest(const QByteArray& method, const QByteArray& path, const QByteArray& timestamp,
+                           const QByteArray& nonce, const QByteArray& body) const {
+        PublishedValue<KeyRing>::Reader keys = m_apiKeys.read();
+        HmacSha256 hmac(keys->current);
+        hmac.update(method.constData(), method.size());
+        hmac.update(path.constData(), path.size());
+        hmac.update(timestamp.constData(), timestamp.size());
+        hmac.update(nonce.constData(), nonce.size());
+        hmac.update(body.constData(), body.size());
+        return finishHex(hmac);
+    }
+    
+    /**
+     * @brief Generate a request nonce for the X-Nonce header
+     * @return Nonce, unique for the lifetime of this module
+     */
+    QByteArray nextNonce() {
+        QByteArray nonce(NonceGenerator::NonceLength, Qt::Uninitialized);
+        m_nonces.next(nonce.data());
+        return nonce;
+    }
+    
+    /**
+     * @brief Generate request signature
+     * @param data Request body
+     * @param timestamp Request timestamp in milliseconds
+     * @return Hex-encoded HMAC-SHA256 signature
+     */
+    QString generateSignature(const QString& data, const QString& timestamp) const {
+        QByteArray timestampBytes = timestamp.toUtf8();
+        QByteArray dataBytes = data.toUtf8();
+        
+        PublishedValue<KeyRing>::Reader keys = m_apiKeys.read();
+        HmacSha256 hmac(keys->current);
+        hmac.update(timestampBytes.constData(), timestampBytes.size());
+        hmac.update(".", 1);
+        hmac.update(dataBytes.constData(), dataBytes.size());
+        return QString::fromLatin1(finishHex(hmac));
+    }
+    
+    /**
+     * @brief Set webhook signing secret, dropping any previous one
+     * @param secret Webhook secret
+     */
+    void setWebhookSecret(const QByteArray& secret) {
+        rotate(m_webhookKeys, secret, 0);
+    }
+    
+    /**
+     * @brief Check if a webhook secret is set
+     * @return Whether webhooks can be verified
+     */
+    bool hasWebhookSecret() const { return m_webhookKeys.read()->current.isValid(); }
+    
+    /**
+     * @brief Verify webhook signature with the configured secret
+     * @param signature Hex-encoded signature to check
+     * @param body Raw webhook body
+     * @return Whether the signature is valid
+     */
+    bool verifyWebhookSignature(const QByteArray& signature, const QByteArray& body) const {
+        PublishedValue<KeyRing>::Reader keys = m_webhookKeys.read();
+        if (!keys->current.isValid()) {
+            return false;
+        }
+        if (verifyWithKey(keys->current, signature, body)) {
+            return true;
+        }
+        return keys->previousActive(QDateTime::currentMSecsSinceEpoch())
+                && verifyWithKey(keys->previous, signature, body);
+    }
+    
+    /**
+     * @brief Reject replayed or stale webhooks
+     *
+     * Call only after the signature was verified, so forged deliveries
+     * cannot fill the cache. The MAC itself is the event fingerprint.
+     *
+     * @param signature Verified hex-encoded signature
+     * @param eventTimeMs Event time in milliseconds since epoch, or ReplayCache::NoTimestamp to reject
+     * @return Whether the delivery is new and inside the replay window
+     */
+    bool acceptWebhook(const QByteArray& signature, qint64 eventTimeMs) {
+        unsigned char prefix[8];
+        if (signature.size() < 16 || !HexCodec::decode(signature.constData(), 16, prefix)) {
+            return false;
+        }
+        
+        quint64 fingerprint = 0;
+        for (unsigned char byte : prefix) {
+            fingerprint = (fingerprint << 8) | byte;
+        }
+        
+        return m_replayCache.check(fingerprint, eventTimeMs, QDateTime::currentMSecsSinceEpoch()) == ReplayCache::Accepted;
+    }
+    
+    /**
+     * @brief Verify a burst of webhook deliveries with the configured secret
+     *
+     * The MACs are computed together (SHA-NI, or eight AVX2 lanes at a
+     * time), which is cheaper than verifying each delivery on its own.
+     *
+     * @param deliveries Deliveries to check
+     * @return Bit i is set if delivery i has a valid signature
+     */
+    QBitArray verifyWebhookBatch(const QVector<WebhookDelivery>& deliveries) const {
+        QBitArray valid(deliveries.size());
+        PublishedValue<KeyRing>::Reader keys = m_webhookKeys.read();
+        if (!keys->current.isValid() || deliveries.isEmpty()) {
+            return valid;
+        }
+        
+        // Malformed signatures are rejected up front and not hashed
+        QVector<int> indexes;
+        QVector<const unsigned char*> messages;
+        QVector<std::size_t> lengths;
+        QByteArray provided;
+        indexes.reserve(deliveries.size());
+        messages.reserve(deliveries.size());
+        lengths.reserve(deliveries.size());
+        provided.resize(deliveries.size() * HmacSha256::MacSize);
+        
+        for (int i = 0; i < deliveries.size(); ++i) {
+            QByteArray signature = deliveries.at(i).signature.trimmed();
+            unsigned char* out = reinterpret_cast<unsigned char*>(provided.data()) + indexes.size() * HmacSha256::MacSize;
+            if (signature.size() != 2 * HmacSha256::MacSize
+                    || !HexCodec::decode(signature.constData(), signature.size(), out)) {
+                continue;
+            }
+            const QByteArray& body = deliveries.at(i).body;
+            indexes.append(i);
+            messages.append(reinterpret_cast<const unsigned char*>(body.constData()));
+            lengths.append(static_cast<std::size_t>(body.size()));
+        }
+        
+        QByteArray expected(indexes.size() * HmacSha256::MacSize, Qt::Uninitialized);
+        HmacSha256Batch::compute(keys->current, messages.constData(), lengths.constData(), indexes.size(),
+                                 reinterpret_cast<unsigned char*>(expected.data()));
+        
+        // Deliveries failing the current key get one more batch with the previous key
+        QVector<int> retry;
+        for (int n = 0; n < indexes.size(); ++n) {
+            const unsigned char* a = reinterpret_cast<const unsigned char*>(expected.constData()) + n * HmacSha256::MacSize;
+            const unsigned char* b = reinterpret_cast<const unsigned char*>(provided.constData()) + n * HmacSha256::MacSize;
+            if (digestsEqual(a, b)) {
+                valid.setBit(indexes.at(n));
+            } else {
+                retry.append(n);
+            }
+        }
+        
+        if (retry.isEmpty() || !keys->previousActive(QDateTime::currentMSecsSinceEpoch())) {
+            return valid;
+        }
+        
+        QVector<const unsigned char*> retryMessages;
+        QVector<std::size_t> retryLengths;
+        for (int n : retry) {
+            retryMessages.append(messages.at(n));
+            retryLengths.append(lengths.at(n));
+        }
+        HmacSha256Batch::compute(keys->previous, retryMessages.constData(), retryLengths.constData(), retry.size(),
+                                 reinterpret_cast<unsigned char*>(expected.data()));
+        
+        for (int r = 0; r < retry.size(); ++r) {
+            const unsigned char* a = reinterpret_cast<const unsigned char*>(expected.constData()) + r * HmacSha256::MacSize;
+            const unsigned char* b = reinterpret_cast<const unsigned char*>(provided.constData()) + retry.at(r) * HmacSha256::MacSize;
+            valid.setBit(indexes.at(retry.at(r)), digestsEqual(a, b));
+        }
+        
+        return valid;
+    }
+    
+    /**
+     * @brief Verify payload signature
+     * @param signature Hex-encoded signature to check
+     * @param data Signed payload
+     * @param secret Signing secret
+     * @return Whether the signature is valid
+     */
+    bool verifySignature(const QString& signature, const QString& data, const QString& secret) const {
+        return verifySignature(signature.toLatin1(), data.toUtf8(), secret.toUtf8());
+    }
+    
+    /**
+     * @brief Verify signature over raw payload bytes
+     * @param signature Hex-encoded signature to check
+     * @param data Signed payload bytes, exactly as received
+     * @param secret Signing secret
+     * @return Whether the signature is valid
+     */
+    bool verifySignature(const QByteArray& signature, const QByteArray& data, const QByteArray& secret) const {
+        return verifyWithKey(HmacSha256Key(secret.constData(), secret.size()), signature, data);
+    }
+    
+    /**
+     * @brief Compare two MACs in constant time
+     * @param a First MAC
+     * @param b Second MAC
+     * @return Whether the MACs are equal
+     */
+    static bool digestsEqual(const unsigned char a[HmacSha256::MacSize], const unsigned char b[HmacSha256::MacSize]) {
+        return HexCodec::constantTimeEquals(a, b, HmacSha256::MacSize);
+    }
+    
+private:
+    static QByteArray finishHex(HmacSha256& hmac) {
+        unsigned char mac[HmacSha256::MacSize];
+        hmac.finish(mac);
+        
+        QByteArray hex(2 * HmacSha256::MacSize, Qt::Uninitialized);
+        HexCodec::encode(mac, sizeof(mac), hex.data());
+        return hex;
+    }
+    
+    static void rotate(PublishedValue<KeyRing>& keys, const QByteArray& secret, int gracePeriodMs) {
+        HmacSha256Key key(secret.constData(), secret.size());
+        qint64 validUntil = QDateTime::currentMSecsSinceEpoch() + gracePeriodMs;
+        
+        // Copy-on-write from whichever ring is current once this rotation is serialized
+        keys.publish([&](const KeyRing& current) {
+            KeyRing ring;
+            ring.current = key;
+            if (gracePeriodMs > 0 && current.current.isValid()) {
+                ring.previous = current.current;
+                ring.previousValidUntil = validUntil;
+            }
+            return ring;
+        });
+    }
+    
+    static bool verifyWithKey(const HmacSha256Key& key, const QByteArray& signature, const QByteArray& data) {
+        // A malformed header says nothing about the secret, so rejecting it early is safe
+        unsigned char provided[HmacSha256::MacSize];
+        if (signature.size() != 2 * HmacSha256::MacSize
+                || !HexCodec::decode(signature.constData(), signature.size(), provided)) {
+            return false;
+        }
+        
+        unsigned char expected[HmacSha256::MacSize];
+        HmacSha256 hmac(key);
+        hmac.update(data.constData(), data.size());
+        hmac.finish(expected);
+        
+        return digestsEqual(expected, provided);
+    }
+    
+    PublishedValue<KeyRing> m_apiKeys;
+    PublishedValue<KeyRing> m_webhookKeys;
+    NonceGenerator m_nonces;
+    ReplayCache m_replayCache;
+};
+
+/**
+ * @brief Orders, deduplicates and coalesces webhook events per payment
+ *
+ * Each payment's state is versioned by (status rank, updated_at), where
+ * created < pending < completed/cancelled/expired and terminal states are
+ * final. Events not newer than what was already delivered or queued are
+ * dropped as stale or duplicate; several newer events for one payment in
+ * the same dispatch cycle collapse into the latest.
+ */
+class WebhookSequencer {
+public:
+    /**
+     * @brief Outcome of submitting an event
+     */
+    enum Verdict {
+        Queued,     ///< First pending event for the payment this cycle
+        Coalesced,  ///< Replaced an older pending event for the payment
+        Stale,      ///< Older than the delivered or pending state
+        Duplicate   ///< Same version as the delivered or pending state
+    };
+    
+    /**
+     * @brief Constructor
+     * @param capacity Payments remembered before idle ones are forgotten
+     */
+    explicit WebhookSequencer(int capacity = 10000) : m_capacity(capacity) {}
+    
+    /**
+     * @brief Submit a verified webhook event
+     * @param eventType Event type, e.g. "payment.completed"
+     * @param payment Payment carried by the event; must have an id
+     * @param eventTimeMs Envelope timestamp, used when the payment has no updated_at
+     * @return Outcome
+     */
+    Verdict submit(const QString& eventType, const Payment& payment, qint64 eventTimeMs);
+    
+    /**
+     * @brief Record a state learned by polling, so older webhooks are dropped
+     * @param payment Retrieved payment
+     */
+    void observe(const Payment& payment);
+    
+    /**
+     * @brief Check if events are waiting for the next flush
+     * @return Whether flush() would dispatch anything
+     */
+    bool hasPending() const { return !m_order.isEmpty(); }
+    
+    /**
+     * @brief Deliver the pending event of every payment, in first-arrival order
+     *
+     * Events submitted from within dispatch are held for the next flush.
+     *
+     * @param dispatch Callable taking (const QString& eventType, const Payment& payment)
+     */
+    template <typename Dispatch>
+    void flush(Dispatch dispatch) {
+        QVector<QString> order;
+        order.swap(m_order);
+        
+        for (const QString& id : order) {
+            auto it = m_entries.find(id);
+            if (it == m_entries.end() || !it->hasPending) {
+                continue;
+            }
+            it->delivered = it->pending;
+            it->hasPending = false;
+            QString eventType = it->eventType;
+            Payment payment = it->payment;
+            it->payment = Payment();
+            dispatch(eventType, payment);
+        }
+        
+        evictIdle();
+    }
+    
+    /**
+     * @brief Get number of events dropped as stale or duplicate
+     * @return Dropped event count
+     */
+    quint64 dropped() const { return m_dropped; }
+
+private:
+    struct Version {
+        int rank = -1;
+        qint64 timeMs = std::numeric_limits<qint64>::min();
+        PaymentStatus status = PaymentStatus::Created;
+    };
+    
+    struct Entry {
+        Version delivered;
+        Version pending;
+        bool hasPending = false;
+        QString eventType;
+        Payment payment;
+        quint64 touched = 0;
+    };
+    
+    static Version versionOf(const Payment& payment, qint64 fallbackTimeMs);
+    static int compare(const Version& a, const Version& b);
+    void evictIdle();
+    
+    QHash<QString, Entry> m_entries;
+    QVector<QString> m_order;
+    int m_capacity;
+    quint64 m_clock = 0;
+    quint64 m_dropped = 0;
+};
+
+/**
+ * @brief Exchange rates shared by every SDK instance in the process
+ *
+ * Rates are keyed by (base fiat, cryptocurrency) and stamped with the time
+ * they were fetched. Every rate the cache holds or hands out is a price:
+ * units of the fiat per one unit of the cryptocurrency (e.g. SGD 42631.25
+ * per BTC). Sources quoted the other way round are converted by store(),
+ * and oriented() converts back for callers that expect their shape. A
+ * rate younger than the TTL is fresh; an older one is still served, while
+ * a refresh runs, until it reaches the stale limit. At most one refresh
+ * per base currency is in flight across all instances; endRefresh()
+ * announces its outcome through ratesUpdated(). Thread-safe.
+ */
+class ExchangeRateCache : public QObject {
+    Q_OBJECT
+    
+public:
+    /**
+     * @brief How a source quotes its rates
+     */
+    enum Orientation {
+        FiatPerCrypto,  ///< Price of one crypto unit, e.g. exchange-rates/all and ExchangeRateStream
+        CryptoPerFiat   ///< Crypto units per one fiat unit, e.g. exchange-rates?base_currency=
+    };
+    
+    /**
+     * @brief State of the rates asked for
+     */
+    enum Freshness {
+        Missing,    ///< At least one rate is unknown or past the stale limit
+        Stale,      ///< All servable, at least one older than the TTL
+        Fresh       ///< All younger than the TTL
+    };
+    
+    /**
+     * @brief Get the process-wide cache
+     * @return Cache instance
+     */
+    static ExchangeRateCache& instance();
+    
+    /**
+     * @brief Set freshness limits
+     * @param ttlMs Age until a rate is refreshed
+     * @param maxStaleMs Age until a rate is no longer served
+     */
+    void setTtl(int ttlMs, int maxStaleMs);
+    
+    /**
+     * @brief Look up rates
+     *
+     * Reads table() without locking when it holds every code asked for,
+     * and takes the cache lock otherwise.
+     *
+     * @param baseCurrency Fiat base currency
+     * @param cryptoCurrencies Cryptocurrencies wanted
+     * @param rates Receives the servable rates, keyed by cryptocurrency
+     * @param nowMs Current time
+     * @param fetchedAtMs Receives the fetch time of the oldest servable rate, may be null
+     * @return Worst freshness among the wanted rates
+     */
+    Freshness lookup(const QString& baseCurrency, const QStringList& cryptoCurrencies, QVariantMap* rates, qint64 nowMs,
+            qint64* fetchedAtMs = nullptr) const;
+    
+    /**
+     * @brief Look up one pair, e.g. for a quote
+     *
+     * Lock-free and allocation-free when table() holds both codes; the
+     * cache lock is only taken for codes the table could not intern.
+     *
+     * @param baseCurrency Fiat base currency
+     * @param cryptoCurrency Cryptocurrency
+     * @param nowMs Current time
+     * @param rate Receives the rate, its fetch time and the pair's variance; rate is 0 when missing
+     * @return Freshness of the pair
+     */
+    Freshness lookupPair(const QString& baseCurrency, const QString& cryptoCurrency, qint64 nowMs,
+            RateTable::Rate* rate) const;
+    
+    /**
+     * @brief Store fetched rates
+     *
+     * Older values never replace newer ones; rates that are not positive
+     * are ignored.
+     *
+     * @param baseCurrency Fiat base currency
+     * @param rates Rates keyed by cryptocurrency
+     * @param fetchedAtMs Time the rates were fetched
+     * @param orientation How rates is quoted; stored rates are always FiatPerCrypto
+     */
+    void store(const QString& baseCurrency, const QVariantMap& rates, qint64 fetchedAtMs, Orientation orientation = FiatPerCrypto);
+    
+    /**
+     * @brief Claim the refresh of a base currency
+     *
+     * A claim older than the stale limit is considered abandoned.
+     *
+     * @param baseCurrency Fiat base currency
+     * @param nowMs Current time
+     * @return Whether the caller should fetch; false if a refresh is in flight
+     */
+    bool beginRefresh(const QString& baseCurrency, qint64 nowMs);
+    
+    /**
+     * @brief Release a refresh claim and emit ratesUpdated()
+     * @param baseCurrency Fiat base currency
+     */
+    void endRefresh(const QString& baseCurrency);
+    
+    /**
+     * @brief Get base currencies with cached rates
+     * @return Base currencies
+     */
+    QStringList baseCurrencies() const;
+    
+    /**
+     * @brief Get every cached rate for a base currency
+     * @param baseCurrency Fiat base currency
+     * @param fetchedAtMs Receives the fetch time of the oldest rate, may be null
+     * @return Rates keyed by cryptocurrency, stale ones included
+     */
+    QVariantMap rates(const QString& baseCurrency, qint64* fetchedAtMs = nullptr) const;
+    
+    /**
+     * @brief Read a rate sent as a JSON number, as documented, or as a decimal string
+     * @param value JSON value
+     * @return Rate, 0 if unreadable
+     */
+    static double parseRate(const QJsonValue& value);
+    
+    /**
+     * @brief Convert cached rates to the orientation of a source
+     * @param rates Rates as handed out by the cache, keyed by cryptocurrency
+     * @param orientation Wanted orientation
+     * @return Rates keyed by cryptocurrency
+     */
+    static QVariantMap oriented(const QVariantMap& rates, Orientation orientation);
+    
+    /**
+     * @brief Get the lock-free view of the cached rates
+     *
+     * Every stored rate, with its pair's variance, is also published here,
+     * one fiat row per store(), so threads other than the SDK owner
+     * (rendering, validation) can read consistent rates without taking the
+     * cache mutex or allocating. lookup() and lookupPair() read it first.
+     * Codes beyond the table's fixed capacity are only in the cache.
+     *
+     * @return Rate table
+     */
+    const RateTable& table() const { return m_table; }
+    
+    /**
+     * @brief Get realized variance of a pair over its recent ticks
+     * @param baseCurrency Fiat base currency
+     * @param cryptoCurrency Cryptocurrency
+     * @return Variance of log returns per millisecond, -1 if the history is too short
+     */
+    double variancePerMs(const QString& baseCurrency, const QString& cryptoCurrency) const;
+    
+    /**
+     * @brief Copy the recent ticks of a pair
+     * @param baseCurrency Fiat base currency
+     * @param cryptoCurrency Cryptocurrency
+     * @param ticks Receives up to capacity ticks, oldest first
+     * @param capacity Size of ticks
+     * @return Number of ticks written
+     */
+    int history(const QString& baseCurrency, const QString& cryptoCurrency, RateHistory::Tick* ticks, int capacity) const;
+    
+signals:
+    /**
+     * @brief Emitted when a refresh of a base currency ends, successful or not
+     * @param baseCurrency Fiat base currency
+     */
+    void ratesUpdated(const QString& baseCurrency);
+    
+private:
+    ExchangeRateCache() {}
+    
+    Freshness lookupLocked(const QString& baseCurrency, const QStringList& cryptoCurrencies, QVariantMap* rates,
+            qint64 nowMs, qint64* fetchedAtMs) const;
+    Freshness freshnessAt(qint64 fetchedAtMs, qint64 nowMs) const;
+    
+    struct Entry {
+        double rate = 0.0;
+        qint64 fetchedAtMs = 0;
+    };
+    
+    mutable QMutex m_mutex;
+    QHash<QString, QHash<QString, Entry>> m_rates;
+    QHash<QString, qint64> m_refreshing;
+    RateTable m_table;
+    QHash<QString, QHash<QString, RateHistory>> m_history;
+    // Atomic so table() lookups can age rates without the lock
+    std::atomic<int> m_ttlMs{30000};
+    std::atomic<int> m_maxStaleMs{10 * 60 * 1000};
+};
+
+/**
+ * @brief Payments tracked by the SDK, indexed by id, order id, status and expiry
+ *
+ * Entries live in one dense array. Ids and order ids are found through
+ * open-addressing tables of (hash, entry) slots, each status keeps an
+ * intrusive list of its entries, and a binary heap orders expiry
+ * deadlines, so lookups by any key and status changes are O(1) and the
+ * next deadline is O(1) to read.
+ *
+ * Payments in a final status are kept for local lookups until more than
+ * finalCapacity of them exist; the one that became final first is evicted.
+ * Status check timers are stored alongside but owned by the caller.
+ */
+class ActivePaymentStore {
+public:
+    /**
+     * @brief Marker for "no expiry deadline"
+     */
+    static const qint64 NoExpiry = std::numeric_limits<qint64>::max();
+    
+    /**
+     * @brief Constructor
+     * @param finalCapacity Payments in a final status kept before eviction
+     */
+    explicit ActivePaymentStore(int finalCapacity = 256);
+    
+    /**
+     * @brief Insert a payment or replace the stored copy
+     * @param payment Payment with an id
+     */
+    void upsert(const Payment& payment);
+    
+    /**
+     * @brief Remove a payment
+     * @param paymentId Payment ID
+     * @return Whether the payment was stored
+     */
+    bool remove(const QString& paymentId);
+    
+    /**
+     * @brief Check if a payment is stored
+     * @param paymentId Payment ID
+     * @return Whether it is stored
+     */
+    bool contains(const QString& paymentId) const { return findEntry(paymentId) >= 0; }
+    
+    /**
+     * @brief Look up a payment by id
+     * @param paymentId Payment ID
+     * @return Stored payment, or null; valid until the store is modified
+     */
+    const Payment* find(const QString& paymentId) const;
+    
+    /**
+     * @brief Look up a payment by merchant order id
+     * @param orderId Order ID
+     * @return Most recently stored payment for the order, or null; valid until the store is modified
+     */
+    const Payment* findByOrderId(const QString& orderId) const;
+    
+    /**
+     * @brief Get payments in one status
+     * @param status Payment status
+     * @return Payments, in the order they entered the status
+     */
+    QList<Payment> withStatus(PaymentStatus status) const;
+    
+    /**
+     * @brief Get payments not yet in a final status
+     * @return Active payments
+     */
+    QList<Payment> active() const;
+    
+    /**
+     * @brief Get number of payments not yet in a final status
+     * @return Active payment count
+     */
+    int activeCount() const;
+    
+    /**
+     * @brief Get number of stored payments
+     * @return Payment count
+     */
+    int size() const { return m_size; }
+    
+    /**
+     * @brief Attach a status check timer to a stored payment
+     * @param paymentId Payment ID
+     * @param timer Timer, owned by the caller
+     */
+    void setTimer(const QString& paymentId, QTimer* timer);
+    
+    /**
+     * @brief Get the timer attached to a payment
+     * @param paymentId Payment ID
+     * @return Timer, or null
+     */
+    QTimer* timer(const QString& paymentId) const;
+    
+    /**
+     * @brief Detach the timer from a payment
+     * @param paymentId Payment ID
+     * @return Timer that was attached, or null
+     */
+    QTimer* takeTimer(const QString& paymentId);
+    
+    /**
+     * @brief Get the earliest expiry deadline of an active payment
+     * @return Deadline in milliseconds since the epoch, or NoExpiry
+     */
+    qint64 nextExpiry() const;
+    
+    /**
+     * @brief Remove deadlines that have passed from the expiry index
+     * @param nowMs Current time in milliseconds since the epoch
+     * @return IDs of the payments whose deadline passed
+     */
+    QStringList takeExpired(qint64 nowMs);
+
+private:
+    static const int StatusCount = 5;
+    
+    struct Entry {
+        Payment payment;
+        QTimer* timer = nullptr;
+        qint64 expiresAtMs = NoExpiry;
+        uint idHash = 0;
+        uint orderHash = 0;
+        int status = -1;
+        int prev = -1;
+        int next = -1;
+        int heapIndex = -1;
+        quint64 sequence = 0;
+    };
+    
+    struct Slot {
+        uint hash = 0;
+        int entry = -1;
+    };
+    
+    int findEntry(const QString& paymentId) const;
+    int findSlot(const QVector<Slot>& table, uint hash, const QString& key, bool byOrderId) const;
+    void insertSlot(QVector<Slot>& table, uint hash, int entry);
+    void eraseSlot(QVector<Slot>& table, uint hash, int entry);
+    void growTables();
+    void link(int entry, int status);
+    void unlink(int entry);
+    void heapUpdate(int entry);
+    void heapRemove(int entry);
+    void heapSwap(int a, int b);
+    void heapUp(int index);
+    void heapDown(int index);
+    void evictFinal();
+    
+    QVector<Entry> m_entries;
+    QVector<int> m_free;
+    QVector<Slot> m_byId;
+    QVector<Slot> m_byOrderId;
+    QVector<int> m_expiryHeap;
+    int m_head[StatusCount];
+    int m_tail[StatusCount];
+    int m_count[StatusCount];
+    int m_finalCapacity;
+    int m_size = 0;
+    quint64 m_sequence = 0;
+};
+
+/**
+ * @brief Main SDK class
+ */
+class AsianCryptoPayment : public QObject {
+    Q_OBJECT
+    
+public:
+    /**
+     * @brief Callback for subscribe()
+     */
+    typedef std::function<void(const Payment& payment)> PaymentCallback;
+    
+    /**
+     * @brief Constructor
+     * @param apiKey API key
+     * @param merchantId Merchant ID
+     * @param countryCode Country code
+     * @param parent Parent object
+     */
+    AsianCryptoPayment(const QString& apiKey, const QString& merchantId, CountryCode countryCode, QObject* parent = nullptr);
+    
+    /**
+     * @brief Constructor that warm-starts from a snapshot
+     *
+     * Equivalent to the plain constructor followed by enableSnapshots().
+     *
+     * @param apiKey API key
+     * @param merchantId Merchant ID
+     * @param countryCode Country code
+     * @param snapshotPath Snapshot file, created on the first save
+     * @param parent Parent object
+     */
+    AsianCryptoPayment(const QString& apiKey, const QString& merchantId, CountryCode countryCode,
+            const QString& snapshotPath, QObject* parent = nullptr);
+    
+    /**
+     * @brief Destructor
+     */
+    ~AsianCryptoPayment();
+    
+    /**
+     * @brief Enable or disable test mode
+     * @param testMode Whether to use test mode
+     */
+    void setTestMode(bool testMode);
+    
+    /**
+     * @brief Set API endpoint
+     * @param apiEndpoint API base URL
+     */
+    void setApiEndpoint(const QString& apiEndpoint);
+    
+    /**
+     * @brief Set supported cryptocurrencies
+     * @param supportedCryptocurrencies Cryptocurrency codes
+     */
+    void setSupportedCryptocurrencies(const QStringList& supportedCryptocurrencies);
+    
+    /**
+     * @brief Configure webhooks
+     *
+     * Calling this again with a new secret rotates it; webhooks signed with
+     * the old secret are accepted for SecurityModule::DefaultGracePeriodMs.
+     *
+     * @param webhookEndpoint Webhook endpoint URL
+     * @param webhookSecret Webhook signing secret
+     */
+    void setWebhookConfig(const QString& webhookEndpoint, const QString& webhookSecret);
+    
+    /**
+     * @brief Replace the API key without recreating the SDK
+     * @param apiKey New API key
+     * @param gracePeriodMs How long the previous key stays in the key ring
+     */
+    void rotateApiKey(const QString& apiKey, int gracePeriodMs = SecurityModule::DefaultGracePeriodMs);
+    
+    /**
+     * @brief Replace the webhook secret
+     * @param webhookSecret New webhook secret
+     * @param gracePeriodMs How long webhooks signed with the previous secret are accepted
+     */
+    void rotateWebhookSecret(const QString& webhookSecret, int gracePeriodMs = SecurityModule::DefaultGracePeriodMs);
+    
+    /**
+     * @brief Create a payment
+     * @param paymentDetails Payment details
+     */
+    void createPayment(const PaymentDetails& paymentDetails);
+    
+    /**
+     * @brief Get a payment
+     *
+     * A cached copy younger than the TTL for its status, or any cached copy
+     * in a final status, is emitted on the next event loop turn without a
+     * request. Webhooks, status checks and other responses keep the cache
+     * current.
+     *
+     * @param paymentId Payment ID
+     */
+    void getPayment(const QString& paymentId);
+    
+    /**
+     * @brief Set how long getPayment() may answer from the cache
+     * @param status Created or pending; final statuses are cached indefinitely
+     * @param ttlMs Time to live in milliseconds, 0 to always fetch
+     */
+    void setPaymentCacheTtl(PaymentStatus status, int ttlMs);
+    
+    /**
+     * @brief Get a list of payments
+     *
+     * With a payment ledger enabled, a filter whose start and end dates lie
+     * in a range the ledger holds completely is answered from the ledger on
+     * the next event loop turn, without a request, provided the statuses
+     * held are current: every payment in the range is final, or
+     * syncPayments() has run since the newest range was recorded.
+     *
+     * @param filters Payment filters
+     */
+    void getPayments(const PaymentFilters& filters = PaymentFilters());
+    
+    /**
+     * @brief List every payment matching a filter, page by page
+     *
+     * The first page is fetched alone to learn the total; the remaining
+     * offset windows are then requested concurrently, within the GET
+     * /payments rate budget, and each page is emitted through
+     * paymentsPageRetrieved() as it arrives, so pages may come out of
+     * order. Pages are only requested while the consumer has credit:
+     * prefetchPages to start with, plus whatever fetchMorePayments() grants.
+     * A new listing replaces the running one.
+     *
+     * @param filters Payment filters; offset and limit bound the whole listing
+     * @param pageSize Payments per request
+     * @param prefetchPages Pages that may be requested before the consumer pulls
+     */
+    void listPayments(const PaymentFilters& filters = PaymentFilters(), int pageSize = 100, int prefetchPages = 4);
+    
+    /**
+     * @brief Let the running listing request more pages
+     * @param pages Number of additional pages the consumer will accept
+     */
+    void fetchMorePayments(int pages = 1);
+    
+    /**
+     * @brief Stop the running listing; pages already requested are dropped
+     */
+    void cancelPaymentListing();
+    
+    /**
+     * @brief Fetch payments changed since the last sync
+     *
+     * Pages through payments updated after the sync cursor, the newest
+     * (updated_at, id) seen so far, minus an overlap window that absorbs
+     * clock skew and updates landing while a sync runs. Consecutive pages
+     * overlap by a tenth of a page, so rows shifted by inserts during the
+     * scan are not skipped; payments already reported with the same update
+     * time are dropped. Servers that ignore updated_since list everything
+     * newest first, so paging stops at the first page with no changes and
+     * only payments created before the lookback period.
+     *
+     * Ends with paymentsSynced(). Does nothing while a sync is running.
+     *
+     * @param pageSize Payments per request
+     */
+    void syncPayments(int pageSize = 100);
+    
+    /**
+     * @brief Get the sync cursor, to persist it across restarts
+     * @return Opaque cursor, empty before the first sync
+     */
+    QString paymentSyncCursor() const;
+    
+    /**
+     * @brief Resume syncing from a persisted cursor
+     * @param cursor Value of paymentSyncCursor(), or empty to sync everything
+     */
+    void setPaymentSyncCursor(const QString& cursor);
+    
+    /**
+     * @brief Tune how far back syncPayments() looks
+     * @param overlapMs Window before the cursor fetched again on every sync
+     * @param lookbackMs Age after which payments are assumed to no longer change
+     */
+    void setPaymentSyncWindow(int overlapMs, qint64 lookbackMs);
+    
+    /**
+     * @brief Cancel a payment
+     * @param paymentId Payment ID
+     */
+    void cancelPayment(const QString& paymentId);
+    
+    /**
+     * @brief Quote a payment instantly from cached exchange rates
+     *
+     * Applies the same validation and country rules as createPayment(),
+     * then converts amount plus fee at the shared cached rate. Rates that
+     * are missing or stale are refreshed in the background; with no usable
+     * rate the quote is invalid. createPayment() quotes the same way and
+     * reconciles against the created payment, see quoteReconciled().
+     *
+     * @param paymentDetails Payment details
+     * @return Quote, invalid if no rate is cached
+     * @throws std::invalid_argument if the payment is not allowed
+     */
+    PaymentQuote quotePayment(const PaymentDetails& paymentDetails);
+    
+    /**
+     * @brief Set the fees added to local quotes
+     * @param feePercent Percentage of the fiat amount
+     * @param feeFixed Fixed fee in fiat
+     */
+    void setQuoteFees(double feePercent, double feeFixed);
+    
+    /**
+     * @brief Set how long local quotes are shown
+     *
+     * Used as is while adaptive validity is off or the pair has too little
+     * rate history.
+     *
+     * @param validityMs Quote lifetime in milliseconds
+     */
+    void setQuoteValidity(int validityMs);
+    
+    /**
+     * @brief Derive quote validity from recent rate volatility
+     *
+     * A quote is kept valid for as long as a two-sigma move of its pair,
+     * at the realized volatility of the recent ticks, stays within the
+     * tolerance. Calm pairs get longer quotes, volatile ones shorter
+     * quotes, fresher rates for quoting and faster status checks on their
+     * pending payments.
+     *
+     * @param tolerance Acceptable relative rate move, 0 to turn off
+     * @param minValidityMs Shortest quote lifetime
+     * @param maxValidityMs Longest quote lifetime
+     */
+    void setAdaptiveQuoteValidity(double tolerance, int minValidityMs = 10000, int maxValidityMs = 5 * 60 * 1000);
+    
+    /**
+     * @brief Get the lifetime a local quote of a pair gets now
+     * @param currency Fiat currency
+     * @param cryptoCurrency Cryptocurrency
+     * @return Quote lifetime in milliseconds
+     */
+    int quoteValidityMs(const QString& currency, const QString& cryptoCurrency) const;
+    
+    /**
+     * @brief Get the recent rates of a pair, e.g. for a sparkline
+     * @param baseCurrency Fiat base currency
+     * @param cryptoCurrency Cryptocurrency
+     * @param maxTicks Most ticks to return
+     * @return Ticks, oldest first
+     */
+    QVector<RateHistory::Tick> rateHistory(const QString& baseCurrency, const QString& cryptoCurrency,
+            int maxTicks = RateHistory::Capacity) const;
+    
+    /**
+     * @brief Get drift between local quotes and created payments
+     * @return Drift statistics
+     */
+    QuoteDriftStats quoteDriftStats() const { return m_quoteDrift; }
+    
+    /**
+     * @brief Get exchange rates
+     *
+     * Answered from the shared ExchangeRateCache when it can be: fresh
+     * rates are emitted on the next event loop turn without a request;
+     * stale ones are emitted the same way while one background refresh
+     * updates the cache. Only missing rates are waited for, and a refresh
+     * already in flight from any instance is joined rather than repeated.
+     * Each call emits exchangeRatesRetrieved() exactly once on success.
+     *
+     * @param baseCurrency Fiat base currency
+     * @param cryptoCurrencies Cryptocurrencies to quote (defaults to supported ones)
+     */
+    void getExchangeRates(const QString& baseCurrency, const QStringList& cryptoCurrencies = QStringList());
+    
+    /**
+     * @brief Verify webhook signature
+     * @param signature Webhook signature
+     * @param body Webhook body
+     * @return Whether the signature is valid
+     */
+    bool verifyWebhookSignature(const QString& signature, const QString& body);
+    
+    /**
+     * @brief Process webhook event
+     * @param event Webhook event
+     * @param signature Webhook signature
+     * @return Whether the event was processed
+     */
+    bool processWebhookEvent(const QJsonObject& event, const QString& signature);
+    
+    /**
+     * @brief Process raw webhook request
+     *
+     * The signature is checked over the body bytes exactly as received, and
+     * the body is only parsed once the signature is valid. Payment events are
+     * passed through a WebhookSequencer and emitted on the next event loop
+     * turn, at most once per payment.
+     *
+     * @param body Raw HTTP request body
+     * @param signature Value of the X-Webhook-Signature header
+     * @return Whether the event was verified and processed
+     */
+    bool processWebhookPayload(const QByteArray& body, const QByteArray& signature);
+    
+    /**
+     * @brief Process a burst of raw webhook requests
+     *
+     * All signatures are verified in one batch before any body is parsed;
+     * verified events are then processed in order.
+     *
+     * @param deliveries Webhook requests in arrival order
+     * @return Bit i is set if delivery i was verified and processed
+     */
+    QBitArray processWebhookPayloads(const QVector<WebhookDelivery>& deliveries);
+    
+    /**
+     * @brief Verify and decode webhooks on worker threads
+     *
+     * Deliveries go to the workers round robin without being parsed, so
+     * forged traffic still costs one HMAC and nothing else. Workers verify,
+     * then decode; replay checks, sequencing and signals stay on this
+     * object's thread, where the WebhookSequencer drops any event that
+     * finished after a newer one for the same payment. Once enabled, processWebhookPayload() and
+     * processWebhookPayloads() return as soon as a delivery is queued, and
+     * must be called from a single thread. Deliveries still queued when the
+     * pool is resized are dropped, so call this before webhooks arrive.
+     *
+     * @param threads Number of workers, 0 to process webhooks inline (default)
+     * @param queueCapacity Deliveries buffered per worker
+     */
+    void setWebhookWorkerThreads(int threads, int queueCapacity = 1024);
+    
+    /**
+     * @brief Get number of webhook workers
+     * @return Worker count, 0 when webhooks are processed inline
+     */
+    int webhookWorkerThreads() const;
+    
+    /**
+     * @brief Journal payment events to disk and restore state from it
+     *
+     * Verified webhook events and payment API responses are appended to a
+     * memory-mapped EventJournal in the directory. Records already there
+     * are replayed first: payments that are not final become active again
+     * and their status checks resume, without querying the API.
+     *
+     * @param directory Journal directory, created if missing
+     * @return Number of active payments restored, or -1 if the journal could not be opened
+     */
+    int enableEventJournal(const QString& directory);
+    
+    /**
+     * @brief Keep every payment seen in a local ledger file
+     *
+     * Payments from API responses and webhooks are stored in a memory-mapped
+     * PaymentLedger indexed by status, creation time and currency. When
+     * getPayments() is called with a start date and no other filter and the
+     * server returns every match, the date range up to the time of the
+     * request is recorded as synced; later getPayments() calls inside synced
+     * ranges are answered locally while the statuses held are current (see
+     * getPayments()).
+     *
+     * @param filePath Ledger file, created if missing
+     * @return Whether the ledger is open
+     */
+    bool enablePaymentLedger(const QString& filePath);
+    
+    /**
+     * @brief Restore state from a snapshot file and keep it up to date
+     *
+     * Active payments, the last exchange rates per base currency, the
+     * supported cryptocurrencies and the sync cursor are restored at once,
+     * so the SDK can serve the first customer without waiting for the API.
+     * Restored payments and rates are then refreshed in the background.
+     * Settings made by the integrator (endpoint, test mode, webhook
+     * configuration) and secrets are never written or restored.
+     *
+     * While enabled, the state is written atomically to the file every
+     * interval if it changed, and when the SDK is destroyed.
+     *
+     * @param filePath Snapshot file
+     * @param intervalMs Time between snapshots
+     * @return Number of active payments restored, or -1 if an existing snapshot could not be read
+     */
+    int enableSnapshots(const QString& filePath, int intervalMs = 30000);
+    
+    /**
+     * @brief Write a snapshot now
+     * @return Whether the snapshot is durable
+     */
+    bool saveSnapshot();
+    
+    /**
+     * @brief Set how long shared exchange rates are served
+     *
+     * Applies to every instance in the process.
+     *
+     * @param ttlMs Age until a rate is refreshed in the background
+     * @param maxStaleMs Age until a rate is no longer served while refreshing
+     */
+    void setExchangeRateCacheTtl(int ttlMs, int maxStaleMs = 10 * 60 * 1000);
+    
+    /**
+     * @brief Get the last exchange rates retrieved for a base currency
+     * @param baseCurrency Fiat base currency
+     * @return Units of each cryptocurrency per one unit of the base, keyed by code, empty if none are known
+     */
+    QVariantMap cachedExchangeRates(const QString& baseCurrency) const;
+    
+    /**
+     * @brief Get payments being tracked until they reach a final status
+     * @return Active payments
+     */
+    QList<Payment> activePayments() const;
+    
+    /**
+     * @brief Look up a tracked payment by merchant order id, without an API call
+     * @param orderId Merchant order ID
+     * @return Payment, or a payment with an empty id if none is tracked
+     */
+    Payment findPaymentByOrderId(const QString& orderId) const;
+    
+    /**
+     * @brief Get tracked payments in one status, without an API call
+     *
+     * Final statuses hold recently finished payments only.
+     *
+     * @param status Payment status
+     * @return Payments
+     */
+    QList<Payment> paymentsWithStatus(PaymentStatus status) const;
+    
+    /**
+     * @brief Receive updates for one payment only
+     *
+     * The callback runs on this object's thread whenever a new version of
+     * the payment arrives from a webhook, status check, sync, or get or
+     * cancel response; versions identical to the known one are skipped.
+     * Delivery is a hash lookup on the payment id, so subscribers of other
+     * payments are not woken. Subscriptions end by themselves once the
+     * payment reaches a final status, after that update is delivered.
+     *
+     * @param paymentId Payment ID
+     * @param callback Called with each new version
+     * @return Handle for unsubscribe(), 0 if paymentId is empty
+     */
+    quint64 subscribe(const QString& paymentId, const PaymentCallback& callback);
+    
+    /**
+     * @brief End a subscription; safe to call from its own callback
+     * @param handle Value returned by subscribe()
+     */
+    void unsubscribe(quint64 handle);
+    
+    /**
+     * @brief Download QR code image
+     * @param url QR code URL
+     */
+    void downloadQrCode(const QString& url);
+    
+signals:
+    /**
+     * @brief Emitted when a payment is created
+     * @param payment Created payment
+     */
+    void paymentCreated(const Payment& payment);
+    
+    /**
+     * @brief Emitted when a payment is retrieved
+     * @param payment Retrieved payment
+     */
+    void paymentRetrieved(const Payment& payment);
+    
+    /**
+     * @brief Emitted when a list of payments is retrieved
+     * @param payments Retrieved payments
+     * @param total Total number of matching payments
+     */
+    void paymentsRetrieved(const QList<Payment>& payments, int total);
+    
+    /**
+     * @brief Emitted when a list of payments is retrieved, before any field is decoded
+     * @param payments Lazily decoded payments sharing the response buffer
+     * @param total Total number of matching payments
+     */
+    void lazyPaymentsRetrieved(const QList<LazyPayment>& payments, int total);
+    
+    /**
+     * @brief Emitted for each page of listPayments()
+     * @param page Payments in the page
+     * @param offset Offset of the page
+     * @param total Total number of matching payments
+     */
+    void paymentsPageRetrieved(const QList<Payment>& page, int offset, int total);
+    
+    /**
+     * @brief Emitted after the last page of listPayments()
+     * @param total Total number of matching payments
+     */
+    void paymentListingFinished(int total);
+    
+    /**
+     * @brief Emitted when syncPayments() has caught up
+     * @param changed Payments created or updated since the previous sync
+     * @param cursor New sync cursor
+     */
+    void paymentsSynced(const QList<Payment>& changed, const QString& cursor);
+    
+    /**
+     * @brief Emitted after paymentCreated() when a local quote was made for the payment
+     * @param paymentId Created payment ID
+     * @param quote Local quote made when the payment was requested
+     * @param drift (server crypto amount - quoted amount) / server crypto amount
+     */
+    void quoteReconciled(const QString& paymentId, const PaymentQuote& quote, double drift);
+    
+    /**
+     * @brief Emitted when a payment is cancelled
+     * @param payment Cancelled payment
+     */
+    void paymentCancelled(const Payment& payment);
+    
+    /**
+     * @brief Emitted when a payment status changes
+     * @param payment Updated payment
+     */
+    void paymentStatusUpdated(const Payment& payment);
+    
+    /**
+     * @brief Emitted when a payment arrives that differs from the known version
+     *
+     * Covers webhooks, status checks, syncs and API responses. Status checks
+     * that find nothing new emit neither this nor paymentRetrieved().
+     *
+     * @param delta Changed fields and their new values
+     */
+    void paymentChanged(const PaymentDelta& delta);
+    
+    /**
+     * @brief Emitted when exchange rates are retrieved
+     * @param baseCurrency Fiat base currency
+     * @param rates Units of each cryptocurrency per one unit of the base, keyed by code
+     */
+    void exchangeRatesRetrieved(const QString& baseCurrency, const QVariantMap& rates);
+    
+    /**
+     * @brief Emitted when a QR code image is downloaded
+     * @param qrCode QR code image
+     */
+    void qrCodeDownloaded(const QPixmap& qrCode);
+    
+    /**
+     * @brief Emitted on error
+     * @param code Error code
+     * @param message Error message
+     */
+    void error(int code, const QString& message);
+    
+private slots:
+    void onNetworkReply(QNetworkReply* reply);
+    void checkPaymentStatus();
+    void checkExpiredPayments();
+    void drainWebhookResults();
+    void onSharedRatesUpdated(const QString& baseCurrency);
+    
+private:
+    /**
+     * @brief API request type
+     */
+    enum class RequestType {
+        Unknown,
+        CreatePayment,
+        GetPayment,
+        GetPayments,
+        SyncPayments,
+        ListPayments,
+        CancelPayment,
+        GetExchangeRates,
+        DownloadQrCode
+    };
+    
+    /**
+     * @brief Context of a pending API request
+     */
+    struct RequestContext {
+        RequestType type = RequestType::Unknown;
+        QString id;
+        bool syncRange = false;     ///< A complete GetPayments response covers the range below
+        qint64 rangeFromMs = 0;
+        qint64 rangeToMs = 0;
+        quint64 listing = 0;        ///< ListPayments generation
+        int offset = 0;             ///< ListPayments page offset
+        bool poll = false;          ///< GetPayment issued by a status check
+        bool refreshOnly = false;   ///< GetExchangeRates that only updates the cache
+        PaymentQuote quote;         ///< CreatePayment local quote
+    };
+    
+    /**
+     * @brief Payment as last seen, with the time it was seen
+     */
+    struct CachedPayment {
+        Payment payment;
+        qint64 storedAtMs = 0;
+        bool stale = false;     ///< Superseded by a pending webhook; kept only as the base for paymentChanged()
+    };
+    
+    /**
+     * @brief Webhook event decoded from a verified body
+     */
+    struct DecodedWebhook {
+        QByteArray body;
+        QString eventType;
+        qint64 eventTimeMs = ReplayCache::NoTimestamp;
+        bool hasPayment = false;
+        Payment payment;
+    };
+    
+    /**
+     * @brief Outcome of a webhook handled by a worker thread
+     */
+    struct WebhookResult {
+        QByteArray signature;
+        bool verified = false;
+        bool decoded = false;
+        DecodedWebhook event;
+    };
+    
+    typedef ShardedWorkerPool<WebhookDelivery, WebhookResult> WebhookWorkerPool;
+    
+    /**
+     * @brief Callback registered with subscribe()
+     */
+    struct Subscription {
+        quint64 handle = 0;
+        PaymentCallback callback;
+    };
+    
+    /**
+     * @brief State of a running listPayments()
+     */
+    struct PaymentListing {
+        quint64 generation = 0;     ///< Bumped per listing; stale replies are dropped
+        bool active = false;
+        PaymentFilters filters;
+        int pageSize = 0;
+        int total = -1;             ///< -1 until the first page arrives
+        int end = 0;
+        int nextOffset = 0;
+        int credit = 0;
+        int inFlight = 0;
+        bool pumpScheduled = false;
+    };
+    
+    /**
+     * @brief State of a running syncPayments()
+     */
+    struct PaymentSync {
+        bool running = false;
+        int pageSize = 0;
+        int offset = 0;
+        qint64 sinceMs = -1;        ///< -1 when syncing everything
+        qint64 cursorMs = -1;
+        QString cursorId;
+        QList<Payment> changed;
+        qint64 startedAtMs = 0;
+    };
+    
+    /**
+     * @brief Event journal record types
+     */
+    enum JournalRecord : quint32 {
+        JournalWebhook = 1,     ///< Verified webhook body
+        JournalPayment = 2      ///< Payment object from an API response or snapshot
+    };
+    
+    void validatePaymentDetails(const PaymentDetails& paymentDetails);
+    QNetworkRequest createApiRequest(const QString& method, const QString& endpoint, const QByteArray& body = QByteArray());
+    QNetworkReply* makeApiRequest(const QString& endpoint, const QString& method, const QJsonObject& data = QJsonObject());
+    QNetworkReply* makeApiRequest(const QString& endpoint, const QString& method, const QByteArray& body);
+    void onQrCodeDownloaded(QNetworkReply* reply);
+    void startPaymentStatusCheck(const Payment& payment);
+    void stopPaymentStatusCheck(const QString& paymentId);
+    int statusCheckIntervalMs(const Payment& payment) const;
+    void trackPayment(const Payment& payment);
+    void fetchPayment(const QString& paymentId, bool poll = false);
+    bool emitPaymentDelta(const Payment& payment);
+    void notifySubscribers(const Payment& payment);
+    void cachePayment(const Payment& payment);
+    bool getLocalPayments(const PaymentFilters& filters);
+    void storePaymentPage(const QList<LazyPayment>& page);
+    void requestListingPage(int offset);
+    void pumpPaymentListing();
+    void handleListingPage(const RequestContext& context, const QList<LazyPayment>& page, int total);
+    void requestSyncPage();
+    void handleSyncPage(const QList<LazyPayment>& page, int total);
+    void armExpiryTimer();
+    void restoreSnapshot(const QJsonObject& snapshot);
+    void requestExchangeRates(const QString& baseCurrency, const QStringList& cryptoCurrencies, bool refreshOnly = false);
+    PaymentQuote localQuote(double amount, const QString& currency, const QString& cryptoCurrency);
+    int quoteValidityFor(double variancePerMs) const;
+    void reconcileQuote(const Payment& payment, const PaymentQuote& quote);
+    bool handleVerifiedWebhook(const QByteArray& body, const QByteArray& signature);
+    static bool decodeWebhook(const QByteArray& body, DecodedWebhook* event);
+    bool applyWebhook(const DecodedWebhook& event, const QByteArray& signature);
+    bool submitWebhook(const WebhookDelivery& delivery);
+    void scheduleWebhookFlush();
+    void dispatchWebhookEvent(const QString& eventType, const Payment& payment);
+    void journal(JournalRecord type, const QByteArray& data);
+    
+    QString m_apiKey;
+    QString m_merchantId;
+    CountryCode m_countryCode;
+    bool m_testMode = false;
+    QString m_apiEndpoint = "https://api.asiancryptopay.com/v1";
+    QStringList m_supportedCryptocurrencies;
+    QVariantMap m_webhookConfig;
+    
+    QNetworkAccessManager* m_networkManager;
+    std::unique_ptr<CountryModule> m_countryModule;
+    std::unique_ptr<SecurityModule> m_securityModule;
+    
+    QMap<QNetworkReply*, RequestContext> m_pendingRequests;
+    ActivePaymentStore m_payments;
+    QTimer* m_expiryTimer = nullptr;
+    QCache<QString, CachedPayment> m_paymentCache;
+    QElapsedTimer m_paymentCacheClock;
+    int m_createdTtlMs = 5000;
+    int m_pendingTtlMs = 2000;
+    WebhookSequencer m_webhookSequencer;
+    bool m_webhookFlushScheduled = false;
+    quint64 m_nextWebhookWorker = 0;
+    std::unique_ptr<EventJournal> m_journal;
+    quint64 m_journalSegment = 0;
+    std::unique_ptr<PaymentLedger> m_ledger;
+    QHash<QString, QStringList> m_rateWaiters;
+    double m_quoteFeePercent = 0.0;
+    double m_quoteFeeFixed = 0.0;
+    int m_quoteValidityMs = 60000;
+    double m_quoteTolerance = 0.005;
+    int m_minQuoteValidityMs = 10000;
+    int m_maxQuoteValidityMs = 5 * 60 * 1000;
+    QuoteDriftStats m_quoteDrift;
+    QHash<QString, QVector<Subscription>> m_subscriptions;
+    QHash<quint64, QString> m_subscriptionPayments;
+    quint64 m_nextSubscription = 1;
+    QString m_snapshotPath;
+    QTimer* m_snapshotTimer = nullptr;
+    bool m_snapshotDirty = false;
+    PaymentListing m_listing;
+    TokenBucket m_listBudget{120, 60 * 1000};
+    PaymentSync m_sync;
+    qint64 m_syncCursorMs = -1;
+    qint64 m_syncCheckedAtMs = -1;      ///< Start of the last completed syncPayments()
+    qint64 m_rangeMarkedAtMs = -1;      ///< When the newest ledger range was recorded
+    QString m_syncCursorId;
+    QHash<QString, qint64> m_syncSeen;
+    int m_syncOverlapMs = 5000;
+    qint64 m_syncLookbackMs = 24 * 60 * 60 * 1000;
+    
+    // Declared last so workers stop before anything they use is destroyed
+    std::unique_ptr<WebhookWorkerPool> m_webhookPool;
+    
+    friend class ExchangeRateStream;
+};
+
+} // namespace AsianCryptoPay
+
+#endif // ASIAN_CRYPTO_PAYMENT_H
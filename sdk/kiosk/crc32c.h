@@ -0,0 +1,49 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * CRC-32C (Castagnoli) checksum for on-disk records.
+ */
+
+#ifndef ASIAN_CRYPTO_PAYMENT_CRC32C_H
+#define ASIAN_CRYPTO_PAYMENT_CRC32C_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace AsianCryptoPay {
+
+/**
+ * @brief Extend a CRC-32C over more bytes
+ * @param crc Checksum so far, 0 to start
+ * @param data Bytes
+ * @param length Number of bytes
+ * @return Updated checksum
+ */
+inline std::uint32_t crc32c(std::uint32_t crc, const void* data, std::size_t length) {
+    struct Table {
+        std::uint32_t entries[256];
+        
+        Table() {
+            for (std::uint32_t i = 0; i < 256; ++i) {
+                std::uint32_t value = i;
+                for (int bit = 0; bit < 8; ++bit) {
+                    value = (value >> 1) ^ (0x82f63b78u & (0u - (value & 1u)));
+                }
+                entries[i] = value;
+            }
+        }
+    };
+    static const Table table;
+    
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+    for (std::size_t i = 0; i < length; ++i) {
+        crc = table.entries[(crc ^ bytes[i]) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+} // namespace AsianCryptoPay
+
+#endif // ASIAN_CRYPTO_PAYMENT_CRC32C_H
@@ -0,0 +1,374 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * Event journal implementation.
+ */
+
+#include "event_journal.h"
+#include "crc32c.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <dirent.h>
+#endif
+
+namespace AsianCryptoPay {
+
+namespace {
+
+// Segment: 8-byte magic, 8-byte sequence, then records
+const char kSegmentMagic[8] = { 'A', 'C', 'P', 'J', 'R', 'N', 'L', '1' };
+const std::size_t kSegmentHeaderSize = 16;
+
+// Record: length, type, time, CRC-32C of the first 16 bytes and payload,
+// reserved; payload follows, padded to 8 bytes. Type 0 marks the end.
+struct RecordHeader {
+    std::uint32_t length;
+    std::uint32_t type;
+    std::int64_t timeMs;
+    std::uint32_t crc;
+    std::uint32_t reserved;
+};
+
+const std::size_t kRecordHeaderSize = sizeof(RecordHeader);
+
+inline std::size_t recordSize(std::size_t length) {
+    return (kRecordHeaderSize + length + 7) & ~static_cast<std::size_t>(7);
+}
+
+std::uint32_t recordCrc(const RecordHeader& header, const char* payload) {
+    std::uint32_t crc = crc32c(0, &header, offsetof(RecordHeader, crc));
+    return crc32c(crc, payload, header.length);
+}
+
+bool validSegmentHeader(const char* data, std::size_t size, std::uint64_t sequence) {
+    if (size < kSegmentHeaderSize || std::memcmp(data, kSegmentMagic, sizeof(kSegmentMagic)) != 0) {
+        return false;
+    }
+    std::uint64_t stored;
+    std::memcpy(&stored, data + sizeof(kSegmentMagic), sizeof(stored));
+    return stored == sequence;
+}
+
+// Visits intact records from the segment header on; returns the end offset
+std::size_t scanSegment(const char* data, std::size_t size, const EventJournal::Visitor* visitor, std::size_t* records) {
+    std::size_t offset = kSegmentHeaderSize;
+    while (size - offset >= kRecordHeaderSize) {
+        RecordHeader header;
+        std::memcpy(&header, data + offset, kRecordHeaderSize);
+        if (header.type == 0 || header.length > size - offset - kRecordHeaderSize) {
+            break;
+        }
+        
+        const char* payload = data + offset + kRecordHeaderSize;
+        if (recordCrc(header, payload) != header.crc) {
+            break;
+        }
+        
+        if (visitor) {
+            (*visitor)(header.type, header.timeMs, payload, header.length);
+        }
+        if (records) {
+            ++*records;
+        }
+        offset += std::min(recordSize(header.length), size - offset);
+    }
+    return offset;
+}
+
+std::vector<std::uint64_t> listSegments(const std::string& directory) {
+    std::vector<std::uint64_t> sequences;
+#if defined(__unix__) || defined(__APPLE__)
+    DIR* dir = ::opendir(directory.c_str());
+    if (!dir) {
+        return sequences;
+    }
+    while (dirent* entry = ::readdir(dir)) {
+        unsigned long long sequence = 0;
+        char tail[8] = { 0 };
+        if (std::strlen(entry->d_name) == 28
+                && std::sscanf(entry->d_name, "journal-%16llx.%3s", &sequence, tail) == 2
+                && std::strcmp(tail, "log") == 0) {
+            sequences.push_back(sequence);
+        }
+    }
+    ::closedir(dir);
+    std::sort(sequences.begin(), sequences.end());
+#endif
+    return sequences;
+}
+
+} // namespace
+
+EventJournal::EventJournal(std::size_t segmentSize, int maxSegments, int commitIntervalMs)
+    : m_segmentSize(std::max<std::size_t>(segmentSize, 4096))
+    , m_maxSegments(std::max(1, maxSegments))
+    , m_commitIntervalMs(std::max(0, commitIntervalMs))
+    , m_writeOffset(0)
+    , m_directoryDirty(false)
+    , m_stopping(false)
+    , m_appended(0)
+    , m_durable(0)
+    , m_bytes(0)
+    , m_commits(0)
+    , m_segmentCount(0)
+{
+}
+
+EventJournal::~EventJournal() {
+    close();
+}
+
+std::string EventJournal::segmentPath(std::uint64_t sequence) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "journal-%016llx.log", static_cast<unsigned long long>(sequence));
+    return m_directory + "/" + name;
+}
+
+std::shared_ptr<EventJournal::Segment> EventJournal::createSegment(std::uint64_t sequence, std::string* error) {
+    std::string path = segmentPath(sequence);
+    std::remove(path.c_str());
+    
+    std::shared_ptr<Segment> segment = std::make_shared<Segment>();
+    if (!segment->file.open(path, MappedFile::ReadWrite, m_segmentSize, error)) {
+        // Do not leave an empty or short file behind as the next tail
+        std::remove(path.c_str());
+        return nullptr;
+    }
+    
+    segment->sequence = sequence;
+    std::memcpy(segment->file.data(), kSegmentMagic, sizeof(kSegmentMagic));
+    std::memcpy(segment->file.data() + sizeof(kSegmentMagic), &sequence, sizeof(sequence));
+    segment->dirtyBegin = 0;
+    segment->dirtyEnd = kSegmentHeaderSize;
+    return segment;
+}
+
+bool EventJournal::open(const std::string& directory, std::string* error) {
+    close();
+    m_directory = directory;
+    
+    std::vector<std::uint64_t> sequences = listSegments(directory);
+    std::shared_ptr<Segment> tail;
+    
+    if (!sequences.empty()) {
+        tail = std::make_shared<Segment>();
+        tail->sequence = sequences.back();
+        
+        // An empty tail (crash inside createSegment()) cannot be mapped at all
+        if (!tail->file.open(segmentPath(tail->sequence), MappedFile::ReadWrite, 0, nullptr)) {
+            tail.reset();
+        } else if (validSegmentHeader(tail->file.data(), tail->file.size(), tail->sequence)) {
+            char* data = tail->file.data();
+            std::size_t size = tail->file.size();
+            m_writeOffset = scanSegment(data, size, nullptr, nullptr);
+            
+            // Wipe a torn record so it cannot resurface behind the next append
+            if (size - m_writeOffset >= kRecordHeaderSize) {
+                RecordHeader header;
+                std::memcpy(&header, data + m_writeOffset, kRecordHeaderSize);
+                std::size_t torn = header.type == 0 ? kRecordHeaderSize
+                        : std::min<std::size_t>(recordSize(header.length), size - m_writeOffset);
+                std::memset(data + m_writeOffset, 0, torn);
+                tail->dirtyBegin = m_writeOffset;
+                tail->dirtyEnd = m_writeOffset + torn;
+            } else {
+                tail->dirtyBegin = tail->dirtyEnd = m_writeOffset;
+            }
+        } else {
+            // Unreadable tail: keep it for inspection and start a fresh segment
+            tail.reset();
+        }
+    }
+    
+    if (!tail) {
+        std::uint64_t sequence = sequences.empty() ? 1 : sequences.back() + 1;
+        tail = createSegment(sequence, error);
+        if (!tail) {
+            return false;
+        }
+        sequences.push_back(sequence);
+        m_writeOffset = kSegmentHeaderSize;
+        m_directoryDirty = true;
+    }
+    
+    m_segments.assign(sequences.begin(), sequences.end());
+    while (m_segments.size() > static_cast<std::size_t>(m_maxSegments)) {
+        std::remove(segmentPath(m_segments.front()).c_str());
+        m_segments.pop_front();
+    }
+    
+    m_active = tail;
+    m_segmentCount = m_segments.size();
+    m_thread = std::thread([this]() { run(); });
+    return true;
+}
+
+void EventJournal::close() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+    
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_active.reset();
+    m_retired.clear();
+    m_segments.clear();
+    m_stopping = false;
+}
+
+bool EventJournal::append(std::uint32_t type, std::int64_t timeMs, const void* data, std::size_t length) {
+    if (!m_active || type == 0 || recordSize(length) > m_segmentSize - kSegmentHeaderSize) {
+        return false;
+    }
+    
+    std::size_t size = recordSize(length);
+    if (size > m_active->file.size() - m_writeOffset && !rotate()) {
+        return false;
+    }
+    
+    RecordHeader header;
+    header.length = static_cast<std::uint32_t>(length);
+    header.type = type;
+    header.timeMs = timeMs;
+    header.reserved = 0;
+    header.crc = recordCrc(header, static_cast<const char*>(data));
+    
+    char* out = m_active->file.data() + m_writeOffset;
+    std::memcpy(out + kRecordHeaderSize, data, length);
+    std::memcpy(out, &header, kRecordHeaderSize);
+    m_writeOffset += size;
+    
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_active->dirtyEnd = m_writeOffset;
+        ++m_appended;
+        m_bytes += size;
+    }
+    m_wake.notify_one();
+    return true;
+}
+
+bool EventJournal::reserve(std::size_t length) {
+    if (!m_active || recordSize(length) > m_segmentSize - kSegmentHeaderSize) {
+        return false;
+    }
+    return recordSize(length) <= m_active->file.size() - m_writeOffset || rotate();
+}
+
+bool EventJournal::rotate() {
+    std::shared_ptr<Segment> next = createSegment(m_active->sequence + 1, nullptr);
+    if (!next) {
+        return false;
+    }
+    
+    m_segments.push_back(next->sequence);
+    while (m_segments.size() > static_cast<std::size_t>(m_maxSegments)) {
+        std::remove(segmentPath(m_segments.front()).c_str());
+        m_segments.pop_front();
+    }
+    m_writeOffset = kSegmentHeaderSize;
+    
+    // The commit thread still owes the old segment its last sync
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_retired.push_back(m_active);
+    m_active = next;
+    m_directoryDirty = true;
+    m_segmentCount = m_segments.size();
+    return true;
+}
+
+void EventJournal::sync() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_thread.joinable()) {
+        return;
+    }
+    std::uint64_t target = m_appended;
+    m_wake.notify_one();
+    m_committed.wait(lock, [this, target]() { return m_durable >= target || m_stopping; });
+}
+
+void EventJournal::run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wake.wait(lock, [this]() { return m_stopping || m_appended > m_durable || m_directoryDirty; });
+        if (m_stopping && m_appended == m_durable && !m_directoryDirty) {
+            break;
+        }
+        
+        // Group commit: let more appends land before paying for the sync
+        if (m_commitIntervalMs > 0) {
+            m_wake.wait_for(lock, std::chrono::milliseconds(m_commitIntervalMs), [this]() { return m_stopping; });
+        }
+        
+        std::uint64_t upto = m_appended;
+        std::vector<std::shared_ptr<Segment>> targets;
+        targets.swap(m_retired);
+        targets.push_back(m_active);
+        
+        std::vector<std::pair<std::size_t, std::size_t>> ranges;
+        for (const auto& segment : targets) {
+            ranges.push_back(std::make_pair(segment->dirtyBegin, segment->dirtyEnd));
+            segment->dirtyBegin = segment->dirtyEnd;
+        }
+        bool directoryDirty = m_directoryDirty;
+        m_directoryDirty = false;
+        
+        lock.unlock();
+        for (std::size_t i = 0; i < targets.size(); ++i) {
+            if (ranges[i].second > ranges[i].first) {
+                targets[i]->file.sync(ranges[i].first, ranges[i].second - ranges[i].first);
+            }
+        }
+        if (directoryDirty) {
+            MappedFile::syncDirectory(m_directory);
+        }
+        targets.clear();
+        lock.lock();
+        
+        m_durable = upto;
+        ++m_commits;
+        m_committed.notify_all();
+    }
+    m_committed.notify_all();
+}
+
+std::size_t EventJournal::replay(const Visitor& visitor) const {
+    std::size_t records = 0;
+    for (std::uint64_t sequence : m_segments) {
+        if (m_active && sequence == m_active->sequence) {
+            scanSegment(m_active->file.data(), m_writeOffset, &visitor, &records);
+            continue;
+        }
+        
+        MappedFile file;
+        if (file.open(segmentPath(sequence), MappedFile::ReadOnly)
+                && validSegmentHeader(file.data(), file.size(), sequence)) {
+            scanSegment(file.data(), file.size(), &visitor, &records);
+        }
+    }
+    return records;
+}
+
+EventJournal::Stats EventJournal::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats stats;
+    stats.records = m_appended;
+    stats.bytes = m_bytes;
+    stats.commits = m_commits;
+    stats.segments = m_segmentCount;
+    return stats;
+}
+
+} // namespace AsianCryptoPay
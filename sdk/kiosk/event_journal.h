@@ -0,0 +1,184 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * Append-only event journal on memory-mapped, fixed-size segment files.
+ */
+
+#ifndef ASIAN_CRYPTO_PAYMENT_EVENT_JOURNAL_H
+#define ASIAN_CRYPTO_PAYMENT_EVENT_JOURNAL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mapped_file.h"
+
+namespace AsianCryptoPay {
+
+/**
+ * @brief Durable log of typed records
+ *
+ * Records are copied into the mapped tail segment, so append() makes no
+ * system call. A background thread commits in groups: it waits for the
+ * commit interval to collect further appends and then syncs everything
+ * written so far with one msync. Each record carries a CRC-32C, and
+ * replay stops at the first torn or corrupt record.
+ *
+ * When a record does not fit in the tail segment a new one is started; the
+ * oldest segments are deleted once more than the configured number exist.
+ * Callers that need state to outlive retention re-append it after
+ * segmentSequence() changes.
+ *
+ * append() and replay() must be called from one thread; sync() and
+ * stats() are safe from any thread.
+ */
+class EventJournal {
+public:
+    /**
+     * @brief Record visitor for replay(): type, time, payload
+     */
+    typedef std::function<void(std::uint32_t type, std::int64_t timeMs, const char* data, std::size_t length)> Visitor;
+    
+    /**
+     * @brief Counter snapshot
+     */
+    struct Stats {
+        std::uint64_t records = 0;
+        std::uint64_t bytes = 0;
+        std::uint64_t commits = 0;
+        std::uint64_t segments = 0;
+    };
+    
+    /**
+     * @brief Constructor
+     * @param segmentSize Bytes per segment file
+     * @param maxSegments Segment files kept on disk
+     * @param commitIntervalMs How long a commit waits to group further appends
+     */
+    explicit EventJournal(std::size_t segmentSize = 4 * 1024 * 1024, int maxSegments = 16, int commitIntervalMs = 2);
+    
+    /**
+     * @brief Destructor, commits outstanding records
+     */
+    ~EventJournal();
+    
+    EventJournal(const EventJournal&) = delete;
+    EventJournal& operator=(const EventJournal&) = delete;
+    
+    /**
+     * @brief Open or create the journal in a directory
+     *
+     * Existing segments are scanned to find the end of the log; a torn
+     * record at the tail is discarded.
+     *
+     * @param directory Existing directory holding the segment files
+     * @param error Receives a description on failure, may be null
+     * @return Whether the journal is open
+     */
+    bool open(const std::string& directory, std::string* error = nullptr);
+    
+    /**
+     * @brief Commit outstanding records and close the journal
+     */
+    void close();
+    
+    /**
+     * @brief Check if the journal is open
+     * @return Whether open() succeeded
+     */
+    bool isOpen() const { return static_cast<bool>(m_active); }
+    
+    /**
+     * @brief Append a record
+     * @param type Record type, must not be 0
+     * @param timeMs Record time in milliseconds since the epoch
+     * @param data Payload
+     * @param length Payload size; must fit in one segment
+     * @return Whether the record was written
+     */
+    bool append(std::uint32_t type, std::int64_t timeMs, const void* data, std::size_t length);
+    
+    /**
+     * @brief Start the next segment now if a record would not fit in the tail one
+     *
+     * Lets callers re-append state after a rotation but before the record
+     * that caused it, so replay sees that record last.
+     *
+     * @param length Payload size of the record about to be appended
+     * @return False if the record can never fit or the rotation failed
+     */
+    bool reserve(std::size_t length);
+    
+    /**
+     * @brief Wait until every record appended so far is on disk
+     */
+    void sync();
+    
+    /**
+     * @brief Visit every record on disk, oldest first
+     * @param visitor Called for each intact record
+     * @return Number of records visited
+     */
+    std::size_t replay(const Visitor& visitor) const;
+    
+    /**
+     * @brief Get sequence number of the tail segment
+     * @return Sequence, increasing by one per rotation
+     */
+    std::uint64_t segmentSequence() const { return m_active ? m_active->sequence : 0; }
+    
+    /**
+     * @brief Get counters
+     * @return Counter snapshot
+     */
+    Stats stats() const;
+
+private:
+    struct Segment {
+        MappedFile file;
+        std::uint64_t sequence = 0;
+        std::size_t dirtyBegin = 0;
+        std::size_t dirtyEnd = 0;
+    };
+    
+    std::string segmentPath(std::uint64_t sequence) const;
+    std::shared_ptr<Segment> createSegment(std::uint64_t sequence, std::string* error);
+    bool rotate();
+    void run();
+    
+    std::size_t m_segmentSize;
+    int m_maxSegments;
+    int m_commitIntervalMs;
+    std::string m_directory;
+    
+    // Owner thread
+    std::deque<std::uint64_t> m_segments;
+    std::size_t m_writeOffset;
+    
+    // Shared with the commit thread
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_committed;
+    std::shared_ptr<Segment> m_active;
+    std::vector<std::shared_ptr<Segment>> m_retired;
+    bool m_directoryDirty;
+    bool m_stopping;
+    std::uint64_t m_appended;
+    std::uint64_t m_durable;
+    std::uint64_t m_bytes;
+    std::uint64_t m_commits;
+    std::uint64_t m_segmentCount;
+    std::thread m_thread;
+};
+
+} // namespace AsianCryptoPay
+
+#endif // ASIAN_CRYPTO_PAYMENT_EVENT_JOURNAL_H
@@ -0,0 +1,238 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * Exchange rate stream implementation.
+ */
+
+#include "exchange_rate_stream.h"
+#include "asian_crypto_payment.h"
+
+#include <QWebSocket>
+#include <QTimer>
+#include <algorithm>
+
+namespace AsianCryptoPay {
+
+ExchangeRateStream::ExchangeRateStream(AsianCryptoPayment* sdk, QObject* parent)
+    : QObject(parent)
+    , m_sdk(sdk)
+    , m_socket(new QWebSocket(QString(), QWebSocketProtocol::VersionLatest, this))
+    , m_flushTimer(new QTimer(this))
+    , m_reconnectTimer(new QTimer(this))
+    , m_intervalMs(250)
+    , m_backoffMs(0)
+{
+    connect(m_socket, &QWebSocket::connected, this, &ExchangeRateStream::onConnected);
+    connect(m_socket, &QWebSocket::textMessageReceived, this, &ExchangeRateStream::onMessage);
+    // Covers failed handshakes as well as dropped connections
+    connect(m_socket, &QWebSocket::stateChanged, this, [this](QAbstractSocket::SocketState state) {
+        if (state == QAbstractSocket::UnconnectedState) {
+            onDisconnected();
+        }
+    });
+    
+    m_flushTimer->setSingleShot(true);
+    connect(m_flushTimer, &QTimer::timeout, this, &ExchangeRateStream::flush);
+    
+    m_reconnectTimer->setSingleShot(true);
+    connect(m_reconnectTimer, &QTimer::timeout, this, &ExchangeRateStream::reconnect);
+    
+    // REST refreshes reach subscribers too
+    connect(&ExchangeRateCache::instance(), &ExchangeRateCache::ratesUpdated, this, &ExchangeRateStream::onSharedRatesUpdated);
+}
+
+ExchangeRateStream::~ExchangeRateStream() {
+    m_socket->disconnect(this);
+    m_socket->abort();
+}
+
+void ExchangeRateStream::subscribe(const QString& baseCurrency, const QStringList& cryptoCurrencies, int intervalMs) {
+    if (baseCurrency.isEmpty()) {
+        emit m_sdk->error(400, "Base currency is required");
+        return;
+    }
+    
+    QStringList currencies = cryptoCurrencies.isEmpty() ? m_sdk->m_supportedCryptocurrencies : cryptoCurrencies;
+    m_subscriptions[baseCurrency] = currencies;
+    m_intervalMs = qMax(0, intervalMs);
+    
+    // Start from what is cached; the stream only sends changes
+    markDirty(baseCurrency);
+    
+    switch (m_socket->state()) {
+        case QAbstractSocket::ConnectedState:
+            sendSubscription("subscribe", baseCurrency, currencies);
+            break;
+        case QAbstractSocket::UnconnectedState:
+            if (!m_reconnectTimer->isActive()) {
+                reconnect();
+            }
+            break;
+        default:
+            // Sent with the others once connected
+            break;
+    }
+}
+
+void ExchangeRateStream::unsubscribe(const QString& baseCurrency) {
+    if (baseCurrency.isEmpty()) {
+        m_subscriptions.clear();
+    } else if (m_subscriptions.remove(baseCurrency)) {
+        sendSubscription("unsubscribe", baseCurrency, QStringList());
+    }
+    
+    for (auto it = m_published.begin(); it != m_published.end();) {
+        if (m_subscriptions.contains(it.key())) {
+            ++it;
+        } else {
+            it = m_published.erase(it);
+        }
+    }
+    m_dirty.erase(std::remove_if(m_dirty.begin(), m_dirty.end(), [this](const QString& base) {
+        return !m_subscriptions.contains(base);
+    }), m_dirty.end());
+    
+    if (m_subscriptions.isEmpty()) {
+        m_reconnectTimer->stop();
+        m_flushTimer->stop();
+        m_backoffMs = 0;
+        m_socket->close();
+    }
+}
+
+bool ExchangeRateStream::isConnected() const {
+    return m_socket->state() == QAbstractSocket::ConnectedState;
+}
+
+void ExchangeRateStream::sendSubscription(const QString& action, const QString& baseCurrency, const QStringList& cryptoCurrencies) {
+    if (!isConnected()) {
+        return;
+    }
+    
+    QJsonObject message;
+    message["action"] = action;
+    message["fiat"] = baseCurrency;
+    if (!cryptoCurrencies.isEmpty()) {
+        message["crypto"] = QJsonArray::fromStringList(cryptoCurrencies);
+    }
+    m_socket->sendTextMessage(QString::fromUtf8(QJsonDocument(message).toJson(QJsonDocument::Compact)));
+}
+
+void ExchangeRateStream::reconnect() {
+    if (m_subscriptions.isEmpty()) {
+        return;
+    }
+    
+    // Keep subscribed rates servable over REST while the stream is down
+    ExchangeRateCache& cache = ExchangeRateCache::instance();
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (auto it = m_subscriptions.constBegin(); it != m_subscriptions.constEnd(); ++it) {
+        QVariantMap rates;
+        if (cache.lookup(it.key(), it.value(), &rates, now) != ExchangeRateCache::Fresh && cache.beginRefresh(it.key(), now)) {
+            m_sdk->requestExchangeRates(it.key(), it.value(), true);
+        }
+    }
+    
+    // Signed like any other GET, then upgraded
+    QNetworkRequest request = m_sdk->createApiRequest("GET", "exchange-rates/stream");
+    QUrl url = request.url();
+    url.setScheme(url.scheme() == "http" ? "ws" : "wss");
+    request.setUrl(url);
+    m_socket->open(request);
+}
+
+void ExchangeRateStream::onConnected() {
+    m_backoffMs = 0;
+    for (auto it = m_subscriptions.constBegin(); it != m_subscriptions.constEnd(); ++it) {
+        sendSubscription("subscribe", it.key(), it.value());
+    }
+}
+
+void ExchangeRateStream::onDisconnected() {
+    if (m_subscriptions.isEmpty() || m_reconnectTimer->isActive()) {
+        return;
+    }
+    
+    m_backoffMs = m_backoffMs > 0 ? qMin(m_backoffMs * 2, 60000) : 1000;
+    qWarning() << "Exchange rate stream closed:" << m_socket->errorString()
+               << "- reconnecting in" << m_backoffMs << "ms";
+    m_reconnectTimer->start(m_backoffMs);
+}
+
+void ExchangeRateStream::onMessage(const QString& message) {
+    QJsonObject tick = QJsonDocument::fromJson(message.toUtf8()).object();
+    QJsonObject tables = tick["rates"].toObject();
+    
+    ExchangeRateCache& cache = ExchangeRateCache::instance();
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    
+    for (auto it = tables.constBegin(); it != tables.constEnd(); ++it) {
+        auto subscription = m_subscriptions.constFind(it.key());
+        if (subscription == m_subscriptions.constEnd()) {
+            continue;
+        }
+        
+        QJsonObject table = it.value().toObject();
+        QVariantMap rates;
+        for (auto pair = table.constBegin(); pair != table.constEnd(); ++pair) {
+            double rate = ExchangeRateCache::parseRate(pair.value());
+            if (rate > 0.0 && subscription.value().contains(pair.key())) {
+                rates[pair.key()] = rate;
+            }
+        }
+        if (rates.isEmpty()) {
+            continue;
+        }
+        
+        cache.store(it.key(), rates, now);
+        m_sdk->m_snapshotDirty = true;
+        markDirty(it.key());
+    }
+}
+
+void ExchangeRateStream::onSharedRatesUpdated(const QString& baseCurrency) {
+    if (m_subscriptions.contains(baseCurrency)) {
+        markDirty(baseCurrency);
+    }
+}
+
+void ExchangeRateStream::markDirty(const QString& baseCurrency) {
+    if (!m_dirty.contains(baseCurrency)) {
+        m_dirty << baseCurrency;
+    }
+    // Started by the first change after a flush, so emissions are at least an interval apart
+    if (!m_flushTimer->isActive()) {
+        m_flushTimer->start(m_intervalMs);
+    }
+}
+
+void ExchangeRateStream::flush() {
+    QStringList dirty;
+    dirty.swap(m_dirty);
+    
+    for (const QString& base : dirty) {
+        auto subscription = m_subscriptions.constFind(base);
+        if (subscription == m_subscriptions.constEnd()) {
+            continue;
+        }
+        
+        // Only the latest value of each pair since the previous emission
+        QVariantMap table = ExchangeRateCache::instance().rates(base);
+        QVariantMap& published = m_published[base];
+        QVariantMap changed;
+        for (const QString& crypto : subscription.value()) {
+            auto rate = table.constFind(crypto);
+            if (rate != table.constEnd() && published.value(crypto) != rate.value()) {
+                published[crypto] = rate.value();
+                changed[crypto] = rate.value();
+            }
+        }
+        
+        if (!changed.isEmpty()) {
+            emit ratesUpdated(base, changed);
+        }
+    }
+}
+
+} // namespace AsianCryptoPay
@@ -0,0 +1,115 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * Optional pushed exchange rate subscription. Kept out of the SDK core so
+ * only integrators that build and link it need Qt WebSockets.
+ */
+
+#ifndef ASIAN_CRYPTO_PAYMENT_EXCHANGE_RATE_STREAM_H
+#define ASIAN_CRYPTO_PAYMENT_EXCHANGE_RATE_STREAM_H
+
+#include <QObject>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+
+class QTimer;
+class QWebSocket;
+
+namespace AsianCryptoPay {
+
+class AsianCryptoPayment;
+
+/**
+ * @brief Pushed exchange rate ticks feeding the shared ExchangeRateCache
+ *
+ * Opens one WebSocket to exchange-rates/stream, signed with the SDK's
+ * credentials. Ticks use the exchange-rates/all shape and carry only the
+ * pairs that changed; each is applied to the shared ExchangeRateCache on
+ * arrival, so getExchangeRates() and local quotes stay fresh without
+ * polling. Changes, including those from REST refreshes, are coalesced per
+ * base currency and emitted through ratesUpdated() at most once per
+ * interval. A dropped stream is reopened with backoff, and stale subscribed
+ * rates are fetched over REST meanwhile.
+ *
+ * Must live in the SDK's thread.
+ *
+ * Example:
+ * @code
+ * ExchangeRateStream stream(&sdk);
+ * stream.subscribe("MYR", QStringList() << "BTC" << "USDT");
+ * @endcode
+ */
+class ExchangeRateStream : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor
+     * @param sdk SDK instance whose endpoint and credentials are used
+     * @param parent Parent object
+     */
+    explicit ExchangeRateStream(AsianCryptoPayment* sdk, QObject* parent = nullptr);
+    
+    /**
+     * @brief Destructor, closes the stream
+     */
+    ~ExchangeRateStream();
+    
+    /**
+     * @brief Follow a base currency; subscribing again replaces its cryptocurrencies
+     * @param baseCurrency Fiat base currency
+     * @param cryptoCurrencies Cryptocurrencies to follow (defaults to the SDK's supported ones)
+     * @param intervalMs Minimum time between ratesUpdated() rounds, shared by all base currencies
+     */
+    void subscribe(const QString& baseCurrency, const QStringList& cryptoCurrencies = QStringList(),
+            int intervalMs = 250);
+    
+    /**
+     * @brief Stop following a base currency; the stream closes with the last one
+     * @param baseCurrency Fiat base currency, empty for all
+     */
+    void unsubscribe(const QString& baseCurrency = QString());
+    
+    /**
+     * @brief Check if connected
+     * @return Whether the WebSocket is open
+     */
+    bool isConnected() const;
+
+signals:
+    /**
+     * @brief Emitted at most once per interval while subscribed
+     * @param baseCurrency Fiat base currency
+     * @param changedRates Fiat per unit of each cryptocurrency that changed since the previous emission
+     */
+    void ratesUpdated(const QString& baseCurrency, const QVariantMap& changedRates);
+
+private slots:
+    void onConnected();
+    void onDisconnected();
+    void onMessage(const QString& message);
+    void onSharedRatesUpdated(const QString& baseCurrency);
+    void flush();
+    void reconnect();
+
+private:
+    void sendSubscription(const QString& action, const QString& baseCurrency, const QStringList& cryptoCurrencies);
+    void markDirty(const QString& baseCurrency);
+    
+    AsianCryptoPayment* m_sdk;
+    QWebSocket* m_socket;
+    QTimer* m_flushTimer;
+    QTimer* m_reconnectTimer;
+    QHash<QString, QStringList> m_subscriptions;    ///< Cryptocurrencies followed per base currency
+    QHash<QString, QVariantMap> m_published;        ///< Rates last emitted per base currency
+    QStringList m_dirty;                            ///< Base currencies with unemitted changes
+    int m_intervalMs;
+    int m_backoffMs;
+};
+
+} // namespace AsianCryptoPay
+
+#endif // ASIAN_CRYPTO_PAYMENT_EXCHANGE_RATE_STREAM_H
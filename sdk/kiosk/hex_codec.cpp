@@ -0,0 +1,201 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * Hex codec implementation. The SSE2 path is used on every x86-64 CPU; the
+ * AVX2 path is compiled with a target attribute and chosen at runtime, so
+ * the SDK does not need to be built with -mavx2.
+ */
+
+#include "hex_codec.h"
+
+#if (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__))) && (defined(__GNUC__) || defined(__clang__))
+#define ACP_HEX_X86 1
+#include <immintrin.h>
+#endif
+
+namespace AsianCryptoPay {
+
+namespace {
+
+const char kHexDigits[] = "0123456789abcdef";
+
+inline int hexValue(unsigned char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    c |= 0x20;
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+void encodeScalar(const unsigned char* data, std::size_t length, char* out) {
+    for (std::size_t i = 0; i < length; ++i) {
+        out[2 * i] = kHexDigits[data[i] >> 4];
+        out[2 * i + 1] = kHexDigits[data[i] & 0x0F];
+    }
+}
+
+bool decodeScalar(const char* hex, std::size_t length, unsigned char* out) {
+    int invalid = 0;
+    for (std::size_t i = 0; i < length / 2; ++i) {
+        int hi = hexValue(static_cast<unsigned char>(hex[2 * i]));
+        int lo = hexValue(static_cast<unsigned char>(hex[2 * i + 1]));
+        invalid |= hi | lo;
+        out[i] = static_cast<unsigned char>(((hi & 0x0F) << 4) | (lo & 0x0F));
+    }
+    return invalid >= 0;
+}
+
+#ifdef ACP_HEX_X86
+
+// Nibbles 0-15 to ASCII: '0' + n, plus ('a' - '0' - 10) when n > 9
+inline __m128i nibblesToAscii(__m128i nibbles) {
+    __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)), _mm_set1_epi8('a' - '0' - 10));
+    return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letters);
+}
+
+// ASCII hex to nibble values; clears *valid bits for non-hex characters.
+// Byte subtraction wraps, which keeps the range checks exact for any input.
+inline __m128i asciiToNibbles(__m128i chars, int* validMask) {
+    __m128i digit = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+    __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(digit, _mm_set1_epi8(-1)), _mm_cmplt_epi8(digit, _mm_set1_epi8(10)));
+    __m128i alpha = _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    __m128i isAlpha = _mm_and_si128(_mm_cmpgt_epi8(alpha, _mm_set1_epi8(-1)), _mm_cmplt_epi8(alpha, _mm_set1_epi8(6)));
+    *validMask &= _mm_movemask_epi8(_mm_or_si128(isDigit, isAlpha));
+    __m128i alphaValue = _mm_add_epi8(alpha, _mm_set1_epi8(10));
+    return _mm_or_si128(_mm_and_si128(isDigit, digit), _mm_and_si128(isAlpha, alphaValue));
+}
+
+// Pairs of nibbles (high first) in 16-bit lanes to one byte per lane
+inline __m128i combineNibbles(__m128i nibbles) {
+    __m128i high = _mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00FF)), 4);
+    __m128i low = _mm_srli_epi16(nibbles, 8);
+    return _mm_or_si128(high, low);
+}
+
+void encodeSse2(const unsigned char* data, std::size_t length, char* out) {
+    std::size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), _mm_set1_epi8(0x0F));
+        __m128i low = _mm_and_si128(bytes, _mm_set1_epi8(0x0F));
+        __m128i hexHigh = nibblesToAscii(high);
+        __m128i hexLow = nibblesToAscii(low);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i), _mm_unpacklo_epi8(hexHigh, hexLow));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i + 16), _mm_unpackhi_epi8(hexHigh, hexLow));
+    }
+    encodeScalar(data + i, length - i, out + 2 * i);
+}
+
+bool decodeSse2(const char* hex, std::size_t length, unsigned char* out) {
+    std::size_t i = 0;
+    int validMask = 0xFFFF;
+    for (; i + 32 <= length; i += 32) {
+        __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hex + i));
+        __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hex + i + 16));
+        __m128i bytesFirst = combineNibbles(asciiToNibbles(first, &validMask));
+        __m128i bytesSecond = combineNibbles(asciiToNibbles(second, &validMask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i / 2), _mm_packus_epi16(bytesFirst, bytesSecond));
+    }
+    bool tailValid = decodeScalar(hex + i, length - i, out + i / 2);
+    return validMask == 0xFFFF && tailValid;
+}
+
+__attribute__((target("avx2")))
+inline __m256i nibblesToAscii256(__m256i nibbles) {
+    __m256i letters = _mm256_and_si256(_mm256_cmpgt_epi8(nibbles, _mm256_set1_epi8(9)), _mm256_set1_epi8('a' - '0' - 10));
+    return _mm256_add_epi8(_mm256_add_epi8(nibbles, _mm256_set1_epi8('0')), letters);
+}
+
+__attribute__((target("avx2")))
+void encodeAvx2(const unsigned char* data, std::size_t length, char* out) {
+    std::size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i high = _mm256_and_si256(_mm256_srli_epi16(bytes, 4), _mm256_set1_epi8(0x0F));
+        __m256i low = _mm256_and_si256(bytes, _mm256_set1_epi8(0x0F));
+        __m256i hexHigh = nibblesToAscii256(high);
+        __m256i hexLow = nibblesToAscii256(low);
+        // Unpack works per 128-bit lane; reorder lanes to restore byte order
+        __m256i mixedLow = _mm256_unpacklo_epi8(hexHigh, hexLow);
+        __m256i mixedHigh = _mm256_unpackhi_epi8(hexHigh, hexLow);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i), _mm256_permute2x128_si256(mixedLow, mixedHigh, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i + 32), _mm256_permute2x128_si256(mixedLow, mixedHigh, 0x31));
+    }
+    encodeSse2(data + i, length - i, out + 2 * i);
+}
+
+__attribute__((target("avx2")))
+bool decodeAvx2(const char* hex, std::size_t length, unsigned char* out) {
+    std::size_t i = 0;
+    unsigned int validMask = 0xFFFFFFFFu;
+    for (; i + 64 <= length; i += 64) {
+        __m256i bytesPair[2];
+        for (int half = 0; half < 2; ++half) {
+            __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hex + i + 32 * half));
+            __m256i digit = _mm256_sub_epi8(chars, _mm256_set1_epi8('0'));
+            __m256i isDigit = _mm256_and_si256(_mm256_cmpgt_epi8(digit, _mm256_set1_epi8(-1)), _mm256_cmpgt_epi8(_mm256_set1_epi8(10), digit));
+            __m256i alpha = _mm256_sub_epi8(_mm256_or_si256(chars, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+            __m256i isAlpha = _mm256_and_si256(_mm256_cmpgt_epi8(alpha, _mm256_set1_epi8(-1)), _mm256_cmpgt_epi8(_mm256_set1_epi8(6), alpha));
+            validMask &= static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_or_si256(isDigit, isAlpha)));
+            __m256i nibbles = _mm256_or_si256(_mm256_and_si256(isDigit, digit),
+                                              _mm256_and_si256(isAlpha, _mm256_add_epi8(alpha, _mm256_set1_epi8(10))));
+            __m256i high = _mm256_slli_epi16(_mm256_and_si256(nibbles, _mm256_set1_epi16(0x00FF)), 4);
+            __m256i low = _mm256_srli_epi16(nibbles, 8);
+            bytesPair[half] = _mm256_or_si256(high, low);
+        }
+        // Pack works per 128-bit lane; 0xD8 restores qword order 0, 2, 1, 3
+        __m256i packed = _mm256_packus_epi16(bytesPair[0], bytesPair[1]);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i / 2), _mm256_permute4x64_epi64(packed, 0xD8));
+    }
+    bool tailValid = decodeSse2(hex + i, length - i, out + i / 2);
+    return validMask == 0xFFFFFFFFu && tailValid;
+}
+
+bool hasAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+#endif // ACP_HEX_X86
+
+} // namespace
+
+void HexCodec::encode(const unsigned char* data, std::size_t length, char* out) {
+#ifdef ACP_HEX_X86
+    if (hasAvx2()) {
+        encodeAvx2(data, length, out);
+    } else {
+        encodeSse2(data, length, out);
+    }
+#else
+    encodeScalar(data, length, out);
+#endif
+}
+
+bool HexCodec::decode(const char* hex, std::size_t length, unsigned char* out) {
+    if (length % 2 != 0) {
+        return false;
+    }
+#ifdef ACP_HEX_X86
+    if (hasAvx2()) {
+        return decodeAvx2(hex, length, out);
+    }
+    return decodeSse2(hex, length, out);
+#else
+    return decodeScalar(hex, length, out);
+#endif
+}
+
+const char* HexCodec::implementation() {
+#ifdef ACP_HEX_X86
+    return hasAvx2() ? "avx2" : "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace AsianCryptoPay
@@ -0,0 +1,63 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * Hex encoding for signatures and digests, with SSE2/AVX2 paths selected
+ * at runtime and a portable scalar fallback.
+ */
+
+#ifndef ASIAN_CRYPTO_PAYMENT_HEX_CODEC_H
+#define ASIAN_CRYPTO_PAYMENT_HEX_CODEC_H
+
+#include <cstddef>
+
+namespace AsianCryptoPay {
+
+/**
+ * @brief Hex encoding and constant-time comparison helpers
+ */
+class HexCodec {
+public:
+    /**
+     * @brief Encode bytes as lowercase hex
+     * @param data Input bytes
+     * @param length Input length
+     * @param out Receives 2 * length characters (not null-terminated)
+     */
+    static void encode(const unsigned char* data, std::size_t length, char* out);
+    
+    /**
+     * @brief Decode hex, accepting upper and lower case
+     * @param hex Input characters
+     * @param length Input length, must be even
+     * @param out Receives length / 2 bytes
+     * @return Whether the input was valid hex
+     */
+    static bool decode(const char* hex, std::size_t length, unsigned char* out);
+    
+    /**
+     * @brief Compare two buffers in time independent of their contents
+     * @param a First buffer
+     * @param b Second buffer
+     * @param length Number of bytes to compare
+     * @return Whether the buffers are equal
+     */
+    static bool constantTimeEquals(const unsigned char* a, const unsigned char* b, std::size_t length) {
+        unsigned int diff = 0;
+        for (std::size_t i = 0; i < length; ++i) {
+            diff |= static_cast<unsigned int>(a[i] ^ b[i]);
+        }
+        // 1 if diff == 0, else 0, without a data-dependent branch
+        return ((diff - 1u) >> 8) & 1u;
+    }
+    
+    /**
+     * @brief Name of the implementation selected for this CPU
+     * @return "avx2", "sse2" or "scalar"
+     */
+    static const char* implementation();
+};
+
+} // namespace AsianCryptoPay
+
+#endif // ASIAN_CRYPTO_PAYMENT_HEX_CODEC_H
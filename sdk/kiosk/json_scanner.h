@@ -0,0 +1,308 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * Minimal forward-only JSON scanner. It records the byte ranges of values
+ * inside a response buffer without building a document tree, so callers can
+ * decode only the fields they actually read.
+ */
+
+#ifndef ASIAN_CRYPTO_PAYMENT_JSON_SCANNER_H
+#define ASIAN_CRYPTO_PAYMENT_JSON_SCANNER_H
+
+#include <cstring>
+
+namespace AsianCryptoPay {
+
+/**
+ * @brief Byte range of a JSON value inside a buffer
+ */
+struct JsonSpan {
+    int begin = -1;
+    int end = -1;
+    
+    /**
+     * @brief Check if the span points at a value
+     * @return Whether the span is valid
+     */
+    bool isValid() const { return begin >= 0 && end > begin; }
+    
+    /**
+     * @brief Get span length in bytes
+     * @return Length
+     */
+    int length() const { return isValid() ? end - begin : 0; }
+};
+
+/**
+ * @brief Forward-only JSON scanner over a raw byte buffer
+ *
+ * The scanner validates structure only as far as needed to find value
+ * boundaries; string contents and numbers are left undecoded.
+ */
+class JsonScanner {
+public:
+    /**
+     * @brief Constructor
+     * @param data Buffer start
+     * @param size Buffer size in bytes
+     */
+    JsonScanner(const char* data, int size) : m_data(data), m_size(size) {}
+    
+    /**
+     * @brief Get buffer start
+     * @return Buffer start
+     */
+    const char* data() const { return m_data; }
+    
+    /**
+     * @brief Get buffer size
+     * @return Buffer size in bytes
+     */
+    int size() const { return m_size; }
+    
+    /**
+     * @brief Skip whitespace
+     * @param pos Position, advanced past whitespace
+     */
+    void skipWhitespace(int& pos) const {
+        while (pos < m_size) {
+            char c = m_data[pos];
+            if (c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+                break;
+            }
+            ++pos;
+        }
+    }
+    
+    /**
+     * @brief Skip a string starting at an opening quote
+     * @param pos Position of the opening quote, advanced past the closing quote
+     * @param hasEscape Set if the string contains escape sequences
+     * @return Whether a complete string was found
+     */
+    bool skipString(int& pos, bool* hasEscape = nullptr) const {
+        if (pos >= m_size || m_data[pos] != '"') {
+            return false;
+        }
+        
+        ++pos;
+        while (pos < m_size) {
+            char c = m_data[pos];
+            if (c == '"') {
+                ++pos;
+                return true;
+            }
+            if (c == '\\') {
+                if (hasEscape) {
+                    *hasEscape = true;
+                }
+                pos += 2;
+                continue;
+            }
+            ++pos;
+        }
+        
+        return false;
+    }
+    
+    /**
+     * @brief Skip any JSON value
+     * @param pos Position of the value, advanced past it
+     * @param span Receives the value range, including quotes or brackets
+     * @return Whether a complete value was found
+     */
+    bool skipValue(int& pos, JsonSpan* span = nullptr) const {
+        skipWhitespace(pos);
+        if (pos >= m_size) {
+            return false;
+        }
+        
+        int begin = pos;
+        char c = m_data[pos];
+        
+        if (c == '"') {
+            if (!skipString(pos)) {
+                return false;
+            }
+        } else if (c == '{' || c == '[') {
+            int depth = 0;
+            while (pos < m_size) {
+                c = m_data[pos];
+                if (c == '"') {
+                    if (!skipString(pos)) {
+                        return false;
+                    }
+                    continue;
+                }
+                if (c == '{' || c == '[') {
+                    ++depth;
+                } else if (c == '}' || c == ']') {
+                    if (--depth == 0) {
+                        ++pos;
+                        break;
+                    }
+                }
+                ++pos;
+            }
+            if (depth != 0) {
+                return false;
+            }
+        } else {
+            while (pos < m_size) {
+                c = m_data[pos];
+                if (c == ',' || c == '}' || c == ']' || c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+                    break;
+                }
+                ++pos;
+            }
+            if (pos == begin) {
+                return false;
+            }
+        }
+        
+        if (span) {
+            span->begin = begin;
+            span->end = pos;
+        }
+        
+        return true;
+    }
+    
+    /**
+     * @brief Visit the members of an object
+     * @param pos Position of the opening brace, advanced past the closing brace
+     * @param visitor Called as visitor(keyData, keyLength, valueSpan) for each member;
+     *        returning false stops the scan early without error
+     * @return Whether the object was well-formed up to where scanning stopped
+     */
+    template <typename Visitor>
+    bool forEachMember(int& pos, Visitor&& visitor) const {
+        skipWhitespace(pos);
+        if (pos >= m_size || m_data[pos] != '{') {
+            return false;
+        }
+        
+        ++pos;
+        skipWhitespace(pos);
+        if (pos < m_size && m_data[pos] == '}') {
+            ++pos;
+            return true;
+        }
+        
+        while (pos < m_size) {
+            int keyBegin = pos;
+            if (!skipString(pos)) {
+                return false;
+            }
+            int keyEnd = pos;
+            
+            skipWhitespace(pos);
+            if (pos >= m_size || m_data[pos] != ':') {
+                return false;
+            }
+            ++pos;
+            
+            JsonSpan value;
+            if (!skipValue(pos, &value)) {
+                return false;
+            }
+            
+            if (!visitor(m_data + keyBegin + 1, keyEnd - keyBegin - 2, value)) {
+                return true;
+            }
+            
+            skipWhitespace(pos);
+            if (pos >= m_size) {
+                return false;
+            }
+            if (m_data[pos] == '}') {
+                ++pos;
+                return true;
+            }
+            if (m_data[pos] != ',') {
+                return false;
+            }
+            ++pos;
+            skipWhitespace(pos);
+        }
+        
+        return false;
+    }
+    
+    /**
+     * @brief Visit the elements of an array
+     * @param pos Position of the opening bracket, advanced past the closing bracket
+     * @param visitor Called as visitor(valueSpan) for each element; returning
+     *        false aborts the scan as an error
+     * @return Whether the array was well-formed
+     */
+    template <typename Visitor>
+    bool forEachElement(int& pos, Visitor&& visitor) const {
+        skipWhitespace(pos);
+        if (pos >= m_size || m_data[pos] != '[') {
+            return false;
+        }
+        
+        ++pos;
+        skipWhitespace(pos);
+        if (pos < m_size && m_data[pos] == ']') {
+            ++pos;
+            return true;
+        }
+        
+        while (pos < m_size) {
+            JsonSpan value;
+            if (!skipValue(pos, &value)) {
+                return false;
+            }
+            
+            if (!visitor(value)) {
+                return false;
+            }
+            
+            skipWhitespace(pos);
+            if (pos >= m_size) {
+                return false;
+            }
+            if (m_data[pos] == ']') {
+                ++pos;
+                return true;
+            }
+            if (m_data[pos] != ',') {
+                return false;
+            }
+            ++pos;
+        }
+        
+        return false;
+    }
+    
+    /**
+     * @brief Check if a span holds a string
+     * @param span Value span
+     * @return Whether the value is a JSON string
+     */
+    bool isString(const JsonSpan& span) const {
+        return span.isValid() && m_data[span.begin] == '"';
+    }
+    
+    /**
+     * @brief Compare raw key bytes against a literal
+     * @param key Key data
+     * @param length Key length
+     * @param literal Null-terminated literal
+     * @return Whether they are equal
+     */
+    static bool keyEquals(const char* key, int length, const char* literal) {
+        return static_cast<int>(std::strlen(literal)) == length && std::memcmp(key, literal, length) == 0;
+    }
+
+private:
+    const char* m_data;
+    int m_size;
+};
+
+} // namespace AsianCryptoPay
+
+#endif // ASIAN_CRYPTO_PAYMENT_JSON_SCANNER_H
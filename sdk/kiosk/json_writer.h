@@ -0,0 +1,201 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * Append-only JSON writer used to build request bodies directly into a
+ * byte buffer, without going through QJsonObject.
+ */
+
+#ifndef ASIAN_CRYPTO_PAYMENT_JSON_WRITER_H
+#define ASIAN_CRYPTO_PAYMENT_JSON_WRITER_H
+
+#include <QByteArray>
+#include <QString>
+#include <cstring>
+
+namespace AsianCryptoPay {
+
+/**
+ * @brief Compact JSON writer
+ *
+ * Output matches QJsonDocument::Compact formatting. The writer does not
+ * validate call order; members must be written inside an open object.
+ */
+class JsonWriter {
+public:
+    /**
+     * @brief Constructor
+     * @param reserve Initial buffer capacity in bytes
+     */
+    explicit JsonWriter(int reserve = 256) {
+        m_buffer.reserve(reserve);
+    }
+    
+    /**
+     * @brief Open an object, as a value or at top level
+     */
+    void beginObject() {
+        m_buffer.append('{');
+        ++m_depth;
+        m_first |= (1ull << m_depth);
+    }
+    
+    /**
+     * @brief Close the innermost object
+     */
+    void endObject() {
+        m_buffer.append('}');
+        m_first &= ~(1ull << m_depth);
+        --m_depth;
+    }
+    
+    /**
+     * @brief Write a member name given as plain ASCII
+     * @param name Member name, must not need escaping
+     */
+    void key(const char* name) {
+        rawKey(name, static_cast<int>(std::strlen(name)));
+    }
+    
+    /**
+     * @brief Write a member name that is already JSON-escaped
+     * @param data Escaped UTF-8 bytes
+     * @param length Byte count
+     */
+    void rawKey(const char* data, int length) {
+        separator();
+        m_buffer.append('"');
+        m_buffer.append(data, length);
+        m_buffer.append("\":", 2);
+    }
+    
+    /**
+     * @brief Write a string value
+     * @param value String value
+     */
+    void stringValue(const QString& value) {
+        QByteArray utf8 = value.toUtf8();
+        m_buffer.append('"');
+        appendEscaped(m_buffer, utf8.constData(), utf8.size());
+        m_buffer.append('"');
+    }
+    
+    /**
+     * @brief Write a string value that is already JSON-escaped
+     * @param data Escaped UTF-8 bytes
+     * @param length Byte count
+     */
+    void rawStringValue(const char* data, int length) {
+        m_buffer.append('"');
+        m_buffer.append(data, length);
+        m_buffer.append('"');
+    }
+    
+    /**
+     * @brief Write a literal JSON value (number, boolean, object, ...)
+     * @param data Compact JSON bytes
+     * @param length Byte count
+     */
+    void rawValue(const char* data, int length) {
+        m_buffer.append(data, length);
+    }
+    
+    /**
+     * @brief Write a string member
+     * @param name Member name
+     * @param value String value
+     */
+    void member(const char* name, const QString& value) {
+        key(name);
+        stringValue(value);
+    }
+    
+    /**
+     * @brief Write a boolean member
+     * @param name Member name
+     * @param value Boolean value
+     */
+    void member(const char* name, bool value) {
+        key(name);
+        if (value) {
+            m_buffer.append("true", 4);
+        } else {
+            m_buffer.append("false", 5);
+        }
+    }
+    
+    /**
+     * @brief Write a decimal amount member as a fixed-precision string
+     * @param name Member name
+     * @param value Amount
+     * @param precision Digits after the decimal point
+     */
+    void amountMember(const char* name, double value, int precision = 8) {
+        key(name);
+        m_buffer.append('"');
+        m_buffer.append(QByteArray::number(value, 'f', precision));
+        m_buffer.append('"');
+    }
+    
+    /**
+     * @brief Get written bytes
+     * @return JSON bytes
+     */
+    const QByteArray& data() const { return m_buffer; }
+    
+    /**
+     * @brief Append a JSON-escaped copy of UTF-8 bytes
+     * @param out Output buffer
+     * @param data UTF-8 bytes
+     * @param length Byte count
+     */
+    static void appendEscaped(QByteArray& out, const char* data, int length) {
+        static const char hex[] = "0123456789abcdef";
+        int runStart = 0;
+        
+        for (int i = 0; i < length; ++i) {
+            unsigned char c = static_cast<unsigned char>(data[i]);
+            if (c >= 0x20 && c != '"' && c != '\\') {
+                continue;
+            }
+            
+            out.append(data + runStart, i - runStart);
+            runStart = i + 1;
+            
+            switch (c) {
+                case '"': out.append("\\\"", 2); break;
+                case '\\': out.append("\\\\", 2); break;
+                case '\n': out.append("\\n", 2); break;
+                case '\r': out.append("\\r", 2); break;
+                case '\t': out.append("\\t", 2); break;
+                case '\b': out.append("\\b", 2); break;
+                case '\f': out.append("\\f", 2); break;
+                default: {
+                    char escape[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF] };
+                    out.append(escape, 6);
+                    break;
+                }
+            }
+        }
+        
+        out.append(data + runStart, length - runStart);
+    }
+
+private:
+    void separator() {
+        quint64 bit = 1ull << m_depth;
+        if (m_first & bit) {
+            m_first &= ~bit;
+        } else {
+            m_buffer.append(',');
+        }
+    }
+    
+    QByteArray m_buffer;
+    quint64 m_first = 0;
+    int m_depth = 0;
+};
+
+} // namespace AsianCryptoPay
+
+#endif // ASIAN_CRYPTO_PAYMENT_JSON_WRITER_H
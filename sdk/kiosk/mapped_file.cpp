@@ -0,0 +1,175 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * Memory-mapped file implementation.
+ */
+
+#include "mapped_file.h"
+
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ACP_HAVE_MMAP 1
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace AsianCryptoPay {
+
+namespace {
+
+void setError(std::string* error, const std::string& what) {
+    if (error) {
+#ifdef ACP_HAVE_MMAP
+        *error = what + ": " + std::strerror(errno);
+#else
+        *error = what;
+#endif
+    }
+}
+
+} // namespace
+
+MappedFile::MappedFile()
+    : m_fd(-1)
+    , m_data(nullptr)
+    , m_size(0)
+{
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+#ifdef ACP_HAVE_MMAP
+
+bool MappedFile::open(const std::string& path, Mode mode, std::size_t size, std::string* error) {
+    close();
+    
+    int fd = ::open(path.c_str(), mode == ReadWrite ? O_RDWR | O_CREAT | O_CLOEXEC : O_RDONLY | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        setError(error, "open " + path);
+        return false;
+    }
+    
+    struct stat info;
+    if (::fstat(fd, &info) < 0) {
+        setError(error, "stat " + path);
+        ::close(fd);
+        return false;
+    }
+    
+    std::size_t fileSize = static_cast<std::size_t>(info.st_size);
+    if (fileSize < size && mode == ReadWrite) {
+        if (::ftruncate(fd, static_cast<off_t>(size)) < 0) {
+            setError(error, "truncate " + path);
+            ::close(fd);
+            return false;
+        }
+        fileSize = size;
+    }
+    if (fileSize == 0 || fileSize < size) {
+        if (error) {
+            *error = path + ": file too small";
+        }
+        ::close(fd);
+        return false;
+    }
+    
+    int protection = mode == ReadWrite ? PROT_READ | PROT_WRITE : PROT_READ;
+    void* data = ::mmap(nullptr, fileSize, protection, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        setError(error, "mmap " + path);
+        ::close(fd);
+        return false;
+    }
+    
+    m_fd = fd;
+    m_data = static_cast<char*>(data);
+    m_size = fileSize;
+    return true;
+}
+
+void MappedFile::close() {
+    if (m_data) {
+        ::munmap(m_data, m_size);
+        m_data = nullptr;
+        m_size = 0;
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+bool MappedFile::resize(std::size_t size) {
+    if (!m_data || size == 0) {
+        return false;
+    }
+    if (::ftruncate(m_fd, static_cast<off_t>(size)) < 0) {
+        return false;
+    }
+    
+    void* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    ::munmap(m_data, m_size);
+    m_data = static_cast<char*>(data);
+    m_size = size;
+    return true;
+}
+
+bool MappedFile::sync(std::size_t offset, std::size_t length) {
+    if (!m_data || offset >= m_size || length == 0) {
+        return m_data != nullptr;
+    }
+    if (length > m_size - offset) {
+        length = m_size - offset;
+    }
+    
+    // msync wants a page-aligned start
+    std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    std::size_t begin = offset - offset % page;
+    return ::msync(m_data + begin, offset + length - begin, MS_SYNC) == 0;
+}
+
+bool MappedFile::syncDirectory(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+}
+
+#else
+
+bool MappedFile::open(const std::string& path, Mode, std::size_t, std::string* error) {
+    setError(error, path + ": memory-mapped files are not supported on this platform");
+    return false;
+}
+
+void MappedFile::close() {
+}
+
+bool MappedFile::resize(std::size_t) {
+    return false;
+}
+
+bool MappedFile::sync(std::size_t, std::size_t) {
+    return false;
+}
+
+bool MappedFile::syncDirectory(const std::string&) {
+    return false;
+}
+
+#endif
+
+} // namespace AsianCryptoPay
@@ -0,0 +1,117 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * Memory-mapped file used by the on-disk stores.
+ */
+
+#ifndef ASIAN_CRYPTO_PAYMENT_MAPPED_FILE_H
+#define ASIAN_CRYPTO_PAYMENT_MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+namespace AsianCryptoPay {
+
+/**
+ * @brief Shared mapping of a whole file
+ *
+ * Writes go straight to the page cache; sync() makes a range durable.
+ * Available on POSIX systems; open() fails elsewhere.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Access mode
+     */
+    enum Mode {
+        ReadOnly,
+        ReadWrite   ///< Creates the file if missing
+    };
+    
+    /**
+     * @brief Constructor
+     */
+    MappedFile();
+    
+    /**
+     * @brief Destructor, unmaps without syncing
+     */
+    ~MappedFile();
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    /**
+     * @brief Map a file
+     * @param path File path
+     * @param mode Access mode
+     * @param size Minimum size; ReadWrite files are grown with zeros to reach it
+     * @param error Receives a description on failure, may be null
+     * @return Whether the file is mapped
+     */
+    bool open(const std::string& path, Mode mode, std::size_t size = 0, std::string* error = nullptr);
+    
+    /**
+     * @brief Unmap and close
+     */
+    void close();
+    
+    /**
+     * @brief Check if a file is mapped
+     * @return Whether open() succeeded
+     */
+    bool isOpen() const { return m_data != nullptr; }
+    
+    /**
+     * @brief Get mapped bytes
+     * @return Start of the mapping
+     */
+    char* data() { return m_data; }
+    
+    /**
+     * @brief Get mapped bytes
+     * @return Start of the mapping
+     */
+    const char* data() const { return m_data; }
+    
+    /**
+     * @brief Get mapping size
+     * @return Size in bytes
+     */
+    std::size_t size() const { return m_size; }
+    
+    /**
+     * @brief Grow or shrink a ReadWrite file and remap it
+     *
+     * Pointers into the old mapping are invalid afterwards.
+     *
+     * @param size New size in bytes
+     * @return Whether the file was resized
+     */
+    bool resize(std::size_t size);
+    
+    /**
+     * @brief Write a range back to disk and wait for it
+     * @param offset First byte
+     * @param length Number of bytes
+     * @return Whether the range is durable
+     */
+    bool sync(std::size_t offset, std::size_t length);
+    
+    /**
+     * @brief Make file creations and removals in a directory durable
+     * @param path Directory path
+     * @return Whether the directory was synced
+     */
+    static bool syncDirectory(const std::string& path);
+
+private:
+    int m_fd;
+    char* m_data;
+    std::size_t m_size;
+};
+
+} // namespace AsianCryptoPay
+
+#endif // ASIAN_CRYPTO_PAYMENT_MAPPED_FILE_H
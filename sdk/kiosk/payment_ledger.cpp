@@ -0,0 +1,482 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * Payment ledger implementation.
+ */
+
+#include "payment_ledger.h"
+#include "crc32c.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace AsianCryptoPay {
+
+namespace {
+
+// File: header with magic and synced ranges, then records
+const char kLedgerMagic[8] = { 'A', 'C', 'P', 'L', 'D', 'G', 'R', '1' };
+const std::size_t kHeaderSize = 1024;
+const std::size_t kMaxRanges = (kHeaderSize - 16) / 16;
+const std::size_t kInitialSize = 1024 * 1024;
+
+// Record: this header, then id, currency, crypto currency and payload,
+// padded to 8 bytes. An empty id marks the end.
+struct RecordHeader {
+    std::uint32_t payloadLength;
+    std::uint32_t crc;
+    std::int64_t createdAtMs;
+    std::int64_t updatedAtMs;
+    std::int32_t status;
+    std::uint16_t idLength;
+    std::uint8_t currencyLength;
+    std::uint8_t cryptoLength;
+};
+
+const std::size_t kRecordHeaderSize = sizeof(RecordHeader);
+
+inline std::size_t variableLength(const RecordHeader& header) {
+    return std::size_t(header.idLength) + header.currencyLength + header.cryptoLength + header.payloadLength;
+}
+
+inline std::size_t recordSize(const RecordHeader& header) {
+    return (kRecordHeaderSize + variableLength(header) + 7) & ~static_cast<std::size_t>(7);
+}
+
+// Covers everything after the crc field, so the checksum is computed in place
+std::uint32_t recordCrc(const char* record) {
+    RecordHeader header;
+    std::memcpy(&header, record, kRecordHeaderSize);
+    std::size_t begin = offsetof(RecordHeader, createdAtMs);
+    return crc32c(0, record + begin, kRecordHeaderSize - begin + variableLength(header));
+}
+
+} // namespace
+
+PaymentLedger::PaymentLedger()
+    : m_end(kHeaderSize)
+    , m_garbage(0)
+    , m_rangesDirty(false)
+{
+}
+
+PaymentLedger::~PaymentLedger() {
+    close();
+}
+
+bool PaymentLedger::open(const std::string& path, std::string* error) {
+    close();
+    m_path = path;
+    
+    if (!m_file.open(path, MappedFile::ReadWrite, kInitialSize, error)) {
+        return false;
+    }
+    if (!load(error)) {
+        m_file.close();
+        return false;
+    }
+    
+    std::size_t live = m_end - kHeaderSize - m_garbage;
+    if (m_garbage > kInitialSize && m_garbage > live) {
+        std::string compactError;
+        if (!compact(&compactError) && !m_file.isOpen()) {
+            if (error) {
+                *error = compactError;
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+void PaymentLedger::close() {
+    if (m_file.isOpen()) {
+        sync();
+        m_file.close();
+    }
+    
+    m_end = kHeaderSize;
+    m_garbage = 0;
+    m_rangesDirty = false;
+    m_entries.clear();
+    m_byId.clear();
+    m_byCreated.clear();
+    m_byStatus.clear();
+    m_byCurrency.clear();
+    m_byCryptoCurrency.clear();
+    m_synced.clear();
+}
+
+bool PaymentLedger::load(std::string* error) {
+    char* data = m_file.data();
+    std::size_t size = m_file.size();
+    
+    static const char zeros[sizeof(kLedgerMagic)] = { 0 };
+    if (std::memcmp(data, zeros, sizeof(zeros)) == 0) {
+        std::memcpy(data, kLedgerMagic, sizeof(kLedgerMagic));
+    } else if (std::memcmp(data, kLedgerMagic, sizeof(kLedgerMagic)) != 0) {
+        if (error) {
+            *error = m_path + ": not a payment ledger";
+        }
+        return false;
+    }
+    
+    std::uint32_t rangeCount;
+    std::memcpy(&rangeCount, data + 8, sizeof(rangeCount));
+    for (std::uint32_t i = 0; i < rangeCount && i < kMaxRanges; ++i) {
+        std::int64_t range[2];
+        std::memcpy(range, data + 16 + 16 * i, sizeof(range));
+        m_synced.push_back(std::make_pair(range[0], range[1]));
+    }
+    
+    std::size_t offset = kHeaderSize;
+    while (size - offset >= kRecordHeaderSize) {
+        RecordHeader header;
+        std::memcpy(&header, data + offset, kRecordHeaderSize);
+        if (header.idLength == 0 || variableLength(header) > size - offset - kRecordHeaderSize) {
+            break;
+        }
+        if (recordCrc(data + offset) != header.crc) {
+            break;
+        }
+        
+        const char* text = data + offset + kRecordHeaderSize;
+        Record record;
+        record.id.assign(text, header.idLength);
+        record.currency.assign(text + header.idLength, header.currencyLength);
+        record.cryptoCurrency.assign(text + header.idLength + header.currencyLength, header.cryptoLength);
+        record.createdAtMs = header.createdAtMs;
+        record.updatedAtMs = header.updatedAtMs;
+        record.status = header.status;
+        
+        std::size_t recordBytes = std::min(recordSize(header), size - offset);
+        auto it = m_byId.find(record.id);
+        std::uint32_t entry;
+        if (it != m_byId.end()) {
+            entry = it->second;
+            m_garbage += m_entries[entry].size;
+            unindex(entry);
+        } else {
+            entry = static_cast<std::uint32_t>(m_entries.size());
+            m_entries.push_back(Entry());
+            m_byId[record.id] = entry;
+        }
+        m_entries[entry].record = record;
+        m_entries[entry].offset = offset;
+        m_entries[entry].size = recordBytes;
+        index(entry);
+        
+        offset += recordBytes;
+    }
+    m_end = offset;
+    
+    // Wipe a torn record so its bytes cannot be misread after the next append
+    if (size - m_end >= kRecordHeaderSize) {
+        RecordHeader header;
+        std::memcpy(&header, data + m_end, kRecordHeaderSize);
+        if (header.idLength != 0) {
+            std::memset(data + m_end, 0, std::min(recordSize(header), size - m_end));
+        }
+    }
+    return true;
+}
+
+bool PaymentLedger::compact(std::string* error) {
+    std::size_t live = m_end - kHeaderSize - m_garbage;
+    std::string temporary = m_path + ".compact";
+    std::remove(temporary.c_str());
+    std::vector<std::size_t> offsets;
+    std::size_t end = 0;
+    
+    {
+        MappedFile target;
+        if (!target.open(temporary, MappedFile::ReadWrite, std::max(kInitialSize, kHeaderSize + 2 * live), error)) {
+            return false;
+        }
+        
+        // The entries keep pointing into the current file until the swap succeeds
+        std::memcpy(target.data(), m_file.data(), kHeaderSize);
+        std::size_t offset = kHeaderSize;
+        offsets.reserve(m_entries.size());
+        for (const Entry& entry : m_entries) {
+            offsets.push_back(offset);
+            if (entry.size == 0) {
+                continue;
+            }
+            std::memcpy(target.data() + offset, m_file.data() + entry.offset, entry.size);
+            offset += entry.size;
+        }
+        end = offset;
+        
+        if (!target.sync(0, offset)) {
+            if (error) {
+                *error = temporary + ": sync failed";
+            }
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    
+    m_file.close();
+    if (std::rename(temporary.c_str(), m_path.c_str()) != 0) {
+        if (error) {
+            *error = m_path + ": rename failed";
+        }
+        std::remove(temporary.c_str());
+        // Still the old layout; reopen it as it was
+        m_file.open(m_path, MappedFile::ReadWrite, 0, nullptr);
+        return false;
+    }
+    
+    for (std::size_t i = 0; i < m_entries.size(); ++i) {
+        m_entries[i].offset = offsets[i];
+    }
+    m_end = end;
+    m_garbage = 0;
+    
+    if (!m_file.open(m_path, MappedFile::ReadWrite, 0, error)) {
+        return false;
+    }
+    MappedFile::syncDirectory(m_path.substr(0, m_path.find_last_of('/') + 1) + ".");
+    return true;
+}
+
+bool PaymentLedger::append(const Record& record, const char* payload, std::size_t length, std::size_t* offset, std::size_t* size) {
+    RecordHeader header;
+    header.payloadLength = static_cast<std::uint32_t>(length);
+    header.crc = 0;
+    header.createdAtMs = record.createdAtMs;
+    header.updatedAtMs = record.updatedAtMs;
+    header.status = record.status;
+    header.idLength = static_cast<std::uint16_t>(record.id.size());
+    header.currencyLength = static_cast<std::uint8_t>(record.currency.size());
+    header.cryptoLength = static_cast<std::uint8_t>(record.cryptoCurrency.size());
+    
+    std::size_t bytes = recordSize(header);
+    if (bytes > m_file.size() - m_end) {
+        std::size_t grown = m_file.size();
+        while (bytes > grown - m_end) {
+            grown *= 2;
+        }
+        if (!m_file.resize(grown)) {
+            return false;
+        }
+    }
+    
+    char* out = m_file.data() + m_end;
+    std::memcpy(out, &header, kRecordHeaderSize);
+    char* text = out + kRecordHeaderSize;
+    std::memcpy(text, record.id.data(), record.id.size());
+    text += record.id.size();
+    std::memcpy(text, record.currency.data(), record.currency.size());
+    text += record.currency.size();
+    std::memcpy(text, record.cryptoCurrency.data(), record.cryptoCurrency.size());
+    text += record.cryptoCurrency.size();
+    std::memcpy(text, payload, length);
+    
+    header.crc = recordCrc(out);
+    std::memcpy(out + offsetof(RecordHeader, crc), &header.crc, sizeof(header.crc));
+    
+    *offset = m_end;
+    *size = bytes;
+    m_end += bytes;
+    return true;
+}
+
+bool PaymentLedger::upsert(const Record& record, const char* payload, std::size_t length) {
+    if (!isOpen() || record.id.empty() || record.id.size() > 0xffff
+            || record.currency.size() > 0xff || record.cryptoCurrency.size() > 0xff
+            || length > 0xffffffffu) {
+        return false;
+    }
+    
+    auto it = m_byId.find(record.id);
+    if (it != m_byId.end()) {
+        const Record& stored = m_entries[it->second].record;
+        if (stored.status == record.status && stored.updatedAtMs == record.updatedAtMs
+                && stored.createdAtMs == record.createdAtMs) {
+            return true;
+        }
+    }
+    
+    std::size_t offset = 0;
+    std::size_t size = 0;
+    if (!append(record, payload, length, &offset, &size)) {
+        return false;
+    }
+    
+    std::uint32_t entry;
+    if (it != m_byId.end()) {
+        entry = it->second;
+        m_garbage += m_entries[entry].size;
+        unindex(entry);
+    } else {
+        entry = static_cast<std::uint32_t>(m_entries.size());
+        m_entries.push_back(Entry());
+        m_byId[record.id] = entry;
+    }
+    
+    m_entries[entry].record = record;
+    m_entries[entry].offset = offset;
+    m_entries[entry].size = size;
+    index(entry);
+    return true;
+}
+
+int PaymentLedger::query(const Query& query, const Visitor& visitor) const {
+    // Walk the smallest index that applies; all are ordered by creation time
+    const TimeIndex* candidates = &m_byCreated;
+    if (query.status >= 0) {
+        auto it = m_byStatus.find(query.status);
+        if (it == m_byStatus.end()) {
+            return 0;
+        }
+        candidates = &it->second;
+    }
+    if (!query.currency.empty()) {
+        auto it = m_byCurrency.find(query.currency);
+        if (it == m_byCurrency.end()) {
+            return 0;
+        }
+        if (it->second.size() < candidates->size()) {
+            candidates = &it->second;
+        }
+    }
+    if (!query.cryptoCurrency.empty()) {
+        auto it = m_byCryptoCurrency.find(query.cryptoCurrency);
+        if (it == m_byCryptoCurrency.end()) {
+            return 0;
+        }
+        if (it->second.size() < candidates->size()) {
+            candidates = &it->second;
+        }
+    }
+    
+    auto begin = candidates->lower_bound(std::make_pair(query.fromMs, std::uint32_t(0)));
+    auto end = candidates->upper_bound(std::make_pair(query.toMs, std::numeric_limits<std::uint32_t>::max()));
+    
+    int total = 0;
+    for (auto it = end; it != begin; ) {
+        --it;
+        const Entry& entry = m_entries[it->second];
+        const Record& record = entry.record;
+        if ((query.status >= 0 && record.status != query.status)
+                || (!query.currency.empty() && record.currency != query.currency)
+                || (!query.cryptoCurrency.empty() && record.cryptoCurrency != query.cryptoCurrency)) {
+            continue;
+        }
+        
+        if (total >= query.offset && (query.limit <= 0 || total < query.offset + query.limit)) {
+            RecordHeader header;
+            std::memcpy(&header, m_file.data() + entry.offset, kRecordHeaderSize);
+            const char* payload = m_file.data() + entry.offset + kRecordHeaderSize
+                    + header.idLength + header.currencyLength + header.cryptoLength;
+            visitor(payload, header.payloadLength);
+        }
+        ++total;
+    }
+    return total;
+}
+
+int PaymentLedger::count(const Query& query) const {
+    // Every match lies before the page, so no payload is visited
+    Query counting = query;
+    counting.offset = std::numeric_limits<int>::max();
+    counting.limit = 0;
+    return this->query(counting, Visitor());
+}
+
+void PaymentLedger::markSynced(std::int64_t fromMs, std::int64_t toMs) {
+    if (!isOpen() || fromMs > toMs) {
+        return;
+    }
+    
+    // Keep the ranges sorted and merge any that overlap or touch
+    m_synced.push_back(std::make_pair(fromMs, toMs));
+    std::sort(m_synced.begin(), m_synced.end());
+    std::vector<std::pair<std::int64_t, std::int64_t>> merged;
+    for (const auto& range : m_synced) {
+        if (!merged.empty() && range.first <= merged.back().second + 1) {
+            merged.back().second = std::max(merged.back().second, range.second);
+        } else {
+            merged.push_back(range);
+        }
+    }
+    if (merged.size() > kMaxRanges) {
+        merged.erase(merged.begin(), merged.begin() + (merged.size() - kMaxRanges));
+    }
+    m_synced.swap(merged);
+    m_rangesDirty = true;
+}
+
+bool PaymentLedger::isSynced(std::int64_t fromMs, std::int64_t toMs) const {
+    for (const auto& range : m_synced) {
+        if (range.first <= fromMs && toMs <= range.second) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PaymentLedger::sync() {
+    // Records first: a range must never reach the disk ahead of the
+    // records it vouches for, or a torn tail would leave it claiming
+    // payments that load() then drops
+    if (!m_file.sync(kHeaderSize, m_end - kHeaderSize)) {
+        return false;
+    }
+    if (m_rangesDirty) {
+        writeRanges();
+        if (!m_file.sync(0, kHeaderSize)) {
+            return false;
+        }
+        m_rangesDirty = false;
+    }
+    return true;
+}
+
+void PaymentLedger::index(std::uint32_t entry) {
+    const Record& record = m_entries[entry].record;
+    std::pair<std::int64_t, std::uint32_t> key(record.createdAtMs, entry);
+    m_byCreated.insert(key);
+    m_byStatus[record.status].insert(key);
+    if (!record.currency.empty()) {
+        m_byCurrency[record.currency].insert(key);
+    }
+    if (!record.cryptoCurrency.empty()) {
+        m_byCryptoCurrency[record.cryptoCurrency].insert(key);
+    }
+}
+
+void PaymentLedger::unindex(std::uint32_t entry) {
+    const Record& record = m_entries[entry].record;
+    std::pair<std::int64_t, std::uint32_t> key(record.createdAtMs, entry);
+    m_byCreated.erase(key);
+    
+    auto status = m_byStatus.find(record.status);
+    if (status != m_byStatus.end() && status->second.erase(key) && status->second.empty()) {
+        m_byStatus.erase(status);
+    }
+    auto currency = m_byCurrency.find(record.currency);
+    if (currency != m_byCurrency.end() && currency->second.erase(key) && currency->second.empty()) {
+        m_byCurrency.erase(currency);
+    }
+    auto crypto = m_byCryptoCurrency.find(record.cryptoCurrency);
+    if (crypto != m_byCryptoCurrency.end() && crypto->second.erase(key) && crypto->second.empty()) {
+        m_byCryptoCurrency.erase(crypto);
+    }
+}
+
+void PaymentLedger::writeRanges() {
+    char* data = m_file.data();
+    std::uint32_t count = static_cast<std::uint32_t>(m_synced.size());
+    std::memcpy(data + 8, &count, sizeof(count));
+    for (std::size_t i = 0; i < m_synced.size(); ++i) {
+        std::int64_t range[2] = { m_synced[i].first, m_synced[i].second };
+        std::memcpy(data + 16 + 16 * i, range, sizeof(range));
+    }
+}
+
+} // namespace AsianCryptoPay
@@ -0,0 +1,198 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * On-device payment ledger in a single memory-mapped file, with ordered
+ * indexes on creation time, status and currencies.
+ */
+
+#ifndef ASIAN_CRYPTO_PAYMENT_PAYMENT_LEDGER_H
+#define ASIAN_CRYPTO_PAYMENT_PAYMENT_LEDGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "mapped_file.h"
+
+namespace AsianCryptoPay {
+
+/**
+ * @brief Latest known copy of every payment seen on this device
+ *
+ * Each upsert appends a record (indexed fields plus an opaque payload,
+ * normally the payment JSON) to the mapped file; superseded records become
+ * garbage that is compacted away on open. The indexes live in memory and
+ * are rebuilt by scanning the file, so a torn tail after a crash only loses
+ * the records it contains.
+ *
+ * The ledger also remembers which creation-time ranges are complete, i.e.
+ * every payment created in them is known, so callers can tell when a query
+ * can be answered without the server.
+ *
+ * Not thread-safe.
+ */
+class PaymentLedger {
+public:
+    /**
+     * @brief Indexed fields of a payment
+     */
+    struct Record {
+        std::string id;
+        std::int64_t createdAtMs = 0;
+        std::int64_t updatedAtMs = 0;
+        int status = 0;
+        std::string currency;
+        std::string cryptoCurrency;
+    };
+    
+    /**
+     * @brief Query over the indexes; empty strings and negative status match anything
+     */
+    struct Query {
+        int status = -1;
+        std::string currency;
+        std::string cryptoCurrency;
+        std::int64_t fromMs = std::numeric_limits<std::int64_t>::min();
+        std::int64_t toMs = std::numeric_limits<std::int64_t>::max();
+        int offset = 0;
+        int limit = 0;  ///< 0 for no limit
+    };
+    
+    /**
+     * @brief Payload visitor for query()
+     */
+    typedef std::function<void(const char* payload, std::size_t length)> Visitor;
+    
+    /**
+     * @brief Constructor
+     */
+    PaymentLedger();
+    
+    /**
+     * @brief Destructor, syncs and closes the file
+     */
+    ~PaymentLedger();
+    
+    PaymentLedger(const PaymentLedger&) = delete;
+    PaymentLedger& operator=(const PaymentLedger&) = delete;
+    
+    /**
+     * @brief Open or create the ledger file and build the indexes
+     * @param path Ledger file path
+     * @param error Receives a description on failure, may be null
+     * @return Whether the ledger is open
+     */
+    bool open(const std::string& path, std::string* error = nullptr);
+    
+    /**
+     * @brief Sync and close the file
+     */
+    void close();
+    
+    /**
+     * @brief Check if the ledger is open
+     * @return Whether open() succeeded
+     */
+    bool isOpen() const { return m_file.isOpen(); }
+    
+    /**
+     * @brief Store the latest copy of a payment
+     *
+     * A copy with the same status and update time as the stored one is
+     * ignored, so repeated polls do not grow the file.
+     *
+     * @param record Indexed fields; id must not be empty
+     * @param payload Payment data
+     * @param length Payload size
+     * @return Whether the payment is stored
+     */
+    bool upsert(const Record& record, const char* payload, std::size_t length);
+    
+    /**
+     * @brief Find payments, newest first
+     * @param query Filter and page
+     * @param visitor Called with the payload of each payment in the page
+     * @return Number of matching payments before paging
+     */
+    int query(const Query& query, const Visitor& visitor) const;
+    
+    /**
+     * @brief Count payments without reading their payloads
+     * @param query Filter; offset and limit are ignored
+     * @return Number of matching payments
+     */
+    int count(const Query& query) const;
+    
+    /**
+     * @brief Record that every payment created in a range is stored
+     *
+     * Takes effect at once for isSynced(); written to disk by the next
+     * sync(), after the records themselves.
+     *
+     * @param fromMs Range start, inclusive
+     * @param toMs Range end, inclusive
+     */
+    void markSynced(std::int64_t fromMs, std::int64_t toMs);
+    
+    /**
+     * @brief Check if a creation-time range is complete
+     * @param fromMs Range start, inclusive
+     * @param toMs Range end, inclusive
+     * @return Whether a single synced range covers it
+     */
+    bool isSynced(std::int64_t fromMs, std::int64_t toMs) const;
+    
+    /**
+     * @brief Get number of stored payments
+     * @return Payment count
+     */
+    std::size_t size() const { return m_entries.size(); }
+    
+    /**
+     * @brief Write all changes back to disk
+     * @return Whether the file was synced
+     */
+    bool sync();
+
+private:
+    typedef std::set<std::pair<std::int64_t, std::uint32_t>> TimeIndex;
+    
+    struct Entry {
+        Record record;
+        std::size_t offset = 0;
+        std::size_t size = 0;
+    };
+    
+    bool load(std::string* error);
+    bool compact(std::string* error);
+    bool append(const Record& record, const char* payload, std::size_t length, std::size_t* offset, std::size_t* size);
+    void index(std::uint32_t entry);
+    void unindex(std::uint32_t entry);
+    void writeRanges();
+    
+    std::string m_path;
+    MappedFile m_file;
+    std::size_t m_end;
+    std::size_t m_garbage;
+    bool m_rangesDirty;
+    
+    std::vector<Entry> m_entries;
+    std::unordered_map<std::string, std::uint32_t> m_byId;
+    TimeIndex m_byCreated;
+    std::map<int, TimeIndex> m_byStatus;
+    std::map<std::string, TimeIndex> m_byCurrency;
+    std::map<std::string, TimeIndex> m_byCryptoCurrency;
+    std::vector<std::pair<std::int64_t, std::int64_t>> m_synced;
+};
+
+} // namespace AsianCryptoPay
+
+#endif // ASIAN_CRYPTO_PAYMENT_PAYMENT_LEDGER_H
@@ -0,0 +1,364 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * Compact metadata storage for payments. Metadata is usually a handful of
+ * short string pairs (customer_id, product_id), so entries are packed into
+ * an inline byte arena and only spill to the heap when they do not fit.
+ */
+
+#ifndef ASIAN_CRYPTO_PAYMENT_METADATA_H
+#define ASIAN_CRYPTO_PAYMENT_METADATA_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVariant>
+#include <QVariantMap>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <cstring>
+
+#include "json_scanner.h"
+#include "json_writer.h"
+
+namespace AsianCryptoPay {
+
+/**
+ * @brief Flat, small-buffer-optimized metadata container
+ *
+ * Keys and string values are kept in their JSON-escaped UTF-8 form, so
+ * encoding to and decoding from JSON are plain byte copies. Non-string
+ * values are kept as compact JSON literals. A QVariantMap is only built
+ * when toVariantMap() is called.
+ */
+class PaymentMetadata {
+public:
+    /**
+     * @brief Inline arena size in bytes
+     */
+    static const int InlineSize = 112;
+    
+    /**
+     * @brief Constructor
+     */
+    PaymentMetadata() {}
+    
+    /**
+     * @brief Copy constructor
+     * @param other Metadata to copy
+     */
+    PaymentMetadata(const PaymentMetadata& other) {
+        *this = other;
+    }
+    
+    /**
+     * @brief Copy assignment
+     * @param other Metadata to copy
+     * @return Reference to this object
+     */
+    PaymentMetadata& operator=(const PaymentMetadata& other) {
+        if (this != &other) {
+            m_heap = other.m_heap;
+            m_used = other.m_used;
+            m_count = other.m_count;
+            if (m_heap.isNull()) {
+                std::memcpy(m_inline, other.m_inline, m_used);
+            }
+        }
+        return *this;
+    }
+    
+    /**
+     * @brief Build from a variant map
+     * @param map Metadata map
+     * @return Metadata
+     */
+    static PaymentMetadata fromVariantMap(const QVariantMap& map) {
+        PaymentMetadata metadata;
+        for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+            metadata.insert(it.key(), it.value());
+        }
+        return metadata;
+    }
+    
+    /**
+     * @brief Build from a JSON object
+     * @param object JSON object
+     * @return Metadata
+     */
+    static PaymentMetadata fromJsonObject(const QJsonObject& object) {
+        PaymentMetadata metadata;
+        for (auto it = object.constBegin(); it != object.constEnd(); ++it) {
+            metadata.insert(it.key(), it.value().toVariant());
+        }
+        return metadata;
+    }
+    
+    /**
+     * @brief Build from raw JSON object bytes without decoding values
+     * @param data Buffer start
+     * @param span Range of the JSON object inside the buffer
+     * @return Metadata, empty if the object is malformed
+     */
+    static PaymentMetadata fromJson(const char* data, const JsonSpan& span) {
+        PaymentMetadata metadata;
+        JsonScanner scanner(data, span.end);
+        int pos = span.begin;
+        
+        bool ok = scanner.forEachMember(pos, [&](const char* key, int length, const JsonSpan& value) {
+            if (scanner.isString(value)) {
+                metadata.append(String, key, length, data + value.begin + 1, value.length() - 2);
+            } else {
+                metadata.append(Literal, key, length, data + value.begin, value.length());
+            }
+            return true;
+        });
+        
+        return ok ? metadata : PaymentMetadata();
+    }
+    
+    /**
+     * @brief Insert or replace a string value
+     * @param key Metadata key
+     * @param value String value
+     */
+    void insert(const QString& key, const QString& value) {
+        QByteArray escapedKey = escape(key);
+        QByteArray escapedValue = escape(value);
+        remove(escapedKey);
+        append(String, escapedKey.constData(), escapedKey.size(), escapedValue.constData(), escapedValue.size());
+    }
+    
+    /**
+     * @brief Insert or replace an arbitrary value
+     * @param key Metadata key
+     * @param value Value, stored as a string if it is one, else as a JSON literal
+     */
+    void insert(const QString& key, const QVariant& value) {
+        if (value.type() == QVariant::String) {
+            insert(key, value.toString());
+            return;
+        }
+        
+        QByteArray wrapped = QJsonDocument(QJsonArray() << QJsonValue::fromVariant(value)).toJson(QJsonDocument::Compact);
+        QByteArray escapedKey = escape(key);
+        remove(escapedKey);
+        append(Literal, escapedKey.constData(), escapedKey.size(), wrapped.constData() + 1, wrapped.size() - 2);
+    }
+    
+    /**
+     * @brief Remove a key
+     * @param key Metadata key
+     */
+    void remove(const QString& key) {
+        remove(escape(key));
+    }
+    
+    /**
+     * @brief Check if a key is present
+     * @param key Metadata key
+     * @return Whether the key is present
+     */
+    bool contains(const QString& key) const {
+        return find(escape(key)) >= 0;
+    }
+    
+    /**
+     * @brief Get a value
+     * @param key Metadata key
+     * @return Value, or an invalid variant if the key is absent
+     */
+    QVariant value(const QString& key) const {
+        int offset = find(escape(key));
+        return offset >= 0 ? decodeValue(offset) : QVariant();
+    }
+    
+    /**
+     * @brief Get number of entries
+     * @return Entry count
+     */
+    int size() const { return m_count; }
+    
+    /**
+     * @brief Check if there are no entries
+     * @return Whether the metadata is empty
+     */
+    bool isEmpty() const { return m_count == 0; }
+    
+    /**
+     * @brief Check if entries spilled out of the inline arena
+     * @return Whether heap storage is in use
+     */
+    bool isInline() const { return m_heap.isNull(); }
+    
+    /**
+     * @brief Build a variant map view
+     * @return Metadata map
+     */
+    QVariantMap toVariantMap() const {
+        QVariantMap map;
+        for (int offset = 0; offset < m_used; offset = next(offset)) {
+            map.insert(unescape(keyData(offset), keyLength(offset)), decodeValue(offset));
+        }
+        return map;
+    }
+    
+    /**
+     * @brief Build a JSON object
+     * @return JSON object
+     */
+    QJsonObject toJsonObject() const {
+        return QJsonObject::fromVariantMap(toVariantMap());
+    }
+    
+    /**
+     * @brief Write the metadata as a JSON object value
+     * @param writer Request writer, positioned after a member name
+     */
+    void writeJson(JsonWriter& writer) const {
+        writer.beginObject();
+        for (int offset = 0; offset < m_used; offset = next(offset)) {
+            writer.rawKey(keyData(offset), keyLength(offset));
+            if (kind(offset) == String) {
+                writer.rawStringValue(valueData(offset), valueLength(offset));
+            } else {
+                writer.rawValue(valueData(offset), valueLength(offset));
+            }
+        }
+        writer.endObject();
+    }
+    
+    /**
+     * @brief Compare metadata entries
+     * @param other Metadata to compare with
+     * @return Whether both hold the same entries in the same order
+     */
+    bool operator==(const PaymentMetadata& other) const {
+        return m_count == other.m_count && m_used == other.m_used
+                && std::memcmp(data(), other.data(), m_used) == 0;
+    }
+    
+    /**
+     * @brief Compare metadata entries
+     * @param other Metadata to compare with
+     * @return Whether the entries differ
+     */
+    bool operator!=(const PaymentMetadata& other) const { return !(*this == other); }
+
+private:
+    // Entry layout: kind (1 byte), key length (2), value length (2), key, value
+    enum Kind : char {
+        String = 's',
+        Literal = 'l'
+    };
+    
+    static const int HeaderSize = 5;
+    
+    const char* data() const { return m_heap.isNull() ? m_inline : m_heap.constData(); }
+    Kind kind(int offset) const { return static_cast<Kind>(data()[offset]); }
+    int keyLength(int offset) const { return readLength(data() + offset + 1); }
+    int valueLength(int offset) const { return readLength(data() + offset + 3); }
+    const char* keyData(int offset) const { return data() + offset + HeaderSize; }
+    const char* valueData(int offset) const { return keyData(offset) + keyLength(offset); }
+    int next(int offset) const { return offset + HeaderSize + keyLength(offset) + valueLength(offset); }
+    
+    static int readLength(const char* p) {
+        return static_cast<unsigned char>(p[0]) | (static_cast<unsigned char>(p[1]) << 8);
+    }
+    
+    static void writeLength(char* p, int length) {
+        p[0] = static_cast<char>(length & 0xFF);
+        p[1] = static_cast<char>((length >> 8) & 0xFF);
+    }
+    
+    void append(Kind entryKind, const char* key, int keyLen, const char* value, int valueLen) {
+        if (keyLen > 0xFFFF || valueLen > 0xFFFF) {
+            return;
+        }
+        
+        int entrySize = HeaderSize + keyLen + valueLen;
+        char* out;
+        
+        if (m_heap.isNull() && m_used + entrySize <= InlineSize) {
+            out = m_inline + m_used;
+        } else {
+            if (m_heap.isNull()) {
+                m_heap = QByteArray(m_inline, m_used);
+            }
+            m_heap.resize(m_used + entrySize);
+            out = m_heap.data() + m_used;
+        }
+        
+        out[0] = entryKind;
+        writeLength(out + 1, keyLen);
+        writeLength(out + 3, valueLen);
+        std::memcpy(out + HeaderSize, key, keyLen);
+        std::memcpy(out + HeaderSize + keyLen, value, valueLen);
+        
+        m_used += entrySize;
+        ++m_count;
+    }
+    
+    int find(const QByteArray& escapedKey) const {
+        for (int offset = 0; offset < m_used; offset = next(offset)) {
+            if (keyLength(offset) == escapedKey.size()
+                    && std::memcmp(keyData(offset), escapedKey.constData(), escapedKey.size()) == 0) {
+                return offset;
+            }
+        }
+        return -1;
+    }
+    
+    void remove(const QByteArray& escapedKey) {
+        int offset = find(escapedKey);
+        if (offset < 0) {
+            return;
+        }
+        
+        int entrySize = next(offset) - offset;
+        char* base = m_heap.isNull() ? m_inline : m_heap.data();
+        std::memmove(base + offset, base + offset + entrySize, m_used - offset - entrySize);
+        m_used -= entrySize;
+        --m_count;
+        
+        if (!m_heap.isNull()) {
+            m_heap.resize(m_used);
+        }
+    }
+    
+    QVariant decodeValue(int offset) const {
+        if (kind(offset) == String) {
+            return unescape(valueData(offset), valueLength(offset));
+        }
+        
+        QByteArray wrapped = "[" + QByteArray(valueData(offset), valueLength(offset)) + "]";
+        return QJsonDocument::fromJson(wrapped).array().at(0).toVariant();
+    }
+    
+    static QByteArray escape(const QString& text) {
+        QByteArray utf8 = text.toUtf8();
+        QByteArray escaped;
+        escaped.reserve(utf8.size());
+        JsonWriter::appendEscaped(escaped, utf8.constData(), utf8.size());
+        return escaped;
+    }
+    
+    static QString unescape(const char* data, int length) {
+        if (std::memchr(data, '\\', length) == nullptr) {
+            return QString::fromUtf8(data, length);
+        }
+        
+        QByteArray wrapped = "[\"" + QByteArray(data, length) + "\"]";
+        return QJsonDocument::fromJson(wrapped).array().at(0).toString();
+    }
+    
+    char m_inline[InlineSize];
+    QByteArray m_heap;
+    int m_used = 0;
+    int m_count = 0;
+};
+
+} // namespace AsianCryptoPay
+
+#endif // ASIAN_CRYPTO_PAYMENT_METADATA_H
@@ -0,0 +1,136 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * Value replaced as a whole while other threads keep reading it, without locks.
+ */
+
+#ifndef ASIAN_CRYPTO_PAYMENT_PUBLISHED_VALUE_H
+#define ASIAN_CRYPTO_PAYMENT_PUBLISHED_VALUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+
+namespace AsianCryptoPay {
+
+/**
+ * @brief Immutable value published by index into a fixed set of slots
+ *
+ * A reader pins the current slot with one counter increment and re-checks
+ * the index; it retries only if a publish() overlapped those two steps, and
+ * never takes a lock or allocates. publish() writes the next value into a
+ * slot that is neither current nor pinned, then makes it current, so a
+ * value is never modified while anyone can still see it.
+ *
+ * publish() calls are serialized by a mutex that readers never touch. A
+ * publisher waits only if every other slot is pinned, i.e. more than
+ * Slots - 1 publishes overlap one read; keep reads short.
+ *
+ * T must be copy-assignable.
+ */
+template<typename T, int Slots = 4>
+class PublishedValue {
+    static_assert(Slots >= 2, "PublishedValue needs a spare slot to publish into");
+    
+    // Slots on separate cache lines so pinning one does not slow readers of another
+    struct alignas(64) Slot {
+        std::atomic<int> readers;
+        T value;
+    };
+
+public:
+    /**
+     * @brief Pin on the value that was current when read() was called
+     */
+    class Reader {
+    public:
+        Reader(Reader&& other) : m_slot(other.m_slot) { other.m_slot = nullptr; }
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+        
+        ~Reader() {
+            if (m_slot) {
+                m_slot->readers.fetch_sub(1, std::memory_order_release);
+            }
+        }
+        
+        const T& operator*() const { return m_slot->value; }
+        const T* operator->() const { return &m_slot->value; }
+    
+    private:
+        friend class PublishedValue;
+        explicit Reader(Slot* slot) : m_slot(slot) {}
+        
+        Slot* m_slot;
+    };
+    
+    /**
+     * @brief Constructor
+     * @param initial Initial value
+     */
+    explicit PublishedValue(const T& initial = T())
+        : m_current(0)
+    {
+        for (Slot& slot : m_slots) {
+            slot.readers.store(0, std::memory_order_relaxed);
+        }
+        m_slots[0].value = initial;
+    }
+    
+    PublishedValue(const PublishedValue&) = delete;
+    PublishedValue& operator=(const PublishedValue&) = delete;
+    
+    /**
+     * @brief Pin the current value
+     * @return Reader; the value stays valid and unchanged until it is destroyed
+     */
+    Reader read() const {
+        for (;;) {
+            int index = m_current.load();
+            Slot* slot = &m_slots[index];
+            slot->readers.fetch_add(1);
+            // Still current after pinning, so no publish() can pick this slot until we unpin
+            if (m_current.load() == index) {
+                return Reader(slot);
+            }
+            slot->readers.fetch_sub(1, std::memory_order_release);
+        }
+    }
+    
+    /**
+     * @brief Replace the value
+     * @param next Function computing the new value from the current one
+     */
+    template<typename F>
+    void publish(F next) {
+        std::lock_guard<std::mutex> lock(m_publishMutex);
+        int current = m_current.load(std::memory_order_relaxed);
+        
+        int target = -1;
+        while (target < 0) {
+            for (int i = 1; i < Slots && target < 0; i++) {
+                int candidate = (current + i) % Slots;
+                if (m_slots[candidate].readers.load() == 0) {
+                    target = candidate;
+                }
+            }
+            if (target < 0) {
+                std::this_thread::yield();
+            }
+        }
+        
+        m_slots[target].value = next(static_cast<const T&>(m_slots[current].value));
+        m_current.store(target);
+    }
+
+private:
+    mutable Slot m_slots[Slots];
+    std::atomic<int> m_current;
+    std::mutex m_publishMutex;
+};
+
+} // namespace AsianCryptoPay
+
+#endif // ASIAN_CRYPTO_PAYMENT_PUBLISHED_VALUE_H
@@ -0,0 +1,193 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * Recent ticks of one exchange rate pair with rolling volatility.
+ */
+
+#ifndef ASIAN_CRYPTO_PAYMENT_RATE_HISTORY_H
+#define ASIAN_CRYPTO_PAYMENT_RATE_HISTORY_H
+
+#include <cmath>
+#include <cstdint>
+
+namespace AsianCryptoPay {
+
+/**
+ * @brief Fixed-size ring of rate ticks, oldest overwritten first
+ *
+ * Each tick keeps its log return against the previous one. Sums of
+ * squared returns and of elapsed time are updated as ticks enter and
+ * leave, so the realized variance per millisecond over the window costs
+ * O(1) per tick however uneven the tick spacing is. The sums are rebuilt
+ * from the ring once per Capacity ticks to shed rounding drift.
+ *
+ * Not thread-safe.
+ */
+class RateHistory {
+public:
+    static const int Capacity = 128;
+    static const int MinReturns = 8;
+    
+    /**
+     * @brief One observed rate
+     */
+    struct Tick {
+        std::int64_t timeMs = 0;
+        double rate = 0.0;
+    };
+    
+    /**
+     * @brief Constructor
+     */
+    RateHistory()
+        : m_head(0)
+        , m_size(0)
+        , m_returns(0)
+        , m_sumSquares(0.0)
+        , m_sumMs(0.0)
+        , m_untilRebuild(Capacity)
+    {
+    }
+    
+    /**
+     * @brief Record a tick
+     * @param timeMs Time the rate was observed
+     * @param rate Rate; ticks that are not positive or not newer than the last are ignored
+     * @return Whether the tick was recorded
+     */
+    bool push(std::int64_t timeMs, double rate) {
+        if (!(rate > 0.0)) {
+            return false;
+        }
+        
+        Slot slot;
+        slot.tick.timeMs = timeMs;
+        slot.tick.rate = rate;
+        if (m_size > 0) {
+            const Tick& last = m_slots[index(m_size - 1)].tick;
+            if (timeMs <= last.timeMs) {
+                return false;
+            }
+            slot.logReturn = std::log(rate / last.rate);
+            slot.intervalMs = static_cast<double>(timeMs - last.timeMs);
+            slot.hasReturn = true;
+        }
+        
+        if (m_size == Capacity) {
+            remove(m_slots[m_head]);
+            m_head = index(1);
+            m_size--;
+        }
+        m_slots[index(m_size)] = slot;
+        m_size++;
+        add(slot);
+        
+        if (--m_untilRebuild == 0) {
+            rebuild();
+        }
+        return true;
+    }
+    
+    /**
+     * @brief Get number of ticks held
+     * @return Tick count
+     */
+    int size() const { return m_size; }
+    
+    /**
+     * @brief Get a tick
+     * @param i Position, 0 for the oldest held
+     * @return Tick
+     */
+    const Tick& at(int i) const { return m_slots[index(i)].tick; }
+    
+    /**
+     * @brief Get the newest tick
+     * @return Tick, zero if none
+     */
+    Tick last() const { return m_size > 0 ? at(m_size - 1) : Tick(); }
+    
+    /**
+     * @brief Copy the newest ticks, e.g. for a sparkline
+     * @param ticks Receives up to capacity ticks, oldest first
+     * @param capacity Size of ticks
+     * @return Number of ticks written
+     */
+    int copy(Tick* ticks, int capacity) const {
+        int count = m_size < capacity ? m_size : capacity;
+        for (int i = 0; i < count; i++) {
+            ticks[i] = at(m_size - count + i);
+        }
+        return count;
+    }
+    
+    /**
+     * @brief Get realized variance of log returns per millisecond
+     * @return Variance, -1 if fewer than MinReturns returns are held
+     */
+    double variancePerMs() const {
+        if (m_returns < MinReturns || !(m_sumMs > 0.0)) {
+            return -1.0;
+        }
+        return m_sumSquares / m_sumMs;
+    }
+    
+    /**
+     * @brief Get the one-sigma relative move expected over a horizon
+     * @param horizonMs Horizon in milliseconds
+     * @return Relative move, -1 if too few returns are held
+     */
+    double expectedMove(double horizonMs) const {
+        double variance = variancePerMs();
+        return variance < 0.0 ? -1.0 : std::sqrt(variance * horizonMs);
+    }
+
+private:
+    struct Slot {
+        Tick tick;
+        double logReturn = 0.0;
+        double intervalMs = 0.0;
+        bool hasReturn = false;     ///< False for the first tick ever pushed
+    };
+    
+    int index(int i) const { return (m_head + i) % Capacity; }
+    
+    void add(const Slot& slot) {
+        if (slot.hasReturn) {
+            m_returns++;
+            m_sumSquares += slot.logReturn * slot.logReturn;
+            m_sumMs += slot.intervalMs;
+        }
+    }
+    
+    void remove(const Slot& slot) {
+        if (slot.hasReturn) {
+            m_returns--;
+            m_sumSquares -= slot.logReturn * slot.logReturn;
+            m_sumMs -= slot.intervalMs;
+        }
+    }
+    
+    void rebuild() {
+        m_returns = 0;
+        m_sumSquares = 0.0;
+        m_sumMs = 0.0;
+        for (int i = 0; i < m_size; i++) {
+            add(m_slots[index(i)]);
+        }
+        m_untilRebuild = Capacity;
+    }
+    
+    Slot m_slots[Capacity];
+    int m_head;
+    int m_size;
+    int m_returns;
+    double m_sumSquares;
+    double m_sumMs;
+    int m_untilRebuild;
+};
+
+} // namespace AsianCryptoPay
+
+#endif // ASIAN_CRYPTO_PAYMENT_RATE_HISTORY_H
@@ -0,0 +1,286 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * Fixed-layout exchange rate table that any thread can read without locks.
+ */
+
+#ifndef ASIAN_CRYPTO_PAYMENT_RATE_TABLE_H
+#define ASIAN_CRYPTO_PAYMENT_RATE_TABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+
+namespace AsianCryptoPay {
+
+/**
+ * @brief Rates per (fiat, crypto) pair, one seqlock per fiat row
+ *
+ * Currency codes are interned once into small ids; after that a read is a
+ * few loads with no lock and no allocation, and is retried only if it
+ * overlapped a write to the same row. publish() updates any number of
+ * pairs in a row as one step, so a reader never sees half of a tick.
+ *
+ * Writers are serialized by a mutex and may run on any thread, normally
+ * the network thread. Ids are never reused and the table never moves, so
+ * an id or a reference to the table stays valid for its lifetime.
+ */
+class RateTable {
+public:
+    static const int MaxFiat = 16;
+    static const int MaxCrypto = 32;
+    static const std::size_t MaxCodeLength = 7;
+    
+    /**
+     * @brief Rate of one pair; rate is 0 when unknown
+     */
+    struct Rate {
+        double rate = 0.0;
+        std::int64_t fetchedAtMs = 0;
+        double variancePerMs = -1.0;    ///< Realized variance of recent ticks, -1 if too few
+    };
+    
+    /**
+     * @brief One pair of a publish() batch
+     */
+    struct Update {
+        int cryptoId;
+        double rate;
+        double variancePerMs;
+    };
+    
+    /**
+     * @brief Constructor
+     */
+    RateTable()
+        : m_fiatCount(0)
+        , m_cryptoCount(0)
+    {
+        std::memset(m_fiatCodes, 0, sizeof(m_fiatCodes));
+        std::memset(m_cryptoCodes, 0, sizeof(m_cryptoCodes));
+        for (Row& row : m_rows) {
+            row.sequence.store(0, std::memory_order_relaxed);
+            for (Cell& cell : row.cells) {
+                cell.rateBits.store(0, std::memory_order_relaxed);
+                cell.fetchedAtMs.store(0, std::memory_order_relaxed);
+                cell.varianceBits.store(toBits(-1.0), std::memory_order_relaxed);
+            }
+        }
+    }
+    
+    RateTable(const RateTable&) = delete;
+    RateTable& operator=(const RateTable&) = delete;
+    
+    /**
+     * @brief Get or assign the id of a fiat currency
+     * @param code Currency code
+     * @return Id, -1 if the code is too long or the table is full
+     */
+    int internFiat(const char* code) {
+        return intern(code, m_fiatCodes, MaxFiat, m_fiatCount);
+    }
+    
+    /**
+     * @brief Get or assign the id of a cryptocurrency
+     * @param code Currency code
+     * @return Id, -1 if the code is too long or the table is full
+     */
+    int internCrypto(const char* code) {
+        return intern(code, m_cryptoCodes, MaxCrypto, m_cryptoCount);
+    }
+    
+    /**
+     * @brief Look up a fiat currency without locking
+     * @param code Currency code
+     * @return Id, -1 if not interned
+     */
+    int fiatId(const char* code) const {
+        return find(code, m_fiatCodes, m_fiatCount.load(std::memory_order_acquire));
+    }
+    
+    /**
+     * @brief Look up a cryptocurrency without locking
+     * @param code Currency code
+     * @return Id, -1 if not interned
+     */
+    int cryptoId(const char* code) const {
+        return find(code, m_cryptoCodes, m_cryptoCount.load(std::memory_order_acquire));
+    }
+    
+    /**
+     * @brief Get the code of a fiat id
+     * @param fiatId Interned id
+     * @return Currency code
+     */
+    const char* fiatCode(int fiatId) const { return m_fiatCodes[fiatId]; }
+    
+    /**
+     * @brief Get the code of a cryptocurrency id
+     * @param cryptoId Interned id
+     * @return Currency code
+     */
+    const char* cryptoCode(int cryptoId) const { return m_cryptoCodes[cryptoId]; }
+    
+    /**
+     * @brief Get number of interned cryptocurrencies, i.e. the used width of a row
+     * @return Cryptocurrency count
+     */
+    int cryptoCount() const { return m_cryptoCount.load(std::memory_order_acquire); }
+    
+    /**
+     * @brief Publish new rates for one fiat row as a single step
+     * @param fiatId Interned fiat id
+     * @param updates Pairs to set
+     * @param count Number of pairs
+     * @param fetchedAtMs Time the rates were fetched
+     */
+    void publish(int fiatId, const Update* updates, std::size_t count, std::int64_t fetchedAtMs) {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        Row& row = m_rows[fiatId];
+        
+        std::uint32_t sequence = row.sequence.load(std::memory_order_relaxed);
+        row.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        
+        for (std::size_t i = 0; i < count; i++) {
+            Cell& cell = row.cells[updates[i].cryptoId];
+            cell.rateBits.store(toBits(updates[i].rate), std::memory_order_relaxed);
+            cell.fetchedAtMs.store(fetchedAtMs, std::memory_order_relaxed);
+            cell.varianceBits.store(toBits(updates[i].variancePerMs), std::memory_order_relaxed);
+        }
+        
+        row.sequence.store(sequence + 2, std::memory_order_release);
+    }
+    
+    /**
+     * @brief Read one pair
+     * @param fiatId Interned fiat id
+     * @param cryptoId Interned cryptocurrency id
+     * @return Rate, 0 if never published
+     */
+    Rate read(int fiatId, int cryptoId) const {
+        const Row& row = m_rows[fiatId];
+        const Cell& cell = row.cells[cryptoId];
+        Rate rate;
+        std::uint32_t before;
+        do {
+            before = waitEven(row);
+            rate.rate = fromBits(cell.rateBits.load(std::memory_order_relaxed));
+            rate.fetchedAtMs = cell.fetchedAtMs.load(std::memory_order_relaxed);
+            rate.variancePerMs = fromBits(cell.varianceBits.load(std::memory_order_relaxed));
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while (row.sequence.load(std::memory_order_relaxed) != before);
+        return rate;
+    }
+    
+    /**
+     * @brief Read a whole fiat row as of one publish()
+     * @param fiatId Interned fiat id
+     * @param rates Receives cryptoCount() rates, indexed by cryptocurrency id
+     * @param capacity Size of rates
+     * @return Number of rates written
+     */
+    int readRow(int fiatId, Rate* rates, int capacity) const {
+        const Row& row = m_rows[fiatId];
+        int count;
+        std::uint32_t before;
+        do {
+            before = waitEven(row);
+            count = cryptoCount();
+            count = count < capacity ? count : capacity;
+            for (int i = 0; i < count; i++) {
+                rates[i].rate = fromBits(row.cells[i].rateBits.load(std::memory_order_relaxed));
+                rates[i].fetchedAtMs = row.cells[i].fetchedAtMs.load(std::memory_order_relaxed);
+                rates[i].variancePerMs = fromBits(row.cells[i].varianceBits.load(std::memory_order_relaxed));
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while (row.sequence.load(std::memory_order_relaxed) != before);
+        return count;
+    }
+    
+    /**
+     * @brief Get the version of a fiat row, which changes with every publish()
+     * @param fiatId Interned fiat id
+     * @return Row version
+     */
+    std::uint32_t version(int fiatId) const {
+        return waitEven(m_rows[fiatId]);
+    }
+
+private:
+    static const std::size_t CacheLine = 64;
+    
+    struct Cell {
+        std::atomic<std::uint64_t> rateBits;    ///< IEEE 754 bits, so torn reads are well-defined
+        std::atomic<std::int64_t> fetchedAtMs;
+        std::atomic<std::uint64_t> varianceBits;
+    };
+    
+    // Rows on separate cache lines so a write to one does not slow readers of another
+    struct alignas(CacheLine) Row {
+        std::atomic<std::uint32_t> sequence;    ///< Odd while a write is in progress
+        Cell cells[MaxCrypto];
+    };
+    
+    typedef char Code[MaxCodeLength + 1];
+    
+    static std::uint64_t toBits(double value) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+    
+    static double fromBits(std::uint64_t bits) {
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    
+    static std::uint32_t waitEven(const Row& row) {
+        std::uint32_t sequence;
+        while ((sequence = row.sequence.load(std::memory_order_acquire)) & 1) {
+        }
+        return sequence;
+    }
+    
+    static int find(const char* code, const Code* codes, int count) {
+        for (int i = 0; i < count; i++) {
+            if (std::strncmp(codes[i], code, sizeof(Code)) == 0) {
+                return i;
+            }
+        }
+        return -1;
+    }
+    
+    int intern(const char* code, Code* codes, int capacity, std::atomic<int>& count) {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        int used = count.load(std::memory_order_relaxed);
+        int id = find(code, codes, used);
+        if (id >= 0) {
+            return id;
+        }
+        
+        std::size_t length = std::strlen(code);
+        if (length == 0 || length > MaxCodeLength || used == capacity) {
+            return -1;
+        }
+        // The code is complete before readers can see the new count
+        std::memcpy(codes[used], code, length + 1);
+        count.store(used + 1, std::memory_order_release);
+        return used;
+    }
+    
+    Row m_rows[MaxFiat];
+    Code m_fiatCodes[MaxFiat];
+    Code m_cryptoCodes[MaxCrypto];
+    std::atomic<int> m_fiatCount;
+    std::atomic<int> m_cryptoCount;
+    std::mutex m_writeMutex;
+};
+
+} // namespace AsianCryptoPay
+
+#endif // ASIAN_CRYPTO_PAYMENT_RATE_TABLE_H
@@ -0,0 +1,143 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * Replay protection implementation.
+ */
+
+#include "replay_protection.h"
+
+#include <algorithm>
+#include <random>
+
+#include "hex_codec.h"
+
+namespace AsianCryptoPay {
+
+namespace {
+
+std::uint64_t randomWord(std::random_device& device) {
+    return (static_cast<std::uint64_t>(device()) << 32) ^ device();
+}
+
+// splitmix64 finalizer; each step is invertible, so distinct inputs give
+// distinct outputs
+inline std::uint64_t mix(std::uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+inline void storeBigEndian(unsigned char* p, std::uint64_t value) {
+    for (int i = 7; i >= 0; --i) {
+        p[i] = static_cast<unsigned char>(value);
+        value >>= 8;
+    }
+}
+
+} // namespace
+
+NonceGenerator::NonceGenerator()
+    : m_counter(0)
+{
+    std::random_device device;
+    m_prefix = randomWord(device);
+    m_key = randomWord(device);
+}
+
+void NonceGenerator::next(char out[NonceLength]) {
+    std::uint64_t sequence = m_counter.fetch_add(1, std::memory_order_relaxed);
+    
+    unsigned char bytes[16];
+    storeBigEndian(bytes, m_prefix);
+    storeBigEndian(bytes + 8, mix(sequence ^ m_key));
+    HexCodec::encode(bytes, sizeof(bytes), out);
+}
+
+ReplayCache::ReplayCache(std::size_t capacity, std::int64_t windowMs)
+    : m_current(0)
+    , m_window(windowMs)
+    , m_generationStart(NoTimestamp)
+    , m_saturations(0)
+{
+    std::size_t buckets = 1;
+    while (buckets * BucketSize < capacity) {
+        buckets <<= 1;
+    }
+    m_bucketMask = buckets - 1;
+    m_tables[0].assign(buckets * BucketSize, 0);
+    m_tables[1].assign(buckets * BucketSize, 0);
+}
+
+ReplayCache::Result ReplayCache::check(std::uint64_t fingerprint, std::int64_t eventTimeMs, std::int64_t nowMs) {
+    if (eventTimeMs == NoTimestamp || eventTimeMs < nowMs - m_window || eventTimeMs > nowMs + m_window) {
+        return Expired;
+    }
+    
+    // An event stamped up to one window ahead stays acceptable until two
+    // windows after it arrives, so each generation spans two windows
+    if (m_generationStart == NoTimestamp) {
+        m_generationStart = nowMs;
+    } else if (nowMs - m_generationStart >= 2 * m_window) {
+        rotate(nowMs);
+    }
+    
+    // Zero marks an empty slot
+    if (fingerprint == 0) {
+        fingerprint = 1;
+    }
+    
+    if (contains(m_tables[m_current], fingerprint) || contains(m_tables[1 - m_current], fingerprint)) {
+        return Duplicate;
+    }
+    
+    if (!insert(m_tables[m_current], fingerprint)) {
+        ++m_saturations;
+        rotate(nowMs);
+        insert(m_tables[m_current], fingerprint);
+    }
+    
+    return Accepted;
+}
+
+bool ReplayCache::contains(const std::vector<std::uint64_t>& table, std::uint64_t fingerprint) const {
+    std::size_t first = fingerprint & m_bucketMask;
+    std::size_t second = (fingerprint >> 32) & m_bucketMask;
+    
+    const std::uint64_t* a = table.data() + first * BucketSize;
+    const std::uint64_t* b = table.data() + second * BucketSize;
+    bool found = false;
+    for (int i = 0; i < BucketSize; ++i) {
+        found |= (a[i] == fingerprint) | (b[i] == fingerprint);
+    }
+    return found;
+}
+
+bool ReplayCache::insert(std::vector<std::uint64_t>& table, std::uint64_t fingerprint) {
+    std::size_t buckets[2] = { fingerprint & m_bucketMask, (fingerprint >> 32) & m_bucketMask };
+    for (std::size_t bucket : buckets) {
+        std::uint64_t* slots = table.data() + bucket * BucketSize;
+        for (int i = 0; i < BucketSize; ++i) {
+            if (slots[i] == 0) {
+                slots[i] = fingerprint;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void ReplayCache::rotate(std::int64_t nowMs) {
+    // After a whole idle generation the older one is stale as well
+    if (nowMs - m_generationStart >= 4 * m_window) {
+        std::fill(m_tables[m_current].begin(), m_tables[m_current].end(), 0);
+    }
+    m_current = 1 - m_current;
+    std::fill(m_tables[m_current].begin(), m_tables[m_current].end(), 0);
+    m_generationStart = nowMs;
+}
+
+} // namespace AsianCryptoPay
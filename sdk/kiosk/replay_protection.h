@@ -0,0 +1,130 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * Replay protection: X-Nonce values for outgoing requests and a bounded
+ * duplicate filter for inbound webhooks.
+ */
+
+#ifndef ASIAN_CRYPTO_PAYMENT_REPLAY_PROTECTION_H
+#define ASIAN_CRYPTO_PAYMENT_REPLAY_PROTECTION_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace AsianCryptoPay {
+
+/**
+ * @brief Lock-free request nonce generator
+ *
+ * A nonce is a random per-instance prefix followed by a keyed bijective mix
+ * of an atomic counter, so nonces never repeat within a session and are
+ * unrelated across sessions. Safe to call from any thread.
+ */
+class NonceGenerator {
+public:
+    /**
+     * @brief Nonce length in hex characters
+     */
+    static const int NonceLength = 32;
+    
+    /**
+     * @brief Constructor, seeds the prefix and mixing key from the OS
+     */
+    NonceGenerator();
+    
+    /**
+     * @brief Produce the next nonce
+     * @param out Receives NonceLength lowercase hex characters (not null-terminated)
+     */
+    void next(char out[NonceLength]);
+
+private:
+    std::uint64_t m_prefix;
+    std::uint64_t m_key;
+    std::atomic<std::uint64_t> m_counter;
+};
+
+/**
+ * @brief Fixed-size filter rejecting repeated webhook deliveries
+ *
+ * Events are accepted only inside a time window around the current time;
+ * events without a usable timestamp are never accepted, since nothing
+ * would bound how long a captured copy stays replayable.
+ * Fingerprints of accepted events are kept in two generations of a bucketed
+ * two-choice hash table; the older generation is dropped every two windows,
+ * so every event that could still pass the time check is remembered and
+ * memory never grows with traffic. Lookups and inserts touch at most four
+ * buckets.
+ *
+ * Not thread-safe; use from the thread that processes webhooks.
+ */
+class ReplayCache {
+public:
+    /**
+     * @brief Check outcome
+     */
+    enum Result {
+        Accepted,   ///< First sighting, now remembered
+        Duplicate,  ///< Seen within the window
+        Expired     ///< Event time is missing or outside the window
+    };
+    
+    /**
+     * @brief Marker for events without a timestamp; such events are Expired
+     */
+    static const std::int64_t NoTimestamp = std::numeric_limits<std::int64_t>::min();
+    
+    /**
+     * @brief Constructor
+     * @param capacity Fingerprints per generation
+     * @param windowMs Accepted clock skew and replay memory in milliseconds
+     */
+    explicit ReplayCache(std::size_t capacity = 16384, std::int64_t windowMs = 5 * 60 * 1000);
+    
+    /**
+     * @brief Check an event and remember it if new
+     * @param fingerprint Uniformly distributed event fingerprint, e.g. MAC bytes
+     * @param eventTimeMs Event time in milliseconds since epoch, or NoTimestamp
+     * @param nowMs Current time in milliseconds since epoch
+     * @return Check outcome
+     */
+    Result check(std::uint64_t fingerprint, std::int64_t eventTimeMs, std::int64_t nowMs);
+    
+    /**
+     * @brief Get window length
+     * @return Window in milliseconds
+     */
+    std::int64_t window() const { return m_window; }
+    
+    /**
+     * @brief Get number of early rotations caused by a full generation
+     *
+     * Non-zero means the burst rate exceeded capacity per window and the
+     * effective replay memory was shorter than the window.
+     *
+     * @return Early rotation count
+     */
+    std::uint64_t saturations() const { return m_saturations; }
+
+private:
+    static const int BucketSize = 8;
+    
+    bool contains(const std::vector<std::uint64_t>& table, std::uint64_t fingerprint) const;
+    bool insert(std::vector<std::uint64_t>& table, std::uint64_t fingerprint);
+    void rotate(std::int64_t nowMs);
+    
+    std::vector<std::uint64_t> m_tables[2];
+    int m_current;
+    std::size_t m_bucketMask;
+    std::int64_t m_window;
+    std::int64_t m_generationStart;
+    std::uint64_t m_saturations;
+};
+
+} // namespace AsianCryptoPay
+
+#endif // ASIAN_CRYPTO_PAYMENT_REPLAY_PROTECTION_H
@@ -0,0 +1,334 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * SHA-256 and HMAC-SHA256 implementation (FIPS 180-4, RFC 2104).
+ */
+
+#include "sha256.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ACP_SHA_X86 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+namespace AsianCryptoPay {
+
+namespace {
+
+inline std::uint32_t rotr(std::uint32_t x, int n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+inline std::uint32_t loadBigEndian(const unsigned char* p) {
+    return (std::uint32_t(p[0]) << 24) | (std::uint32_t(p[1]) << 16) | (std::uint32_t(p[2]) << 8) | std::uint32_t(p[3]);
+}
+
+inline void storeBigEndian(unsigned char* p, std::uint32_t v) {
+    p[0] = static_cast<unsigned char>(v >> 24);
+    p[1] = static_cast<unsigned char>(v >> 16);
+    p[2] = static_cast<unsigned char>(v >> 8);
+    p[3] = static_cast<unsigned char>(v);
+}
+
+void compressScalar(std::uint32_t state[8], const unsigned char* blocks, std::size_t blockCount) {
+    std::uint32_t w[64];
+    
+    for (std::size_t block = 0; block < blockCount; ++block, blocks += Sha256::BlockSize) {
+        for (int i = 0; i < 16; ++i) {
+            w[i] = loadBigEndian(blocks + i * 4);
+        }
+        for (int i = 16; i < 64; ++i) {
+            std::uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            std::uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+        
+        std::uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        std::uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        
+        for (int i = 0; i < 64; ++i) {
+            std::uint32_t s1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+            std::uint32_t ch = (e & f) ^ (~e & g);
+            std::uint32_t t1 = h + s1 + ch + Sha256::RoundConstants[i] + w[i];
+            std::uint32_t s0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+            std::uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+            std::uint32_t t2 = s0 + maj;
+            
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+}
+
+#ifdef ACP_SHA_X86
+
+bool hasShaExtensions() {
+    static const bool supported = [] {
+        unsigned int eax, ebx, ecx, edx;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+            return false;
+        }
+        bool ssse3 = (ecx & (1u << 9)) != 0;
+        bool sse41 = (ecx & (1u << 19)) != 0;
+        if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+            return false;
+        }
+        bool sha = (ebx & (1u << 29)) != 0;
+        return ssse3 && sse41 && sha;
+    }();
+    return supported;
+}
+
+// SHA-NI compression. Rounds run in groups of four; the message schedule
+// for group g + 1 is finished (msg2) and for group g + 3 started (msg1)
+// while group g is processed.
+__attribute__((target("sha,sse4.1,ssse3")))
+void compressShaNi(std::uint32_t state[8], const unsigned char* blocks, std::size_t blockCount) {
+    const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    
+    __m128i tmp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0]));
+    __m128i state1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4]));
+    tmp = _mm_shuffle_epi32(tmp, 0xB1);                 // CDAB
+    state1 = _mm_shuffle_epi32(state1, 0x1B);           // EFGH
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);   // ABEF
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);        // CDGH
+    
+    for (std::size_t block = 0; block < blockCount; ++block, blocks += Sha256::BlockSize) {
+        __m128i abefSave = state0;
+        __m128i cdghSave = state1;
+        __m128i schedule[4];
+        
+        for (int g = 0; g < 16; ++g) {
+            __m128i& current = schedule[g & 3];
+            if (g < 4) {
+                current = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks + 16 * g)), byteSwap);
+            }
+            
+            __m128i message = _mm_add_epi32(current, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Sha256::RoundConstants[4 * g])));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, message);
+            
+            if (g >= 3 && g <= 14) {
+                __m128i& upcoming = schedule[(g + 1) & 3];
+                upcoming = _mm_add_epi32(upcoming, _mm_alignr_epi8(current, schedule[(g + 3) & 3], 4));
+                upcoming = _mm_sha256msg2_epu32(upcoming, current);
+            }
+            
+            message = _mm_shuffle_epi32(message, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, message);
+            
+            if (g >= 1 && g <= 12) {
+                __m128i& previous = schedule[(g + 3) & 3];
+                previous = _mm_sha256msg1_epu32(previous, current);
+            }
+        }
+        
+        state0 = _mm_add_epi32(state0, abefSave);
+        state1 = _mm_add_epi32(state1, cdghSave);
+    }
+    
+    tmp = _mm_shuffle_epi32(state0, 0x1B);              // FEBA
+    state1 = _mm_shuffle_epi32(state1, 0xB1);           // DCHG
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);        // DCBA
+    state1 = _mm_alignr_epi8(state1, tmp, 8);           // ABEF
+    
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), state0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), state1);
+}
+
+#endif // ACP_SHA_X86
+
+} // namespace
+
+const std::uint32_t Sha256::RoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+const std::uint32_t Sha256::InitialState[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+Sha256::Sha256() {
+    reset();
+}
+
+Sha256::Sha256(const std::uint32_t state[8], std::uint64_t length)
+    : m_length(length)
+    , m_bufferSize(0)
+{
+    std::memcpy(m_state, state, sizeof(m_state));
+}
+
+void Sha256::reset() {
+    std::memcpy(m_state, InitialState, sizeof(m_state));
+    m_length = 0;
+    m_bufferSize = 0;
+}
+
+void Sha256::update(const void* data, std::size_t length) {
+    const unsigned char* input = static_cast<const unsigned char*>(data);
+    m_length += length;
+    
+    if (m_bufferSize > 0) {
+        std::size_t take = BlockSize - m_bufferSize;
+        if (take > length) {
+            take = length;
+        }
+        std::memcpy(m_buffer + m_bufferSize, input, take);
+        m_bufferSize += take;
+        input += take;
+        length -= take;
+        
+        if (m_bufferSize < static_cast<std::size_t>(BlockSize)) {
+            return;
+        }
+        compress(m_state, m_buffer, 1);
+        m_bufferSize = 0;
+    }
+    
+    std::size_t blocks = length / BlockSize;
+    if (blocks > 0) {
+        compress(m_state, input, blocks);
+        input += blocks * BlockSize;
+        length -= blocks * BlockSize;
+    }
+    
+    if (length > 0) {
+        std::memcpy(m_buffer, input, length);
+        m_bufferSize = length;
+    }
+}
+
+void Sha256::finish(unsigned char digest[DigestSize]) {
+    std::uint64_t bitLength = m_length * 8;
+    
+    m_buffer[m_bufferSize++] = 0x80;
+    if (m_bufferSize > static_cast<std::size_t>(BlockSize - 8)) {
+        std::memset(m_buffer + m_bufferSize, 0, BlockSize - m_bufferSize);
+        compress(m_state, m_buffer, 1);
+        m_bufferSize = 0;
+    }
+    std::memset(m_buffer + m_bufferSize, 0, BlockSize - 8 - m_bufferSize);
+    
+    for (int i = 0; i < 8; ++i) {
+        m_buffer[BlockSize - 1 - i] = static_cast<unsigned char>(bitLength >> (8 * i));
+    }
+    compress(m_state, m_buffer, 1);
+    
+    for (int i = 0; i < 8; ++i) {
+        storeBigEndian(digest + i * 4, m_state[i]);
+    }
+}
+
+void Sha256::hash(const void* data, std::size_t length, unsigned char digest[DigestSize]) {
+    Sha256 sha;
+    sha.update(data, length);
+    sha.finish(digest);
+}
+
+void Sha256::compress(std::uint32_t state[8], const unsigned char* blocks, std::size_t blockCount) {
+#ifdef ACP_SHA_X86
+    if (hasShaExtensions()) {
+        compressShaNi(state, blocks, blockCount);
+        return;
+    }
+#endif
+    compressScalar(state, blocks, blockCount);
+}
+
+const char* Sha256::implementation() {
+#ifdef ACP_SHA_X86
+    if (hasShaExtensions()) {
+        return "sha-ni";
+    }
+#endif
+    return "scalar";
+}
+
+HmacSha256Key::HmacSha256Key()
+    : m_valid(false)
+{
+    std::memset(m_inner, 0, sizeof(m_inner));
+    std::memset(m_outer, 0, sizeof(m_outer));
+}
+
+HmacSha256Key::HmacSha256Key(const void* key, std::size_t length)
+    : m_valid(true)
+{
+    unsigned char block[Sha256::BlockSize] = {0};
+    
+    if (length > static_cast<std::size_t>(Sha256::BlockSize)) {
+        Sha256::hash(key, length, block);
+    } else if (length > 0) {
+        std::memcpy(block, key, length);
+    }
+    
+    unsigned char pad[Sha256::BlockSize];
+    
+    for (int i = 0; i < Sha256::BlockSize; ++i) {
+        pad[i] = block[i] ^ 0x36;
+    }
+    std::memcpy(m_inner, Sha256::InitialState, sizeof(m_inner));
+    Sha256::compress(m_inner, pad, 1);
+    
+    for (int i = 0; i < Sha256::BlockSize; ++i) {
+        pad[i] = block[i] ^ 0x5c;
+    }
+    std::memcpy(m_outer, Sha256::InitialState, sizeof(m_outer));
+    Sha256::compress(m_outer, pad, 1);
+    
+    // Do not leave key material on the stack
+    volatile unsigned char* wipe = block;
+    for (int i = 0; i < Sha256::BlockSize; ++i) {
+        wipe[i] = 0;
+    }
+    wipe = pad;
+    for (int i = 0; i < Sha256::BlockSize; ++i) {
+        wipe[i] = 0;
+    }
+}
+
+HmacSha256::HmacSha256(const HmacSha256Key& key)
+    : m_key(key)
+    , m_inner(key.innerState(), Sha256::BlockSize)
+{
+}
+
+void HmacSha256::finish(unsigned char mac[MacSize]) {
+    unsigned char innerDigest[Sha256::DigestSize];
+    m_inner.finish(innerDigest);
+    finishOuter(m_key, innerDigest, mac);
+}
+
+void HmacSha256::finishOuter(const HmacSha256Key& key, const unsigned char innerDigest[Sha256::DigestSize], unsigned char mac[MacSize]) {
+    Sha256 outer(key.outerState(), Sha256::BlockSize);
+    outer.update(innerDigest, Sha256::DigestSize);
+    outer.finish(mac);
+}
+
+} // namespace AsianCryptoPay
@@ -0,0 +1,196 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * SHA-256 and HMAC-SHA256 with reusable key state. Request signing and
+ * webhook verification run once per request, so the HMAC key pads are
+ * hashed once per key instead of once per signature.
+ */
+
+#ifndef ASIAN_CRYPTO_PAYMENT_SHA256_H
+#define ASIAN_CRYPTO_PAYMENT_SHA256_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace AsianCryptoPay {
+
+/**
+ * @brief Streaming SHA-256
+ */
+class Sha256 {
+public:
+    /**
+     * @brief Digest size in bytes
+     */
+    static const int DigestSize = 32;
+    
+    /**
+     * @brief Block size in bytes
+     */
+    static const int BlockSize = 64;
+    
+    /**
+     * @brief Constructor, starts a new hash
+     */
+    Sha256();
+    
+    /**
+     * @brief Resume from an intermediate state
+     * @param state Chaining value after whole blocks
+     * @param length Number of bytes already absorbed, a multiple of BlockSize
+     */
+    Sha256(const std::uint32_t state[8], std::uint64_t length);
+    
+    /**
+     * @brief Restart with the initial hash value
+     */
+    void reset();
+    
+    /**
+     * @brief Absorb data
+     * @param data Data to hash
+     * @param length Length in bytes
+     */
+    void update(const void* data, std::size_t length);
+    
+    /**
+     * @brief Finish the hash
+     * @param digest Receives DigestSize bytes
+     */
+    void finish(unsigned char digest[DigestSize]);
+    
+    /**
+     * @brief Hash a buffer in one call
+     * @param data Data to hash
+     * @param length Length in bytes
+     * @param digest Receives DigestSize bytes
+     */
+    static void hash(const void* data, std::size_t length, unsigned char digest[DigestSize]);
+    
+    /**
+     * @brief Apply the compression function to whole blocks
+     * @param state Chaining value, updated in place
+     * @param blocks Input blocks
+     * @param blockCount Number of BlockSize blocks
+     */
+    static void compress(std::uint32_t state[8], const unsigned char* blocks, std::size_t blockCount);
+    
+    /**
+     * @brief Name of the compression implementation selected for this CPU
+     * @return "sha-ni" or "scalar"
+     */
+    static const char* implementation();
+    
+    /**
+     * @brief Initial hash value
+     */
+    static const std::uint32_t InitialState[8];
+    
+    /**
+     * @brief Round constants
+     */
+    static const std::uint32_t RoundConstants[64];
+
+private:
+    std::uint32_t m_state[8];
+    std::uint64_t m_length;
+    unsigned char m_buffer[BlockSize];
+    std::size_t m_bufferSize;
+};
+
+/**
+ * @brief Precomputed HMAC-SHA256 key
+ *
+ * Holds the chaining values after the inner (key ^ ipad) and outer
+ * (key ^ opad) blocks. The raw key is not retained.
+ */
+class HmacSha256Key {
+public:
+    /**
+     * @brief Constructor for an unset key
+     */
+    HmacSha256Key();
+    
+    /**
+     * @brief Constructor
+     * @param key Secret key bytes
+     * @param length Key length in bytes
+     */
+    HmacSha256Key(const void* key, std::size_t length);
+    
+    /**
+     * @brief Check if a key was set
+     * @return Whether the key is usable
+     */
+    bool isValid() const { return m_valid; }
+    
+    /**
+     * @brief Get chaining value after the inner pad block
+     * @return Inner state
+     */
+    const std::uint32_t* innerState() const { return m_inner; }
+    
+    /**
+     * @brief Get chaining value after the outer pad block
+     * @return Outer state
+     */
+    const std::uint32_t* outerState() const { return m_outer; }
+
+private:
+    std::uint32_t m_inner[8];
+    std::uint32_t m_outer[8];
+    bool m_valid;
+};
+
+/**
+ * @brief Streaming HMAC-SHA256 over a precomputed key
+ */
+class HmacSha256 {
+public:
+    /**
+     * @brief MAC size in bytes
+     */
+    static const int MacSize = Sha256::DigestSize;
+    
+    /**
+     * @brief Constructor
+     * @param key Precomputed key
+     */
+    explicit HmacSha256(const HmacSha256Key& key);
+    
+    /**
+     * @brief Absorb a message segment
+     * @param data Segment bytes
+     * @param length Segment length
+     */
+    void update(const void* data, std::size_t length) { m_inner.update(data, length); }
+    
+    /**
+     * @brief Finish the MAC
+     * @param mac Receives MacSize bytes
+     */
+    void finish(unsigned char mac[MacSize]);
+    
+    /**
+     * @brief Finish the inner hash only
+     * @param digest Receives the inner digest, to be fed through finishOuter()
+     */
+    void finishInner(unsigned char digest[Sha256::DigestSize]) { m_inner.finish(digest); }
+    
+    /**
+     * @brief Compute the outer hash over an inner digest
+     * @param key Precomputed key
+     * @param innerDigest Inner digest
+     * @param mac Receives MacSize bytes
+     */
+    static void finishOuter(const HmacSha256Key& key, const unsigned char innerDigest[Sha256::DigestSize], unsigned char mac[MacSize]);
+
+private:
+    const HmacSha256Key& m_key;
+    Sha256 m_inner;
+};
+
+} // namespace AsianCryptoPay
+
+#endif // ASIAN_CRYPTO_PAYMENT_SHA256_H
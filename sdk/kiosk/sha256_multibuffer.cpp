@@ -0,0 +1,224 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * Batched HMAC-SHA256 implementation. SHA-NI hashes a single stream faster
+ * than eight AVX2 lanes, so it is preferred when present; the AVX2 path is
+ * compiled with a target attribute and chosen at runtime.
+ */
+
+#include "sha256_multibuffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ACP_SHA_MB_X86 1
+#include <immintrin.h>
+#endif
+
+namespace AsianCryptoPay {
+
+namespace {
+
+void computeSerial(const HmacSha256Key& key, const unsigned char* const* messages,
+                   const std::size_t* lengths, std::size_t count, unsigned char* macs) {
+    for (std::size_t i = 0; i < count; ++i) {
+        HmacSha256 hmac(key);
+        hmac.update(messages[i], lengths[i]);
+        hmac.finish(macs + i * HmacSha256::MacSize);
+    }
+}
+
+#ifdef ACP_SHA_MB_X86
+
+inline std::uint32_t loadBigEndian(const unsigned char* p) {
+    return (static_cast<std::uint32_t>(p[0]) << 24) | (static_cast<std::uint32_t>(p[1]) << 16) |
+           (static_cast<std::uint32_t>(p[2]) << 8) | static_cast<std::uint32_t>(p[3]);
+}
+
+inline void storeBigEndian(unsigned char* p, std::uint64_t value, int bytes) {
+    for (int i = bytes - 1; i >= 0; --i) {
+        p[i] = static_cast<unsigned char>(value);
+        value >>= 8;
+    }
+}
+
+__attribute__((target("avx2")))
+inline __m256i rotr(__m256i x, int n) {
+    return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n));
+}
+
+// One block per lane; state is lane-interleaved (state[k] holds word k of
+// every lane). Lanes whose activeMask is zero keep their chaining value.
+__attribute__((target("avx2")))
+void compressLanes(__m256i state[8], const unsigned char* const blocks[HmacSha256Batch::Lanes], __m256i activeMask) {
+    __m256i w[16];
+    for (int t = 0; t < 16; ++t) {
+        w[t] = _mm256_setr_epi32(
+            static_cast<int>(loadBigEndian(blocks[0] + 4 * t)), static_cast<int>(loadBigEndian(blocks[1] + 4 * t)),
+            static_cast<int>(loadBigEndian(blocks[2] + 4 * t)), static_cast<int>(loadBigEndian(blocks[3] + 4 * t)),
+            static_cast<int>(loadBigEndian(blocks[4] + 4 * t)), static_cast<int>(loadBigEndian(blocks[5] + 4 * t)),
+            static_cast<int>(loadBigEndian(blocks[6] + 4 * t)), static_cast<int>(loadBigEndian(blocks[7] + 4 * t)));
+    }
+    
+    __m256i a = state[0], b = state[1], c = state[2], d = state[3];
+    __m256i e = state[4], f = state[5], g = state[6], h = state[7];
+    
+    for (int i = 0; i < 64; ++i) {
+        if (i >= 16) {
+            __m256i w15 = w[(i + 1) & 15];
+            __m256i w2 = w[(i + 14) & 15];
+            __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(rotr(w15, 7), rotr(w15, 18)), _mm256_srli_epi32(w15, 3));
+            __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(rotr(w2, 17), rotr(w2, 19)), _mm256_srli_epi32(w2, 10));
+            w[i & 15] = _mm256_add_epi32(_mm256_add_epi32(w[i & 15], s0), _mm256_add_epi32(w[(i + 9) & 15], s1));
+        }
+        
+        __m256i bigSigma1 = _mm256_xor_si256(_mm256_xor_si256(rotr(e, 6), rotr(e, 11)), rotr(e, 25));
+        __m256i ch = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        __m256i t1 = _mm256_add_epi32(_mm256_add_epi32(h, bigSigma1),
+                                      _mm256_add_epi32(_mm256_add_epi32(ch, w[i & 15]),
+                                                       _mm256_set1_epi32(static_cast<int>(Sha256::RoundConstants[i]))));
+        __m256i bigSigma0 = _mm256_xor_si256(_mm256_xor_si256(rotr(a, 2), rotr(a, 13)), rotr(a, 22));
+        __m256i maj = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)));
+        __m256i t2 = _mm256_add_epi32(bigSigma0, maj);
+        
+        h = g;
+        g = f;
+        f = e;
+        e = _mm256_add_epi32(d, t1);
+        d = c;
+        c = b;
+        b = a;
+        a = _mm256_add_epi32(t1, t2);
+    }
+    
+    const __m256i updated[8] = { a, b, c, d, e, f, g, h };
+    for (int k = 0; k < 8; ++k) {
+        state[k] = _mm256_blendv_epi8(state[k], _mm256_add_epi32(state[k], updated[k]), activeMask);
+    }
+}
+
+__attribute__((target("avx2")))
+void storeLanes(const __m256i state[8], int lanes, unsigned char* out) {
+    alignas(32) std::uint32_t words[HmacSha256Batch::Lanes];
+    for (int k = 0; k < 8; ++k) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(words), state[k]);
+        for (int lane = 0; lane < lanes; ++lane) {
+            storeBigEndian(out + lane * Sha256::DigestSize + 4 * k, words[lane], 4);
+        }
+    }
+}
+
+// Up to eight messages. Each lane streams its whole blocks straight from the
+// message and its padded tail from a local buffer; lanes that finish early
+// are masked off while the longest message completes.
+__attribute__((target("avx2")))
+void computeGroupAvx2(const HmacSha256Key& key, const unsigned char* const* messages,
+                      const std::size_t* lengths, int lanes, unsigned char* macs) {
+    const int Lanes = HmacSha256Batch::Lanes;
+    static const unsigned char zeroBlock[Sha256::BlockSize] = {};
+    
+    unsigned char tails[Lanes][2 * Sha256::BlockSize];
+    std::size_t fullBlocks[Lanes];
+    std::size_t totalBlocks[Lanes];
+    std::size_t maxBlocks = 0;
+    
+    for (int lane = 0; lane < Lanes; ++lane) {
+        if (lane >= lanes) {
+            fullBlocks[lane] = totalBlocks[lane] = 0;
+            continue;
+        }
+        std::size_t length = lengths[lane];
+        std::size_t tail = length % Sha256::BlockSize;
+        std::size_t tailBlocks = tail + 9 > Sha256::BlockSize ? 2 : 1;
+        fullBlocks[lane] = length / Sha256::BlockSize;
+        totalBlocks[lane] = fullBlocks[lane] + tailBlocks;
+        maxBlocks = std::max(maxBlocks, totalBlocks[lane]);
+        
+        unsigned char* buffer = tails[lane];
+        std::memset(buffer, 0, sizeof(tails[lane]));
+        if (tail > 0) {
+            std::memcpy(buffer, messages[lane] + length - tail, tail);
+        }
+        buffer[tail] = 0x80;
+        // The inner hash has already absorbed the key block
+        std::uint64_t bitLength = (static_cast<std::uint64_t>(length) + Sha256::BlockSize) * 8;
+        storeBigEndian(buffer + tailBlocks * Sha256::BlockSize - 8, bitLength, 8);
+    }
+    
+    __m256i state[8];
+    for (int k = 0; k < 8; ++k) {
+        state[k] = _mm256_set1_epi32(static_cast<int>(key.innerState()[k]));
+    }
+    
+    const unsigned char* blocks[Lanes];
+    alignas(32) std::int32_t active[Lanes];
+    for (std::size_t block = 0; block < maxBlocks; ++block) {
+        for (int lane = 0; lane < Lanes; ++lane) {
+            if (block < fullBlocks[lane]) {
+                blocks[lane] = messages[lane] + block * Sha256::BlockSize;
+            } else if (block < totalBlocks[lane]) {
+                blocks[lane] = tails[lane] + (block - fullBlocks[lane]) * Sha256::BlockSize;
+            } else {
+                blocks[lane] = zeroBlock;
+            }
+            active[lane] = block < totalBlocks[lane] ? -1 : 0;
+        }
+        compressLanes(state, blocks, _mm256_load_si256(reinterpret_cast<const __m256i*>(active)));
+    }
+    
+    // Outer hash: one block per lane holding the inner digest and padding
+    unsigned char outerBlocks[Lanes][Sha256::BlockSize];
+    unsigned char innerDigests[Lanes * Sha256::DigestSize];
+    storeLanes(state, lanes, innerDigests);
+    for (int lane = 0; lane < Lanes; ++lane) {
+        std::memset(outerBlocks[lane], 0, Sha256::BlockSize);
+        if (lane < lanes) {
+            std::memcpy(outerBlocks[lane], innerDigests + lane * Sha256::DigestSize, Sha256::DigestSize);
+        }
+        outerBlocks[lane][Sha256::DigestSize] = 0x80;
+        storeBigEndian(outerBlocks[lane] + Sha256::BlockSize - 8, (Sha256::BlockSize + Sha256::DigestSize) * 8, 8);
+        blocks[lane] = outerBlocks[lane];
+    }
+    for (int k = 0; k < 8; ++k) {
+        state[k] = _mm256_set1_epi32(static_cast<int>(key.outerState()[k]));
+    }
+    compressLanes(state, blocks, _mm256_set1_epi32(-1));
+    storeLanes(state, lanes, macs);
+}
+
+bool useAvx2Lanes() {
+    static const bool supported = std::strcmp(Sha256::implementation(), "scalar") == 0 &&
+                                  __builtin_cpu_supports("avx2");
+    return supported;
+}
+
+#endif // ACP_SHA_MB_X86
+
+} // namespace
+
+void HmacSha256Batch::compute(const HmacSha256Key& key, const unsigned char* const* messages,
+                              const std::size_t* lengths, std::size_t count, unsigned char* macs) {
+#ifdef ACP_SHA_MB_X86
+    if (useAvx2Lanes()) {
+        for (std::size_t i = 0; i < count; i += Lanes) {
+            int lanes = static_cast<int>(std::min<std::size_t>(Lanes, count - i));
+            computeGroupAvx2(key, messages + i, lengths + i, lanes, macs + i * HmacSha256::MacSize);
+        }
+        return;
+    }
+#endif
+    computeSerial(key, messages, lengths, count, macs);
+}
+
+const char* HmacSha256Batch::implementation() {
+#ifdef ACP_SHA_MB_X86
+    if (useAvx2Lanes()) {
+        return "avx2";
+    }
+#endif
+    return Sha256::implementation();
+}
+
+} // namespace AsianCryptoPay
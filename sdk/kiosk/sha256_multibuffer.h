@@ -0,0 +1,49 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * Batched HMAC-SHA256 for verifying bursts of webhook deliveries that share
+ * one secret. Messages are hashed eight at a time in AVX2 lanes, or one at a
+ * time through SHA-NI when the CPU has it, with a scalar fallback.
+ */
+
+#ifndef ASIAN_CRYPTO_PAYMENT_SHA256_MULTIBUFFER_H
+#define ASIAN_CRYPTO_PAYMENT_SHA256_MULTIBUFFER_H
+
+#include <cstddef>
+
+#include "sha256.h"
+
+namespace AsianCryptoPay {
+
+/**
+ * @brief HMAC-SHA256 over many messages with the same key
+ */
+class HmacSha256Batch {
+public:
+    /**
+     * @brief Number of messages hashed together by the AVX2 path
+     */
+    static const int Lanes = 8;
+    
+    /**
+     * @brief Compute one MAC per message
+     * @param key Precomputed key
+     * @param messages Message pointers
+     * @param lengths Message lengths in bytes
+     * @param count Number of messages
+     * @param macs Receives count * HmacSha256::MacSize bytes
+     */
+    static void compute(const HmacSha256Key& key, const unsigned char* const* messages,
+                        const std::size_t* lengths, std::size_t count, unsigned char* macs);
+    
+    /**
+     * @brief Name of the implementation selected for this CPU
+     * @return "sha-ni", "avx2" or "scalar"
+     */
+    static const char* implementation();
+};
+
+} // namespace AsianCryptoPay
+
+#endif // ASIAN_CRYPTO_PAYMENT_SHA256_MULTIBUFFER_H
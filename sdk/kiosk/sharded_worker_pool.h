@@ -0,0 +1,223 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * Worker pool that routes each job to a fixed worker by key, so jobs with
+ * the same key run in submission order while different keys run in
+ * parallel. Jobs and results move through lock-free SPSC queues.
+ */
+
+#ifndef ASIAN_CRYPTO_PAYMENT_SHARDED_WORKER_POOL_H
+#define ASIAN_CRYPTO_PAYMENT_SHARDED_WORKER_POOL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "spsc_queue.h"
+
+namespace AsianCryptoPay {
+
+/**
+ * @brief Keyed worker pool with one input and one output queue per worker
+ *
+ * submit() must always be called from the same thread, and drain() from
+ * one (possibly different) thread, typically the owner's event loop. The
+ * notify callback runs on a worker thread whenever results become
+ * available after a drain(), at most once until the next drain().
+ */
+template <typename Job, typename Result>
+class ShardedWorkerPool {
+public:
+    /**
+     * @brief Work function, called on a worker thread
+     */
+    typedef std::function<void(Job& job, Result& result)> Work;
+    
+    /**
+     * @brief Results-ready callback, called on a worker thread
+     */
+    typedef std::function<void()> Notify;
+    
+    /**
+     * @brief Constructor, starts the workers
+     * @param threads Number of workers, at least one
+     * @param queueCapacity Jobs and results buffered per worker
+     * @param work Work function
+     * @param notify Results-ready callback
+     */
+    ShardedWorkerPool(int threads, std::size_t queueCapacity, Work work, Notify notify = Notify())
+        : m_work(std::move(work))
+        , m_notify(std::move(notify))
+        , m_stopping(false)
+        , m_notified(false)
+        , m_nextShard(0)
+    {
+        if (threads < 1) {
+            threads = 1;
+        }
+        for (int i = 0; i < threads; ++i) {
+            m_shards.emplace_back(new Shard(queueCapacity));
+        }
+        for (auto& shard : m_shards) {
+            Shard* target = shard.get();
+            shard->thread = std::thread([this, target]() { run(*target); });
+        }
+    }
+    
+    /**
+     * @brief Destructor, stops the workers; unprocessed jobs are dropped
+     */
+    ~ShardedWorkerPool() {
+        m_stopping.store(true, std::memory_order_seq_cst);
+        for (auto& shard : m_shards) {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->wake.notify_one();
+        }
+        for (auto& shard : m_shards) {
+            shard->thread.join();
+        }
+    }
+    
+    ShardedWorkerPool(const ShardedWorkerPool&) = delete;
+    ShardedWorkerPool& operator=(const ShardedWorkerPool&) = delete;
+    
+    /**
+     * @brief Get number of workers
+     * @return Worker count
+     */
+    int threadCount() const { return static_cast<int>(m_shards.size()); }
+    
+    /**
+     * @brief Queue a job on the worker owning its key; submitting thread only
+     * @param key Shard key, e.g. a hash of the payment id
+     * @param job Job to move in
+     * @return False if that worker's queue is full
+     */
+    bool submit(std::uint64_t key, Job&& job) {
+        Shard& shard = *m_shards[key % m_shards.size()];
+        if (!shard.input.push(std::move(job))) {
+            return false;
+        }
+        // Pairs with the fence in run(): either the worker sees the job or we see it asleep
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (shard.sleeping.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.wake.notify_one();
+        }
+        return true;
+    }
+    
+    /**
+     * @brief Hand finished results to a callback; draining thread only
+     * @param consume Callable taking Result&
+     * @param limit Maximum number of results to consume
+     * @return Number of results consumed
+     */
+    template <typename Consume>
+    std::size_t drain(Consume consume, std::size_t limit = std::numeric_limits<std::size_t>::max()) {
+        m_notified.store(false, std::memory_order_seq_cst);
+        
+        std::size_t consumed = 0;
+        std::size_t idle = 0;
+        Result result;
+        // Round robin so one busy worker cannot starve the others
+        while (consumed < limit && idle < m_shards.size()) {
+            Shard& shard = *m_shards[m_nextShard];
+            m_nextShard = (m_nextShard + 1) % m_shards.size();
+            if (shard.output.pop(result)) {
+                consume(result);
+                ++consumed;
+                idle = 0;
+            } else {
+                ++idle;
+            }
+        }
+        return consumed;
+    }
+    
+    /**
+     * @brief Get approximate number of queued jobs and unconsumed results
+     * @return Backlog size
+     */
+    std::size_t backlog() const {
+        std::size_t total = 0;
+        for (const auto& shard : m_shards) {
+            total += shard->input.sizeApprox() + shard->output.sizeApprox();
+        }
+        return total;
+    }
+
+private:
+    struct Shard {
+        explicit Shard(std::size_t capacity)
+            : input(capacity)
+            , output(capacity)
+            , sleeping(false)
+        {
+        }
+        
+        SpscQueue<Job> input;
+        SpscQueue<Result> output;
+        std::atomic<bool> sleeping;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::thread thread;
+    };
+    
+    void run(Shard& shard) {
+        Job job;
+        for (;;) {
+            if (shard.input.pop(job)) {
+                Result result;
+                m_work(job, result);
+                job = Job();
+                
+                // Wait for the owner to catch up rather than drop a result
+                while (!shard.output.push(std::move(result))) {
+                    if (m_stopping.load(std::memory_order_acquire)) {
+                        return;
+                    }
+                    std::this_thread::yield();
+                }
+                if (!m_notified.exchange(true, std::memory_order_seq_cst) && m_notify) {
+                    m_notify();
+                }
+                continue;
+            }
+            
+            if (m_stopping.load(std::memory_order_acquire)) {
+                return;
+            }
+            
+            std::unique_lock<std::mutex> lock(shard.mutex);
+            shard.sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (shard.input.sizeApprox() == 0 && !m_stopping.load(std::memory_order_acquire)) {
+                // The timeout only bounds the cost of a missed wakeup
+                shard.wake.wait_for(lock, std::chrono::milliseconds(50));
+            }
+            shard.sleeping.store(false, std::memory_order_relaxed);
+        }
+    }
+    
+    std::vector<std::unique_ptr<Shard>> m_shards;
+    Work m_work;
+    Notify m_notify;
+    std::atomic<bool> m_stopping;
+    std::atomic<bool> m_notified;
+    std::size_t m_nextShard;
+};
+
+} // namespace AsianCryptoPay
+
+#endif // ASIAN_CRYPTO_PAYMENT_SHARDED_WORKER_POOL_H
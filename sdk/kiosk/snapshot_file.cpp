@@ -0,0 +1,113 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * Snapshot file implementation.
+ */
+
+#include "snapshot_file.h"
+#include "crc32c.h"
+#include "mapped_file.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace AsianCryptoPay {
+
+namespace {
+
+// File: this header, then the contents
+const char kSnapshotMagic[8] = { 'A', 'C', 'P', 'S', 'N', 'A', 'P', '1' };
+
+struct SnapshotHeader {
+    char magic[8];
+    std::int64_t timeMs;
+    std::uint64_t length;
+    std::uint32_t crc;      ///< CRC-32C of timeMs, length and the contents
+    std::uint32_t reserved;
+};
+
+std::uint32_t snapshotCrc(const SnapshotHeader& header, const void* data) {
+    std::uint32_t crc = crc32c(0, &header.timeMs, sizeof(header.timeMs) + sizeof(header.length));
+    return crc32c(crc, data, static_cast<std::size_t>(header.length));
+}
+
+std::string directoryOf(const std::string& path) {
+    std::string::size_type slash = path.find_last_of('/');
+    return slash == std::string::npos ? std::string(".") : path.substr(0, slash + 1) + ".";
+}
+
+} // namespace
+
+bool SnapshotFile::write(const std::string& path, const void* data, std::size_t length, std::int64_t timeMs, std::string* error) {
+    SnapshotHeader header;
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+    header.timeMs = timeMs;
+    header.length = length;
+    header.reserved = 0;
+    header.crc = snapshotCrc(header, data);
+    
+    std::string temporary = path + ".tmp";
+    std::remove(temporary.c_str());
+    
+    {
+        MappedFile file;
+        if (!file.open(temporary, MappedFile::ReadWrite, sizeof(header) + length, error)) {
+            return false;
+        }
+        std::memcpy(file.data(), &header, sizeof(header));
+        std::memcpy(file.data() + sizeof(header), data, length);
+        if (!file.sync(0, file.size())) {
+            if (error) {
+                *error = temporary + ": sync failed";
+            }
+            file.close();
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        if (error) {
+            *error = path + ": rename failed";
+        }
+        std::remove(temporary.c_str());
+        return false;
+    }
+    MappedFile::syncDirectory(directoryOf(path));
+    return true;
+}
+
+bool SnapshotFile::read(const std::string& path, std::string* data, std::int64_t* timeMs, std::string* error) {
+    MappedFile file;
+    if (!file.open(path, MappedFile::ReadOnly, 0, error)) {
+        return false;
+    }
+    
+    SnapshotHeader header;
+    if (file.size() < sizeof(header)) {
+        if (error) {
+            *error = path + ": truncated snapshot";
+        }
+        return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    
+    const char* contents = file.data() + sizeof(header);
+    if (std::memcmp(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0
+            || header.length > file.size() - sizeof(header)
+            || snapshotCrc(header, contents) != header.crc) {
+        if (error) {
+            *error = path + ": corrupt snapshot";
+        }
+        return false;
+    }
+    
+    data->assign(contents, static_cast<std::size_t>(header.length));
+    if (timeMs) {
+        *timeMs = header.timeMs;
+    }
+    return true;
+}
+
+} // namespace AsianCryptoPay
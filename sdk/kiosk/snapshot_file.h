@@ -0,0 +1,51 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * Whole-file snapshots that are replaced atomically.
+ */
+
+#ifndef ASIAN_CRYPTO_PAYMENT_SNAPSHOT_FILE_H
+#define ASIAN_CRYPTO_PAYMENT_SNAPSHOT_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace AsianCryptoPay {
+
+/**
+ * @brief Checksummed blob written with write-rename
+ *
+ * write() fills a memory-mapped temporary file next to the target, syncs
+ * it, renames it over the target and syncs the directory, so a reader sees
+ * either the previous snapshot or the new one, never a mix. read() rejects
+ * files whose header or CRC-32C does not match.
+ */
+class SnapshotFile {
+public:
+    /**
+     * @brief Atomically replace a snapshot
+     * @param path Snapshot file path
+     * @param data Snapshot contents
+     * @param length Number of bytes
+     * @param timeMs Time the snapshot was taken
+     * @param error Receives a description on failure, may be null
+     * @return Whether the new snapshot is durable
+     */
+    static bool write(const std::string& path, const void* data, std::size_t length, std::int64_t timeMs, std::string* error = nullptr);
+    
+    /**
+     * @brief Load a snapshot
+     * @param path Snapshot file path
+     * @param data Receives the snapshot contents
+     * @param timeMs Receives the time the snapshot was taken, may be null
+     * @param error Receives a description on failure, may be null
+     * @return Whether an intact snapshot was read
+     */
+    static bool read(const std::string& path, std::string* data, std::int64_t* timeMs = nullptr, std::string* error = nullptr);
+};
+
+} // namespace AsianCryptoPay
+
+#endif // ASIAN_CRYPTO_PAYMENT_SNAPSHOT_FILE_H
@@ -0,0 +1,116 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * Bounded single-producer single-consumer queue for handing work between
+ * an I/O thread and the SDK owner thread without locks.
+ */
+
+#ifndef ASIAN_CRYPTO_PAYMENT_SPSC_QUEUE_H
+#define ASIAN_CRYPTO_PAYMENT_SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace AsianCryptoPay {
+
+/**
+ * @brief Fixed-capacity ring buffer with one producer and one consumer thread
+ *
+ * push() fails instead of blocking when full, which lets the producer apply
+ * backpressure (e.g. answer 503) rather than buffer without bound.
+ */
+template <typename T>
+class SpscQueue {
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Minimum number of slots, rounded up to a power of two
+     */
+    explicit SpscQueue(std::size_t capacity)
+        : m_head(0)
+        , m_cachedTail(0)
+        , m_tail(0)
+        , m_cachedHead(0)
+    {
+        std::size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        m_slots.resize(size);
+        m_mask = size - 1;
+    }
+    
+    /**
+     * @brief Append a value; producer thread only
+     * @param value Value to move in
+     * @return False if the queue is full
+     */
+    bool push(T&& value) {
+        std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead > m_mask) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead > m_mask) {
+                return false;
+            }
+        }
+        m_slots[tail & m_mask] = std::move(value);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+    
+    /**
+     * @brief Remove the oldest value; consumer thread only
+     * @param value Receives the value
+     * @return False if the queue is empty
+     */
+    bool pop(T& value) {
+        std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) {
+                return false;
+            }
+        }
+        value = std::move(m_slots[head & m_mask]);
+        m_slots[head & m_mask] = T();
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+    
+    /**
+     * @brief Get number of queued values; exact only when both sides are idle
+     * @return Approximate size
+     */
+    std::size_t sizeApprox() const {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+    
+    /**
+     * @brief Get capacity
+     * @return Number of slots
+     */
+    std::size_t capacity() const { return m_mask + 1; }
+
+private:
+    static const std::size_t CacheLine = 64;
+    
+    std::vector<T> m_slots;
+    std::size_t m_mask;
+    
+    // Consumer and producer indexes on separate cache lines, each next to
+    // the copy of the other side's index that its owner caches
+    char m_pad0[CacheLine];
+    std::atomic<std::size_t> m_head;
+    std::size_t m_cachedTail;
+    char m_pad1[CacheLine];
+    std::atomic<std::size_t> m_tail;
+    std::size_t m_cachedHead;
+    char m_pad2[CacheLine];
+};
+
+} // namespace AsianCryptoPay
+
+#endif // ASIAN_CRYPTO_PAYMENT_SPSC_QUEUE_H
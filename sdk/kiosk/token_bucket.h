@@ -0,0 +1,104 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * Token bucket used to keep request bursts inside the API rate limits.
+ */
+
+#ifndef ASIAN_CRYPTO_PAYMENT_TOKEN_BUCKET_H
+#define ASIAN_CRYPTO_PAYMENT_TOKEN_BUCKET_H
+
+#include <algorithm>
+#include <cstdint>
+
+namespace AsianCryptoPay {
+
+/**
+ * @brief Request budget refilled continuously at a fixed rate
+ *
+ * Starts full, so up to the whole per-period allowance can go out at once.
+ * The server's own view (X-RateLimit-Remaining / X-RateLimit-Reset) can only
+ * lower the budget, never raise it.
+ */
+class TokenBucket {
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Requests allowed per period
+     * @param periodMs Period in milliseconds
+     */
+    TokenBucket(int capacity, std::int64_t periodMs)
+        : m_capacity(std::max(1, capacity))
+        , m_msPerToken(static_cast<double>(std::max<std::int64_t>(1, periodMs)) / m_capacity)
+        , m_tokens(m_capacity)
+        , m_updatedMs(0)
+        , m_blockedUntilMs(0)
+    {
+    }
+    
+    /**
+     * @brief Check if a request may go out now
+     * @param nowMs Current time
+     * @return Whether a token is available
+     */
+    bool available(std::int64_t nowMs) {
+        refill(nowMs);
+        return nowMs >= m_blockedUntilMs && m_tokens >= 1.0;
+    }
+    
+    /**
+     * @brief Account for a request that went out
+     *
+     * Requests the caller could not defer are counted even with the budget
+     * spent; the debt delays later deferrable ones.
+     *
+     * @param nowMs Current time
+     */
+    void take(std::int64_t nowMs) {
+        refill(nowMs);
+        m_tokens -= 1.0;
+    }
+    
+    /**
+     * @brief Get time until the next token
+     * @param nowMs Current time
+     * @return Milliseconds, 0 if a request may go out now
+     */
+    std::int64_t waitMs(std::int64_t nowMs) {
+        refill(nowMs);
+        std::int64_t wait = m_tokens >= 1.0 ? 0 : static_cast<std::int64_t>((1.0 - m_tokens) * m_msPerToken) + 1;
+        return std::max(wait, m_blockedUntilMs - nowMs);
+    }
+    
+    /**
+     * @brief Apply the server's rate limit headers
+     * @param remaining Requests left in the server's window
+     * @param resetAtMs When the server's window resets
+     * @param nowMs Current time
+     */
+    void limit(int remaining, std::int64_t resetAtMs, std::int64_t nowMs) {
+        refill(nowMs);
+        m_tokens = std::min(m_tokens, static_cast<double>(std::max(0, remaining)));
+        if (remaining <= 0 && resetAtMs > nowMs) {
+            m_blockedUntilMs = resetAtMs;
+        }
+    }
+
+private:
+    void refill(std::int64_t nowMs) {
+        if (nowMs > m_updatedMs) {
+            m_tokens = std::min<double>(m_capacity, m_tokens + (nowMs - m_updatedMs) / m_msPerToken);
+            m_updatedMs = nowMs;
+        }
+    }
+    
+    int m_capacity;
+    double m_msPerToken;
+    double m_tokens;
+    std::int64_t m_updatedMs;
+    std::int64_t m_blockedUntilMs;
+};
+
+} // namespace AsianCryptoPay
+
+#endif // ASIAN_CRYPTO_PAYMENT_TOKEN_BUCKET_H
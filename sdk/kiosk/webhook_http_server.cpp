@@ -0,0 +1,701 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * Webhook HTTP server implementation.
+ */
+
+#include "webhook_http_server.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace AsianCryptoPay {
+
+namespace {
+
+const std::size_t kMaxHeaderBytes = 8192;
+const std::size_t kReadChunk = 16384;
+const int kMaxSweepIntervalMs = 1000;
+
+const char kAccepted[] = "HTTP/1.1 202 Accepted\r\nContent-Length: 0\r\n\r\n";
+const char kAcceptedClose[] = "HTTP/1.1 202 Accepted\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+const char kBusy[] = "HTTP/1.1 503 Service Unavailable\r\nRetry-After: 1\r\nContent-Length: 0\r\n\r\n";
+const char kBusyClose[] = "HTTP/1.1 503 Service Unavailable\r\nRetry-After: 1\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+const char kContinue[] = "HTTP/1.1 100 Continue\r\n\r\n";
+
+const char* reasonPhrase(int status) {
+    switch (status) {
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 408: return "Request Timeout";
+    case 411: return "Length Required";
+    case 413: return "Payload Too Large";
+    case 431: return "Request Header Fields Too Large";
+    case 501: return "Not Implemented";
+    case 505: return "HTTP Version Not Supported";
+    default: return "Error";
+    }
+}
+
+inline bool tokenEquals(const char* data, std::size_t length, const char* token) {
+    std::size_t tokenLength = std::strlen(token);
+    if (length != tokenLength) {
+        return false;
+    }
+    for (std::size_t i = 0; i < length; ++i) {
+        char a = data[i];
+        char b = token[i];
+        if (a >= 'A' && a <= 'Z') {
+            a = static_cast<char>(a - 'A' + 'a');
+        }
+        if (a != b) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Case-insensitive search for a lowercase token in a comma-separated list
+bool listContains(const char* data, std::size_t length, const char* token) {
+    std::size_t start = 0;
+    while (start < length) {
+        std::size_t end = start;
+        while (end < length && data[end] != ',') {
+            ++end;
+        }
+        std::size_t first = start;
+        std::size_t last = end;
+        while (first < last && (data[first] == ' ' || data[first] == '\t')) {
+            ++first;
+        }
+        while (last > first && (data[last - 1] == ' ' || data[last - 1] == '\t')) {
+            --last;
+        }
+        if (tokenEquals(data + first, last - first, token)) {
+            return true;
+        }
+        start = end + 1;
+    }
+    return false;
+}
+
+std::int64_t monotonicMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+/**
+ * Per-connection state. Offsets of the request being parsed are relative to
+ * the first unconsumed byte of the input buffer.
+ */
+struct WebhookHttpServer::Connection {
+    int fd = -1;
+    std::vector<char> input;
+    std::size_t consumed = 0;
+    std::size_t scanned = 0;
+    std::string output;
+    std::size_t written = 0;
+    bool writeWatched = false;
+    bool closeAfterWrite = false;
+    std::int64_t lastActivityMs = 0;
+    std::int64_t requestStartedMs = 0;     ///< First byte of the pending request, 0 if none
+    
+    bool headerParsed = false;
+    std::size_t headerLength = 0;
+    std::size_t contentLength = 0;
+    std::size_t signatureOffset = 0;
+    std::size_t signatureLength = 0;
+    bool keepAlive = true;
+    bool expectContinue = false;
+    bool continueSent = false;
+    int errorStatus = 0;
+    
+    void resetRequest() {
+        headerParsed = false;
+        headerLength = 0;
+        contentLength = 0;
+        signatureOffset = 0;
+        signatureLength = 0;
+        keepAlive = true;
+        expectContinue = false;
+        continueSent = false;
+        errorStatus = 0;
+        scanned = 0;
+    }
+};
+
+WebhookHttpServer::WebhookHttpServer(Handler handler)
+    : m_handler(std::move(handler))
+    , m_path("/webhook")
+    , m_maxBodySize(1024 * 1024)
+    , m_maxConnections(1024)
+    , m_requestTimeoutMs(10000)
+    , m_idleTimeoutMs(60000)
+    , m_listenFd(-1)
+    , m_epollFd(-1)
+    , m_wakeFd(-1)
+    , m_port(0)
+    , m_nowMs(0)
+    , m_nextSweepMs(0)
+    , m_connectionsAccepted(0)
+    , m_connectionsOpen(0)
+    , m_requests(0)
+    , m_accepted(0)
+    , m_rejectedBusy(0)
+    , m_rejectedInvalid(0)
+    , m_timedOut(0)
+    , m_bytesReceived(0)
+{
+}
+
+WebhookHttpServer::~WebhookHttpServer() {
+    stop();
+}
+
+WebhookHttpServer::Stats WebhookHttpServer::stats() const {
+    Stats stats;
+    stats.connectionsAccepted = m_connectionsAccepted.load(std::memory_order_relaxed);
+    stats.connectionsOpen = m_connectionsOpen.load(std::memory_order_relaxed);
+    stats.requests = m_requests.load(std::memory_order_relaxed);
+    stats.accepted = m_accepted.load(std::memory_order_relaxed);
+    stats.rejectedBusy = m_rejectedBusy.load(std::memory_order_relaxed);
+    stats.rejectedInvalid = m_rejectedInvalid.load(std::memory_order_relaxed);
+    stats.timedOut = m_timedOut.load(std::memory_order_relaxed);
+    stats.bytesReceived = m_bytesReceived.load(std::memory_order_relaxed);
+    return stats;
+}
+
+#ifdef __linux__
+
+bool WebhookHttpServer::start(const std::string& address, std::uint16_t port, std::string* error) {
+    if (isRunning()) {
+        return true;
+    }
+    
+    auto fail = [&](const char* what) {
+        if (error) {
+            *error = std::string(what) + ": " + std::strerror(errno);
+        }
+        if (m_listenFd >= 0) ::close(m_listenFd);
+        if (m_epollFd >= 0) ::close(m_epollFd);
+        if (m_wakeFd >= 0) ::close(m_wakeFd);
+        m_listenFd = m_epollFd = m_wakeFd = -1;
+        return false;
+    };
+    
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1) {
+        errno = EINVAL;
+        return fail("Invalid listen address");
+    }
+    
+    m_listenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_listenFd < 0) {
+        return fail("socket");
+    }
+    int enable = 1;
+    ::setsockopt(m_listenFd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    if (::bind(m_listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        return fail("bind");
+    }
+    if (::listen(m_listenFd, SOMAXCONN) < 0) {
+        return fail("listen");
+    }
+    socklen_t addrLength = sizeof(addr);
+    ::getsockname(m_listenFd, reinterpret_cast<sockaddr*>(&addr), &addrLength);
+    m_port = ntohs(addr.sin_port);
+    
+    m_epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    m_wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_epollFd < 0 || m_wakeFd < 0) {
+        return fail("epoll");
+    }
+    
+    // The listener and wake descriptors are tagged with null and this;
+    // connections with their Connection pointer
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = nullptr;
+    ::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_listenFd, &event);
+    event.data.ptr = this;
+    ::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &event);
+    
+    m_thread = std::thread(&WebhookHttpServer::run, this);
+    return true;
+}
+
+void WebhookHttpServer::stop() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+    std::uint64_t one = 1;
+    ssize_t ignored = ::write(m_wakeFd, &one, sizeof(one));
+    (void)ignored;
+    m_thread.join();
+    
+    ::close(m_listenFd);
+    ::close(m_epollFd);
+    ::close(m_wakeFd);
+    m_listenFd = m_epollFd = m_wakeFd = -1;
+}
+
+void WebhookHttpServer::run() {
+    epoll_event events[64];
+    
+    // Deadlines are enforced to within a quarter of the shorter timeout
+    int sweepIntervalMs = std::min(m_requestTimeoutMs, m_idleTimeoutMs) / 4;
+    sweepIntervalMs = std::max(1, std::min(sweepIntervalMs, kMaxSweepIntervalMs));
+    m_nextSweepMs = monotonicMs() + sweepIntervalMs;
+    
+    for (;;) {
+        int count = ::epoll_wait(m_epollFd, events, 64, sweepIntervalMs);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        m_nowMs = monotonicMs();
+        
+        bool stopping = false;
+        for (int i = 0; i < count; ++i) {
+            void* tag = events[i].data.ptr;
+            if (tag == nullptr) {
+                acceptConnections();
+            } else if (tag == this) {
+                stopping = true;
+            } else {
+                Connection* connection = static_cast<Connection*>(tag);
+                int fd = connection->fd;
+                if (events[i].events & EPOLLERR) {
+                    closeConnection(connection);
+                    continue;
+                }
+                if (events[i].events & EPOLLOUT) {
+                    flush(connection);
+                }
+                // Read even on EPOLLHUP, the peer may have sent a request before closing
+                if ((events[i].events & (EPOLLIN | EPOLLHUP)) && isOpen(fd, connection)) {
+                    readConnection(connection);
+                }
+            }
+        }
+        
+        if (stopping) {
+            break;
+        }
+        
+        if (m_nowMs >= m_nextSweepMs) {
+            sweepConnections();
+            m_nextSweepMs = m_nowMs + sweepIntervalMs;
+        }
+    }
+    
+    while (!m_connections.empty()) {
+        closeConnection(m_connections.begin()->second.get());
+    }
+}
+
+void WebhookHttpServer::acceptConnections() {
+    for (;;) {
+        int fd = ::accept4(m_listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        if (static_cast<int>(m_connections.size()) >= m_maxConnections) {
+            ::close(fd);
+            continue;
+        }
+        
+        int enable = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+        
+        std::unique_ptr<Connection> connection(new Connection);
+        connection->fd = fd;
+        connection->lastActivityMs = m_nowMs;
+        
+        epoll_event event;
+        event.events = EPOLLIN;
+        event.data.ptr = connection.get();
+        if (::epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            ::close(fd);
+            continue;
+        }
+        
+        m_connections[fd] = std::move(connection);
+        m_connectionsAccepted.fetch_add(1, std::memory_order_relaxed);
+        m_connectionsOpen.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void WebhookHttpServer::closeConnection(Connection* connection) {
+    int fd = connection->fd;
+    ::epoll_ctl(m_epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    m_connections.erase(fd);
+    m_connectionsOpen.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool WebhookHttpServer::isOpen(int fd, const Connection* connection) const {
+    auto it = m_connections.find(fd);
+    return it != m_connections.end() && it->second.get() == connection;
+}
+
+void WebhookHttpServer::readConnection(Connection* connection) {
+    int fd = connection->fd;
+    bool peerClosed = false;
+    
+    for (;;) {
+        std::size_t used = connection->input.size();
+        connection->input.resize(used + kReadChunk);
+        ssize_t received = ::recv(fd, connection->input.data() + used, kReadChunk, 0);
+        connection->input.resize(used + (received > 0 ? received : 0));
+        
+        if (received > 0) {
+            m_bytesReceived.fetch_add(received, std::memory_order_relaxed);
+            if (connection->closeAfterWrite) {
+                // Already answered for good; only taking the answer counts as progress
+                connection->input.clear();
+            } else {
+                connection->lastActivityMs = m_nowMs;
+            }
+            if (static_cast<std::size_t>(received) < kReadChunk) {
+                break;
+            }
+            continue;
+        }
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received < 0) {
+            closeConnection(connection);
+            return;
+        }
+        // Orderly shutdown; answer what was already received first
+        peerClosed = true;
+        break;
+    }
+    
+    processInput(connection);
+    if (peerClosed) {
+        connection->closeAfterWrite = true;
+    }
+    flush(connection);
+}
+
+void WebhookHttpServer::processInput(Connection* connection) {
+    while (!connection->closeAfterWrite) {
+        const char* data = connection->input.data() + connection->consumed;
+        std::size_t available = connection->input.size() - connection->consumed;
+        
+        if (!connection->headerParsed) {
+            // Resume the terminator search where the previous read stopped
+            std::size_t from = connection->scanned > 3 ? connection->scanned - 3 : 0;
+            const void* found = available > from ? ::memmem(data + from, available - from, "\r\n\r\n", 4) : nullptr;
+            if (!found) {
+                connection->scanned = available;
+                if (available > kMaxHeaderBytes) {
+                    respondError(connection, 431);
+                }
+                break;
+            }
+            
+            std::size_t headerLength = static_cast<const char*>(found) - data + 4;
+            if (headerLength > kMaxHeaderBytes) {
+                respondError(connection, 431);
+                break;
+            }
+            if (!parseHeaders(connection, data, headerLength)) {
+                respondError(connection, connection->errorStatus);
+                break;
+            }
+        }
+        
+        std::size_t total = connection->headerLength + connection->contentLength;
+        if (available < total) {
+            if (connection->expectContinue && !connection->continueSent) {
+                connection->continueSent = true;
+                connection->output.append(kContinue, sizeof(kContinue) - 1);
+            }
+            break;
+        }
+        
+        m_requests.fetch_add(1, std::memory_order_relaxed);
+        Disposition disposition = m_handler(data + connection->headerLength, connection->contentLength,
+                                            data + connection->signatureOffset, connection->signatureLength);
+        
+        bool keepAlive = connection->keepAlive;
+        if (disposition == Accepted) {
+            m_accepted.fetch_add(1, std::memory_order_relaxed);
+            if (keepAlive) {
+                respond(connection, kAccepted, sizeof(kAccepted) - 1);
+            } else {
+                respond(connection, kAcceptedClose, sizeof(kAcceptedClose) - 1);
+            }
+        } else {
+            m_rejectedBusy.fetch_add(1, std::memory_order_relaxed);
+            if (keepAlive) {
+                respond(connection, kBusy, sizeof(kBusy) - 1);
+            } else {
+                respond(connection, kBusyClose, sizeof(kBusyClose) - 1);
+            }
+        }
+        
+        connection->consumed += total;
+        connection->resetRequest();
+        connection->requestStartedMs = 0;
+        if (!keepAlive) {
+            connection->closeAfterWrite = true;
+        }
+    }
+    
+    // Drop consumed bytes; pipelined leftovers move to the front
+    if (connection->consumed == connection->input.size()) {
+        connection->input.clear();
+        connection->consumed = 0;
+        connection->requestStartedMs = 0;
+        return;
+    }
+    if (connection->requestStartedMs == 0) {
+        connection->requestStartedMs = m_nowMs;
+    }
+    if (connection->consumed > 0 && !connection->headerParsed) {
+        connection->input.erase(connection->input.begin(), connection->input.begin() + connection->consumed);
+        connection->consumed = 0;
+    }
+}
+
+bool WebhookHttpServer::parseHeaders(Connection* connection, const char* data, std::size_t headerLength) {
+    const char* end = data + headerLength - 2;
+    const char* lineEnd = static_cast<const char*>(std::memchr(data, '\r', end - data));
+    
+    // Request line: METHOD SP target SP version
+    const char* methodEnd = static_cast<const char*>(std::memchr(data, ' ', lineEnd - data));
+    const char* targetEnd = methodEnd ? static_cast<const char*>(std::memchr(methodEnd + 1, ' ', lineEnd - methodEnd - 1)) : nullptr;
+    if (!methodEnd || !targetEnd) {
+        connection->errorStatus = 400;
+        return false;
+    }
+    
+    const char* version = targetEnd + 1;
+    std::size_t versionLength = lineEnd - version;
+    if (versionLength == 8 && std::memcmp(version, "HTTP/1.1", 8) == 0) {
+        connection->keepAlive = true;
+    } else if (versionLength == 8 && std::memcmp(version, "HTTP/1.0", 8) == 0) {
+        connection->keepAlive = false;
+    } else {
+        connection->errorStatus = 505;
+        return false;
+    }
+    
+    bool hasLength = false;
+    const char* line = lineEnd + 2;
+    while (line < end) {
+        const char* next = static_cast<const char*>(std::memchr(line, '\r', end - line + 1));
+        const char* colon = static_cast<const char*>(std::memchr(line, ':', next - line));
+        if (!colon) {
+            connection->errorStatus = 400;
+            return false;
+        }
+        
+        const char* value = colon + 1;
+        const char* valueEnd = next;
+        while (value < valueEnd && (*value == ' ' || *value == '\t')) {
+            ++value;
+        }
+        while (valueEnd > value && (valueEnd[-1] == ' ' || valueEnd[-1] == '\t')) {
+            --valueEnd;
+        }
+        std::size_t nameLength = colon - line;
+        std::size_t valueLength = valueEnd - value;
+        
+        if (tokenEquals(line, nameLength, "content-length")) {
+            std::size_t length = 0;
+            if (valueLength == 0 || valueLength > 12) {
+                connection->errorStatus = 400;
+                return false;
+            }
+            for (std::size_t i = 0; i < valueLength; ++i) {
+                if (value[i] < '0' || value[i] > '9') {
+                    connection->errorStatus = 400;
+                    return false;
+                }
+                length = length * 10 + (value[i] - '0');
+            }
+            if (hasLength && length != connection->contentLength) {
+                connection->errorStatus = 400;
+                return false;
+            }
+            hasLength = true;
+            connection->contentLength = length;
+        } else if (tokenEquals(line, nameLength, "x-webhook-signature")) {
+            connection->signatureOffset = value - data;
+            connection->signatureLength = valueLength;
+        } else if (tokenEquals(line, nameLength, "connection")) {
+            if (listContains(value, valueLength, "close")) {
+                connection->keepAlive = false;
+            } else if (listContains(value, valueLength, "keep-alive")) {
+                connection->keepAlive = true;
+            }
+        } else if (tokenEquals(line, nameLength, "expect")) {
+            connection->expectContinue = listContains(value, valueLength, "100-continue");
+        } else if (tokenEquals(line, nameLength, "transfer-encoding")) {
+            connection->errorStatus = 501;
+            return false;
+        }
+        
+        line = next + 2;
+    }
+    
+    std::size_t methodLength = methodEnd - data;
+    if (methodLength != 4 || std::memcmp(data, "POST", 4) != 0) {
+        connection->errorStatus = 405;
+        return false;
+    }
+    
+    const char* target = methodEnd + 1;
+    const char* query = static_cast<const char*>(std::memchr(target, '?', targetEnd - target));
+    std::size_t pathLength = (query ? query : targetEnd) - target;
+    if (pathLength != m_path.size() || std::memcmp(target, m_path.data(), pathLength) != 0) {
+        connection->errorStatus = 404;
+        return false;
+    }
+    
+    if (!hasLength) {
+        connection->errorStatus = 411;
+        return false;
+    }
+    if (connection->contentLength > m_maxBodySize) {
+        connection->errorStatus = 413;
+        return false;
+    }
+    
+    connection->headerParsed = true;
+    connection->headerLength = headerLength;
+    return true;
+}
+
+void WebhookHttpServer::respond(Connection* connection, const char* response, std::size_t length) {
+    connection->output.append(response, length);
+}
+
+void WebhookHttpServer::respondError(Connection* connection, int status) {
+    // The rest of the stream cannot be trusted to be framed correctly
+    m_rejectedInvalid.fetch_add(1, std::memory_order_relaxed);
+    connection->output += "HTTP/1.1 " + std::to_string(status) + " " + reasonPhrase(status)
+            + "\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+    connection->closeAfterWrite = true;
+    connection->input.clear();
+    connection->consumed = 0;
+    connection->resetRequest();
+}
+
+void WebhookHttpServer::flush(Connection* connection) {
+    while (connection->written < connection->output.size()) {
+        ssize_t sent = ::send(connection->fd, connection->output.data() + connection->written,
+                              connection->output.size() - connection->written, MSG_NOSIGNAL);
+        if (sent > 0) {
+            connection->written += sent;
+            connection->lastActivityMs = m_nowMs;
+            continue;
+        }
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (!connection->writeWatched) {
+                epoll_event event;
+                event.events = EPOLLIN | EPOLLOUT;
+                event.data.ptr = connection;
+                ::epoll_ctl(m_epollFd, EPOLL_CTL_MOD, connection->fd, &event);
+                connection->writeWatched = true;
+            }
+            return;
+        }
+        closeConnection(connection);
+        return;
+    }
+    
+    connection->output.clear();
+    connection->written = 0;
+    if (connection->writeWatched) {
+        epoll_event event;
+        event.events = EPOLLIN;
+        event.data.ptr = connection;
+        ::epoll_ctl(m_epollFd, EPOLL_CTL_MOD, connection->fd, &event);
+        connection->writeWatched = false;
+    }
+    if (connection->closeAfterWrite) {
+        closeConnection(connection);
+    }
+}
+
+void WebhookHttpServer::sweepConnections() {
+    std::vector<Connection*> stalled;
+    std::vector<Connection*> timedOut;
+    for (const auto& entry : m_connections) {
+        Connection* connection = entry.second.get();
+        if (connection->written < connection->output.size() || connection->closeAfterWrite) {
+            // Nothing more is read; the peer has to take the response in time
+            if (m_nowMs - connection->lastActivityMs >= m_requestTimeoutMs) {
+                stalled.push_back(connection);
+            }
+        } else if (connection->requestStartedMs > 0) {
+            if (m_nowMs - connection->requestStartedMs >= m_requestTimeoutMs) {
+                timedOut.push_back(connection);
+            }
+        } else if (m_nowMs - connection->lastActivityMs >= m_idleTimeoutMs) {
+            stalled.push_back(connection);
+        }
+    }
+    
+    for (Connection* connection : stalled) {
+        m_timedOut.fetch_add(1, std::memory_order_relaxed);
+        closeConnection(connection);
+    }
+    // Answered 408 and closed once the answer is out, or at the next sweep if it cannot be
+    for (Connection* connection : timedOut) {
+        m_timedOut.fetch_add(1, std::memory_order_relaxed);
+        respondError(connection, 408);
+        connection->lastActivityMs = m_nowMs;
+        flush(connection);
+    }
+}
+
+#else
+
+bool WebhookHttpServer::start(const std::string&, std::uint16_t, std::string* error) {
+    if (error) {
+        *error = "Embedded webhook server requires Linux";
+    }
+    return false;
+}
+
+void WebhookHttpServer::stop() {
+}
+
+#endif // __linux__
+
+} // namespace AsianCryptoPay
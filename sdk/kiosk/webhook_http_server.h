@@ -0,0 +1,189 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * Minimal HTTP/1.1 listener for webhook deliveries. One epoll thread serves
+ * all keep-alive connections; request headers are parsed in place in the
+ * receive buffer and only the body and signature are handed on.
+ */
+
+#ifndef ASIAN_CRYPTO_PAYMENT_WEBHOOK_HTTP_SERVER_H
+#define ASIAN_CRYPTO_PAYMENT_WEBHOOK_HTTP_SERVER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace AsianCryptoPay {
+
+/**
+ * @brief Epoll-based HTTP/1.1 server accepting webhook POSTs
+ *
+ * Only POST requests to the configured path with a Content-Length body are
+ * accepted. The handler runs on the I/O thread and must not block; it
+ * either takes the request (202 Accepted) or reports that it is busy
+ * (503 with Retry-After), which is how backpressure reaches the sender.
+ * Malformed requests are answered and the connection is closed, as are
+ * requests not complete within the request timeout (408) and connections
+ * idle or unable to take a response for longer than the idle timeout.
+ *
+ * Available on Linux; start() fails elsewhere.
+ */
+class WebhookHttpServer {
+public:
+    /**
+     * @brief Handler verdict
+     */
+    enum Disposition {
+        Accepted,   ///< Request queued, answer 202
+        Busy        ///< Queue full, answer 503
+    };
+    
+    /**
+     * @brief Request handler, called on the I/O thread
+     *
+     * Pointers are valid only during the call.
+     */
+    typedef std::function<Disposition(const char* body, std::size_t bodyLength,
+                                      const char* signature, std::size_t signatureLength)> Handler;
+    
+    /**
+     * @brief Counter snapshot
+     */
+    struct Stats {
+        std::uint64_t connectionsAccepted = 0;
+        std::uint64_t connectionsOpen = 0;
+        std::uint64_t requests = 0;
+        std::uint64_t accepted = 0;
+        std::uint64_t rejectedBusy = 0;
+        std::uint64_t rejectedInvalid = 0;
+        std::uint64_t timedOut = 0;
+        std::uint64_t bytesReceived = 0;
+    };
+    
+    /**
+     * @brief Constructor
+     * @param handler Request handler
+     */
+    explicit WebhookHttpServer(Handler handler);
+    
+    /**
+     * @brief Destructor, stops the I/O thread
+     */
+    ~WebhookHttpServer();
+    
+    WebhookHttpServer(const WebhookHttpServer&) = delete;
+    WebhookHttpServer& operator=(const WebhookHttpServer&) = delete;
+    
+    /**
+     * @brief Set request path, e.g. "/webhook"; call before start()
+     * @param path Path without query
+     */
+    void setPath(const std::string& path) { m_path = path; }
+    
+    /**
+     * @brief Set largest accepted body; call before start()
+     * @param bytes Maximum Content-Length, larger requests get 413
+     */
+    void setMaxBodySize(std::size_t bytes) { m_maxBodySize = bytes; }
+    
+    /**
+     * @brief Set connection limit; call before start()
+     * @param connections Further connections are closed on accept
+     */
+    void setMaxConnections(int connections) { m_maxConnections = connections; }
+    
+    /**
+     * @brief Set how long a request may take from its first byte to its last; call before start()
+     * @param ms Timeout, default 10 s; a stalled response write is given as long
+     */
+    void setRequestTimeout(int ms) { m_requestTimeoutMs = ms > 0 ? ms : 1; }
+    
+    /**
+     * @brief Set how long a keep-alive connection may sit between requests; call before start()
+     * @param ms Timeout, default 60 s
+     */
+    void setIdleTimeout(int ms) { m_idleTimeoutMs = ms > 0 ? ms : 1; }
+    
+    /**
+     * @brief Bind, listen and start the I/O thread
+     * @param address IPv4 address to bind, e.g. "127.0.0.1" or "0.0.0.0"
+     * @param port Port, 0 for an ephemeral port
+     * @param error Receives a description on failure, may be null
+     * @return Whether the server is running
+     */
+    bool start(const std::string& address, std::uint16_t port, std::string* error = nullptr);
+    
+    /**
+     * @brief Stop the I/O thread and close all connections
+     */
+    void stop();
+    
+    /**
+     * @brief Check if the server is running
+     * @return Whether start() succeeded and stop() was not called
+     */
+    bool isRunning() const { return m_thread.joinable(); }
+    
+    /**
+     * @brief Get bound port
+     * @return Port, useful after binding port 0
+     */
+    std::uint16_t port() const { return m_port; }
+    
+    /**
+     * @brief Get counters; safe from any thread
+     * @return Counter snapshot
+     */
+    Stats stats() const;
+
+private:
+    struct Connection;
+    
+    void run();
+    void acceptConnections();
+    void closeConnection(Connection* connection);
+    bool isOpen(int fd, const Connection* connection) const;
+    void readConnection(Connection* connection);
+    void processInput(Connection* connection);
+    bool parseHeaders(Connection* connection, const char* data, std::size_t headerLength);
+    void respond(Connection* connection, const char* response, std::size_t length);
+    void respondError(Connection* connection, int status);
+    void flush(Connection* connection);
+    void sweepConnections();
+    
+    Handler m_handler;
+    std::string m_path;
+    std::size_t m_maxBodySize;
+    int m_maxConnections;
+    int m_requestTimeoutMs;
+    int m_idleTimeoutMs;
+    
+    int m_listenFd;
+    int m_epollFd;
+    int m_wakeFd;
+    std::uint16_t m_port;
+    std::thread m_thread;
+    std::unordered_map<int, std::unique_ptr<Connection>> m_connections;
+    std::int64_t m_nowMs;           ///< Monotonic time of the current loop turn
+    std::int64_t m_nextSweepMs;
+    
+    std::atomic<std::uint64_t> m_connectionsAccepted;
+    std::atomic<std::uint64_t> m_connectionsOpen;
+    std::atomic<std::uint64_t> m_requests;
+    std::atomic<std::uint64_t> m_accepted;
+    std::atomic<std::uint64_t> m_rejectedBusy;
+    std::atomic<std::uint64_t> m_rejectedInvalid;
+    std::atomic<std::uint64_t> m_timedOut;
+    std::atomic<std::uint64_t> m_bytesReceived;
+};
+
+} // namespace AsianCryptoPay
+
+#endif // ASIAN_CRYPTO_PAYMENT_WEBHOOK_HTTP_SERVER_H
@@ -0,0 +1,228 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * Embedded webhook receiver implementation.
+ */
+
+#include "webhook_receiver.h"
+#include "asian_crypto_payment.h"
+
+#include <QMetaObject>
+#include <chrono>
+
+namespace AsianCryptoPay {
+
+namespace {
+
+qint64 monotonicNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Bucket b holds latencies in [2^(b-1), 2^b) microseconds
+int latencyBucket(quint64 microseconds, int buckets) {
+    int bucket = 0;
+    while (microseconds > 0 && bucket < buckets - 1) {
+        microseconds >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+} // namespace
+
+WebhookReceiver::WebhookReceiver(AsianCryptoPayment* sdk, QObject* parent)
+    : QObject(parent)
+    , m_sdk(sdk)
+    , m_drainScheduled(false)
+    , m_queueCapacity(4096)
+    , m_batchSize(64)
+    , m_processed(0)
+    , m_failed(0)
+    , m_latencyTotalUs(0)
+    , m_latencyMaxUs(0)
+{
+    for (auto& bucket : m_latencyHistogram) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    
+    m_server.reset(new WebhookHttpServer([this](const char* body, std::size_t bodyLength,
+                                                const char* signature, std::size_t signatureLength) {
+        return enqueue(body, bodyLength, signature, signatureLength);
+    }));
+}
+
+WebhookReceiver::~WebhookReceiver() {
+    close();
+}
+
+void WebhookReceiver::setPath(const QString& path) {
+    m_server->setPath(path.toStdString());
+}
+
+void WebhookReceiver::setMaxBodySize(int bytes) {
+    m_server->setMaxBodySize(static_cast<std::size_t>(bytes));
+}
+
+void WebhookReceiver::setRequestTimeout(int ms) {
+    m_server->setRequestTimeout(ms);
+}
+
+void WebhookReceiver::setIdleTimeout(int ms) {
+    m_server->setIdleTimeout(ms);
+}
+
+void WebhookReceiver::setQueueCapacity(int deliveries) {
+    m_queueCapacity = deliveries;
+}
+
+void WebhookReceiver::setBatchSize(int deliveries) {
+    m_batchSize = qMax(1, deliveries);
+}
+
+bool WebhookReceiver::listen(const QString& address, quint16 port) {
+    if (!m_queue) {
+        m_queue.reset(new SpscQueue<PendingWebhook>(static_cast<std::size_t>(qMax(1, m_queueCapacity))));
+    }
+    
+    std::string error;
+    if (!m_server->start(address.toStdString(), port, &error)) {
+        m_errorString = QString::fromStdString(error);
+        qWarning() << "Webhook receiver failed to listen:" << m_errorString;
+        return false;
+    }
+    
+    m_errorString.clear();
+    return true;
+}
+
+void WebhookReceiver::close() {
+    m_server->stop();
+}
+
+bool WebhookReceiver::isListening() const {
+    return m_server->isRunning();
+}
+
+quint16 WebhookReceiver::port() const {
+    return m_server->port();
+}
+
+QString WebhookReceiver::errorString() const {
+    return m_errorString;
+}
+
+WebhookReceiver::Stats WebhookReceiver::stats() const {
+    WebhookHttpServer::Stats server = m_server->stats();
+    
+    Stats stats;
+    stats.connectionsAccepted = server.connectionsAccepted;
+    stats.connectionsOpen = server.connectionsOpen;
+    stats.requests = server.requests;
+    stats.accepted = server.accepted;
+    stats.rejectedBusy = server.rejectedBusy;
+    stats.rejectedInvalid = server.rejectedInvalid;
+    stats.timedOut = server.timedOut;
+    stats.bytesReceived = server.bytesReceived;
+    stats.processed = m_processed.load(std::memory_order_relaxed);
+    stats.failed = m_failed.load(std::memory_order_relaxed);
+    stats.queued = m_queue ? m_queue->sizeApprox() : 0;
+    stats.latencyMaxUs = m_latencyMaxUs.load(std::memory_order_relaxed);
+    
+    quint64 samples = stats.processed + stats.failed;
+    if (samples > 0) {
+        stats.latencyMeanUs = m_latencyTotalUs.load(std::memory_order_relaxed) / samples;
+    }
+    
+    // Percentiles are reported as the upper bound of their histogram bucket
+    quint64 counts[LatencyBuckets];
+    quint64 total = 0;
+    for (int b = 0; b < LatencyBuckets; ++b) {
+        counts[b] = m_latencyHistogram[b].load(std::memory_order_relaxed);
+        total += counts[b];
+    }
+    quint64 seen = 0;
+    for (int b = 0; b < LatencyBuckets && total > 0; ++b) {
+        seen += counts[b];
+        quint64 bound = quint64(1) << b;
+        if (stats.latencyP50Us == 0 && seen * 2 >= total) {
+            stats.latencyP50Us = bound;
+        }
+        if (stats.latencyP99Us == 0 && seen * 100 >= total * 99) {
+            stats.latencyP99Us = bound;
+        }
+    }
+    
+    return stats;
+}
+
+WebhookHttpServer::Disposition WebhookReceiver::enqueue(const char* body, std::size_t bodyLength,
+                                                        const char* signature, std::size_t signatureLength) {
+    // I/O thread: copy out of the connection buffer and hand over
+    PendingWebhook pending;
+    pending.body = QByteArray(body, static_cast<int>(bodyLength));
+    pending.signature = QByteArray(signature, static_cast<int>(signatureLength));
+    pending.receivedNs = monotonicNs();
+    
+    if (!m_queue->push(std::move(pending))) {
+        return WebhookHttpServer::Busy;
+    }
+    
+    scheduleDrain();
+    return WebhookHttpServer::Accepted;
+}
+
+void WebhookReceiver::scheduleDrain() {
+    // One queued invocation at a time, however many deliveries arrive
+    if (!m_drainScheduled.exchange(true, std::memory_order_acq_rel)) {
+        QMetaObject::invokeMethod(this, "drainQueue", Qt::QueuedConnection);
+    }
+}
+
+void WebhookReceiver::drainQueue() {
+    m_drainScheduled.store(false, std::memory_order_release);
+    
+    QVector<WebhookDelivery> batch;
+    QVector<qint64> received;
+    batch.reserve(m_batchSize);
+    received.reserve(m_batchSize);
+    
+    PendingWebhook pending;
+    while (batch.size() < m_batchSize && m_queue->pop(pending)) {
+        WebhookDelivery delivery;
+        delivery.body = std::move(pending.body);
+        delivery.signature = std::move(pending.signature);
+        batch.append(delivery);
+        received.append(pending.receivedNs);
+    }
+    
+    if (batch.isEmpty()) {
+        return;
+    }
+    
+    QBitArray processed = m_sdk->processWebhookPayloads(batch);
+    
+    qint64 now = monotonicNs();
+    for (int i = 0; i < batch.size(); ++i) {
+        (processed.testBit(i) ? m_processed : m_failed).fetch_add(1, std::memory_order_relaxed);
+        recordLatency(now - received.at(i));
+    }
+    
+    // Yield to the event loop between batches; pick up the rest next turn
+    if (m_queue->sizeApprox() > 0) {
+        scheduleDrain();
+    }
+}
+
+void WebhookReceiver::recordLatency(qint64 nanoseconds) {
+    quint64 microseconds = static_cast<quint64>(qMax<qint64>(0, nanoseconds)) / 1000;
+    
+    m_latencyTotalUs.fetch_add(microseconds, std::memory_order_relaxed);
+    m_latencyHistogram[latencyBucket(microseconds, LatencyBuckets)].fetch_add(1, std::memory_order_relaxed);
+    if (microseconds > m_latencyMaxUs.load(std::memory_order_relaxed)) {
+        m_latencyMaxUs.store(microseconds, std::memory_order_relaxed);
+    }
+}
+
+} // namespace AsianCryptoPay
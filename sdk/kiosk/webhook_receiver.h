@@ -0,0 +1,187 @@
+/**
+ * Asian Cryptocurrency Payment System - Kiosk SDK
+ * Version: 1.0.0
+ *
+ * Optional embedded webhook endpoint. Deliveries are accepted on an I/O
+ * thread and verified and dispatched by AsianCryptoPayment on its own
+ * thread, so integrators do not need their own HTTP server.
+ */
+
+#ifndef ASIAN_CRYPTO_PAYMENT_WEBHOOK_RECEIVER_H
+#define ASIAN_CRYPTO_PAYMENT_WEBHOOK_RECEIVER_H
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <atomic>
+#include <memory>
+
+#include "spsc_queue.h"
+#include "webhook_http_server.h"
+
+namespace AsianCryptoPay {
+
+class AsianCryptoPayment;
+
+/**
+ * @brief Embedded HTTP endpoint feeding AsianCryptoPayment::processWebhookPayloads()
+ *
+ * Requests are answered 202 as soon as they are queued and 503 with
+ * Retry-After when the queue is full, so a slow consumer pushes back on
+ * the sender instead of growing memory. The queue is drained in batches on
+ * the thread the receiver lives in, which must be the SDK's thread.
+ *
+ * Example:
+ * @code
+ * WebhookReceiver receiver(&sdk);
+ * receiver.listen("0.0.0.0", 8080);
+ * @endcode
+ */
+class WebhookReceiver : public QObject {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Throughput and latency counters
+     */
+    struct Stats {
+        quint64 connectionsAccepted = 0;
+        quint64 connectionsOpen = 0;
+        quint64 requests = 0;
+        quint64 accepted = 0;
+        quint64 rejectedBusy = 0;
+        quint64 rejectedInvalid = 0;
+        quint64 timedOut = 0;
+        quint64 bytesReceived = 0;
+        quint64 processed = 0;
+        quint64 failed = 0;
+        quint64 queued = 0;
+        quint64 latencyMeanUs = 0;
+        quint64 latencyP50Us = 0;
+        quint64 latencyP99Us = 0;
+        quint64 latencyMaxUs = 0;
+    };
+    
+    /**
+     * @brief Constructor
+     * @param sdk SDK instance that verifies and dispatches the events
+     * @param parent Parent object
+     */
+    explicit WebhookReceiver(AsianCryptoPayment* sdk, QObject* parent = nullptr);
+    
+    /**
+     * @brief Destructor, stops listening
+     */
+    ~WebhookReceiver();
+    
+    /**
+     * @brief Set request path; call before listen()
+     * @param path Path, default "/webhook"
+     */
+    void setPath(const QString& path);
+    
+    /**
+     * @brief Set largest accepted body; call before listen()
+     * @param bytes Maximum body size, default 1 MiB
+     */
+    void setMaxBodySize(int bytes);
+    
+    /**
+     * @brief Set how long a request may take to arrive; call before listen()
+     * @param ms Timeout, default 10 s
+     */
+    void setRequestTimeout(int ms);
+    
+    /**
+     * @brief Set how long an idle keep-alive connection is kept; call before listen()
+     * @param ms Timeout, default 60 s
+     */
+    void setIdleTimeout(int ms);
+    
+    /**
+     * @brief Set queue capacity; call before listen()
+     * @param deliveries Deliveries buffered before answering 503, default 4096
+     */
+    void setQueueCapacity(int deliveries);
+    
+    /**
+     * @brief Set how many deliveries are verified together
+     * @param deliveries Batch size per event loop turn, default 64
+     */
+    void setBatchSize(int deliveries);
+    
+    /**
+     * @brief Start listening
+     * @param address IPv4 address to bind
+     * @param port Port, 0 for an ephemeral port
+     * @return Whether the receiver is listening; see errorString() on failure
+     */
+    bool listen(const QString& address, quint16 port);
+    
+    /**
+     * @brief Stop listening and close all connections
+     *
+     * Deliveries already queued are still processed.
+     */
+    void close();
+    
+    /**
+     * @brief Check if listening
+     * @return Whether listen() succeeded and close() was not called
+     */
+    bool isListening() const;
+    
+    /**
+     * @brief Get bound port
+     * @return Port
+     */
+    quint16 port() const;
+    
+    /**
+     * @brief Get last listen error
+     * @return Error description
+     */
+    QString errorString() const;
+    
+    /**
+     * @brief Get counters
+     * @return Counter snapshot
+     */
+    Stats stats() const;
+
+private slots:
+    void drainQueue();
+
+private:
+    struct PendingWebhook {
+        QByteArray body;
+        QByteArray signature;
+        qint64 receivedNs = 0;
+    };
+    
+    static const int LatencyBuckets = 32;
+    
+    WebhookHttpServer::Disposition enqueue(const char* body, std::size_t bodyLength,
+                                           const char* signature, std::size_t signatureLength);
+    void scheduleDrain();
+    void recordLatency(qint64 nanoseconds);
+    
+    AsianCryptoPayment* m_sdk;
+    std::unique_ptr<WebhookHttpServer> m_server;
+    std::unique_ptr<SpscQueue<PendingWebhook>> m_queue;
+    std::atomic<bool> m_drainScheduled;
+    int m_queueCapacity;
+    int m_batchSize;
+    QString m_errorString;
+    
+    // Written on the owner thread, readable anywhere
+    std::atomic<quint64> m_processed;
+    std::atomic<quint64> m_failed;
+    std::atomic<quint64> m_latencyTotalUs;
+    std::atomic<quint64> m_latencyMaxUs;
+    std::atomic<quint64> m_latencyHistogram[LatencyBuckets];
+};
+
+} // namespace AsianCryptoPay
+
+#endif // ASIAN_CRYPTO_PAYMENT_WEBHOOK_RECEIVER_H